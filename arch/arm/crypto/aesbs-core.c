@@ -0,0 +1,453 @@
+/*
+ * Bit-sliced AES core for ARMv7 NEON
+ *
+ * Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Eight blocks are processed at once.  The 128 bytes are transposed into
+ * eight 128-bit planes: bit b of byte j of plane i is bit i of byte j of
+ * block b.  SubBytes then becomes a constant-time boolean circuit over the
+ * planes (Boyar and Peralta's 113 gate S-box), ShiftRows a byte shuffle of
+ * every plane and MixColumns a handful of rotates and XORs, so there are no
+ * table lookups and no data dependent timing.
+ *
+ * The circuit is used without its four XNORs; the missing 0x63 is folded
+ * into round keys 1..Nr by aesbs_convert_key().  Decryption runs the same
+ * circuit wrapped in the inverse affine map and uses the same bit-sliced
+ * encryption key schedule.
+ *
+ * This file is compiled with -mfpu=neon and must only be called between
+ * kernel_neon_begin() and kernel_neon_end().  It includes no kernel headers
+ * since <arm_neon.h> brings its own fixed width types.
+ */
+
+#include <arm_neon.h>
+
+#define AESBS_BLOCKS		8
+#define AESBS_ROUND_KEY_SIZE	(8 * 16)
+
+static const unsigned char shift_rows[16] = {
+	0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11,
+};
+
+static const unsigned char inv_shift_rows[16] = {
+	0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3,
+};
+
+#define swapmove(a, b, n, m) do {					\
+	uint8x16_t __t = vandq_u8(veorq_u8(vshrq_n_u8(b, n), a), m);	\
+	a = veorq_u8(a, __t);						\
+	b = veorq_u8(b, vshlq_n_u8(__t, n));				\
+} while (0)
+
+/* An 8x8 bit transpose within every byte position; its own inverse. */
+static inline __attribute__((always_inline)) void bitslice(uint8x16_t *x)
+{
+	uint8x16_t m;
+
+	m = vdupq_n_u8(0x55);
+	swapmove(x[1], x[0], 1, m);
+	swapmove(x[3], x[2], 1, m);
+	swapmove(x[5], x[4], 1, m);
+	swapmove(x[7], x[6], 1, m);
+
+	m = vdupq_n_u8(0x33);
+	swapmove(x[2], x[0], 2, m);
+	swapmove(x[3], x[1], 2, m);
+	swapmove(x[6], x[4], 2, m);
+	swapmove(x[7], x[5], 2, m);
+
+	m = vdupq_n_u8(0x0f);
+	swapmove(x[4], x[0], 4, m);
+	swapmove(x[5], x[1], 4, m);
+	swapmove(x[6], x[2], 4, m);
+	swapmove(x[7], x[3], 4, m);
+}
+
+static inline __attribute__((always_inline))
+void add_round_key(uint8x16_t *x, const unsigned char *rk)
+{
+	x[0] = veorq_u8(x[0], vld1q_u8(rk));
+	x[1] = veorq_u8(x[1], vld1q_u8(rk + 16));
+	x[2] = veorq_u8(x[2], vld1q_u8(rk + 32));
+	x[3] = veorq_u8(x[3], vld1q_u8(rk + 48));
+	x[4] = veorq_u8(x[4], vld1q_u8(rk + 64));
+	x[5] = veorq_u8(x[5], vld1q_u8(rk + 80));
+	x[6] = veorq_u8(x[6], vld1q_u8(rk + 96));
+	x[7] = veorq_u8(x[7], vld1q_u8(rk + 112));
+}
+
+/* S-box without the affine constant; U0/S0 are the most significant bit. */
+static inline __attribute__((always_inline)) void sub_bytes(uint8x16_t *x)
+{
+	uint8x16_t U0 = x[7], U1 = x[6], U2 = x[5], U3 = x[4];
+	uint8x16_t U4 = x[3], U5 = x[2], U6 = x[1], U7 = x[0];
+	uint8x16_t T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14,
+		   T15, T16, T17, T18, T19, T20, T21, T22, T23, T24, T25, T26,
+		   T27;
+	uint8x16_t M1, M2, M3, M4, M5, M6, M7, M8, M9, M10, M11, M12, M13, M14,
+		   M15, M16, M17, M18, M19, M20, M21, M22, M23, M24, M25, M26,
+		   M27, M28, M29, M30, M31, M32, M33, M34, M35, M36, M37, M38,
+		   M39, M40, M41, M42, M43, M44, M45, M46, M47, M48, M49, M50,
+		   M51, M52, M53, M54, M55, M56, M57, M58, M59, M60, M61, M62,
+		   M63;
+	uint8x16_t L0, L1, L2, L3, L4, L5, L6, L7, L8, L9, L10, L11, L12, L13,
+		   L14, L15, L16, L17, L18, L19, L20, L21, L22, L23, L24, L25,
+		   L26, L27, L28, L29;
+	uint8x16_t S0, S1, S2, S3, S4, S5, S6, S7;
+
+	T1 = veorq_u8(U0, U3);
+	T2 = veorq_u8(U0, U5);
+	T3 = veorq_u8(U0, U6);
+	T4 = veorq_u8(U3, U5);
+	T5 = veorq_u8(U4, U6);
+	T6 = veorq_u8(T1, T5);
+	T7 = veorq_u8(U1, U2);
+	T8 = veorq_u8(U7, T6);
+	T9 = veorq_u8(U7, T7);
+	T10 = veorq_u8(T6, T7);
+	T11 = veorq_u8(U1, U5);
+	T12 = veorq_u8(U2, U5);
+	T13 = veorq_u8(T3, T4);
+	T14 = veorq_u8(T6, T11);
+	T15 = veorq_u8(T5, T11);
+	T16 = veorq_u8(T5, T12);
+	T17 = veorq_u8(T9, T16);
+	T18 = veorq_u8(U3, U7);
+	T19 = veorq_u8(T7, T18);
+	T20 = veorq_u8(T1, T19);
+	T21 = veorq_u8(U6, U7);
+	T22 = veorq_u8(T7, T21);
+	T23 = veorq_u8(T2, T22);
+	T24 = veorq_u8(T2, T10);
+	T25 = veorq_u8(T20, T17);
+	T26 = veorq_u8(T3, T16);
+	T27 = veorq_u8(T1, T12);
+	M1 = vandq_u8(T13, T6);
+	M2 = vandq_u8(T23, T8);
+	M3 = veorq_u8(T14, M1);
+	M4 = vandq_u8(T19, U7);
+	M5 = veorq_u8(M4, M1);
+	M6 = vandq_u8(T3, T16);
+	M7 = vandq_u8(T22, T9);
+	M8 = veorq_u8(T26, M6);
+	M9 = vandq_u8(T20, T17);
+	M10 = veorq_u8(M9, M6);
+	M11 = vandq_u8(T1, T15);
+	M12 = vandq_u8(T4, T27);
+	M13 = veorq_u8(M12, M11);
+	M14 = vandq_u8(T2, T10);
+	M15 = veorq_u8(M14, M11);
+	M16 = veorq_u8(M3, M2);
+	M17 = veorq_u8(M5, T24);
+	M18 = veorq_u8(M8, M7);
+	M19 = veorq_u8(M10, M15);
+	M20 = veorq_u8(M16, M13);
+	M21 = veorq_u8(M17, M15);
+	M22 = veorq_u8(M18, M13);
+	M23 = veorq_u8(M19, T25);
+	M24 = veorq_u8(M22, M23);
+	M25 = vandq_u8(M22, M20);
+	M26 = veorq_u8(M21, M25);
+	M27 = veorq_u8(M20, M21);
+	M28 = veorq_u8(M23, M25);
+	M29 = vandq_u8(M28, M27);
+	M30 = vandq_u8(M26, M24);
+	M31 = vandq_u8(M20, M23);
+	M32 = vandq_u8(M27, M31);
+	M33 = veorq_u8(M27, M25);
+	M34 = vandq_u8(M21, M22);
+	M35 = vandq_u8(M24, M34);
+	M36 = veorq_u8(M24, M25);
+	M37 = veorq_u8(M21, M29);
+	M38 = veorq_u8(M32, M33);
+	M39 = veorq_u8(M23, M30);
+	M40 = veorq_u8(M35, M36);
+	M41 = veorq_u8(M38, M40);
+	M42 = veorq_u8(M37, M39);
+	M43 = veorq_u8(M37, M38);
+	M44 = veorq_u8(M39, M40);
+	M45 = veorq_u8(M42, M41);
+	M46 = vandq_u8(M44, T6);
+	M47 = vandq_u8(M40, T8);
+	M48 = vandq_u8(M39, U7);
+	M49 = vandq_u8(M43, T16);
+	M50 = vandq_u8(M38, T9);
+	M51 = vandq_u8(M37, T17);
+	M52 = vandq_u8(M42, T15);
+	M53 = vandq_u8(M45, T27);
+	M54 = vandq_u8(M41, T10);
+	M55 = vandq_u8(M44, T13);
+	M56 = vandq_u8(M40, T23);
+	M57 = vandq_u8(M39, T19);
+	M58 = vandq_u8(M43, T3);
+	M59 = vandq_u8(M38, T22);
+	M60 = vandq_u8(M37, T20);
+	M61 = vandq_u8(M42, T1);
+	M62 = vandq_u8(M45, T4);
+	M63 = vandq_u8(M41, T2);
+	L0 = veorq_u8(M61, M62);
+	L1 = veorq_u8(M50, M56);
+	L2 = veorq_u8(M46, M48);
+	L3 = veorq_u8(M47, M55);
+	L4 = veorq_u8(M54, M58);
+	L5 = veorq_u8(M49, M61);
+	L6 = veorq_u8(M62, L5);
+	L7 = veorq_u8(M46, L3);
+	L8 = veorq_u8(M51, M59);
+	L9 = veorq_u8(M52, M53);
+	L10 = veorq_u8(M53, L4);
+	L11 = veorq_u8(M60, L2);
+	L12 = veorq_u8(M48, M51);
+	L13 = veorq_u8(M50, L0);
+	L14 = veorq_u8(M52, M61);
+	L15 = veorq_u8(M55, L1);
+	L16 = veorq_u8(M56, L0);
+	L17 = veorq_u8(M57, L1);
+	L18 = veorq_u8(M58, L8);
+	L19 = veorq_u8(M63, L4);
+	L20 = veorq_u8(L0, L1);
+	L21 = veorq_u8(L1, L7);
+	L22 = veorq_u8(L3, L12);
+	L23 = veorq_u8(L18, L2);
+	L24 = veorq_u8(L15, L9);
+	L25 = veorq_u8(L6, L10);
+	L26 = veorq_u8(L7, L9);
+	L27 = veorq_u8(L8, L10);
+	L28 = veorq_u8(L11, L14);
+	L29 = veorq_u8(L11, L17);
+	S0 = veorq_u8(L6, L24);
+	S1 = veorq_u8(L16, L26);
+	S2 = veorq_u8(L19, L28);
+	S3 = veorq_u8(L6, L21);
+	S4 = veorq_u8(L20, L22);
+	S5 = veorq_u8(L25, L29);
+	S6 = veorq_u8(L13, L27);
+	S7 = veorq_u8(L6, L23);
+
+	x[7] = S0;
+	x[6] = S1;
+	x[5] = S2;
+	x[4] = S3;
+	x[3] = S4;
+	x[2] = S5;
+	x[1] = S6;
+	x[0] = S7;
+}
+
+/* Linear part of the inverse affine map: y[i] = x[i+2] ^ x[i+5] ^ x[i+7] */
+static inline __attribute__((always_inline)) void inv_affine(uint8x16_t *x)
+{
+	uint8x16_t y0, y1, y2, y3, y4, y5, y6, y7;
+
+	y0 = veorq_u8(veorq_u8(x[2], x[5]), x[7]);
+	y1 = veorq_u8(veorq_u8(x[3], x[6]), x[0]);
+	y2 = veorq_u8(veorq_u8(x[4], x[7]), x[1]);
+	y3 = veorq_u8(veorq_u8(x[5], x[0]), x[2]);
+	y4 = veorq_u8(veorq_u8(x[6], x[1]), x[3]);
+	y5 = veorq_u8(veorq_u8(x[7], x[2]), x[4]);
+	y6 = veorq_u8(veorq_u8(x[0], x[3]), x[5]);
+	y7 = veorq_u8(veorq_u8(x[1], x[4]), x[6]);
+
+	x[0] = y0;
+	x[1] = y1;
+	x[2] = y2;
+	x[3] = y3;
+	x[4] = y4;
+	x[5] = y5;
+	x[6] = y6;
+	x[7] = y7;
+}
+
+static inline __attribute__((always_inline))
+void inv_sub_bytes(uint8x16_t *x)
+{
+	inv_affine(x);
+	sub_bytes(x);
+	inv_affine(x);
+}
+
+static inline __attribute__((always_inline))
+uint8x16_t shuffle(uint8x16_t x, uint8x8_t lo, uint8x8_t hi)
+{
+	uint8x8x2_t t;
+
+	t.val[0] = vget_low_u8(x);
+	t.val[1] = vget_high_u8(x);
+	return vcombine_u8(vtbl2_u8(t, lo), vtbl2_u8(t, hi));
+}
+
+static inline __attribute__((always_inline))
+void shift_planes(uint8x16_t *x, const unsigned char *tbl)
+{
+	uint8x8_t lo = vld1_u8(tbl), hi = vld1_u8(tbl + 8);
+
+	x[0] = shuffle(x[0], lo, hi);
+	x[1] = shuffle(x[1], lo, hi);
+	x[2] = shuffle(x[2], lo, hi);
+	x[3] = shuffle(x[3], lo, hi);
+	x[4] = shuffle(x[4], lo, hi);
+	x[5] = shuffle(x[5], lo, hi);
+	x[6] = shuffle(x[6], lo, hi);
+	x[7] = shuffle(x[7], lo, hi);
+}
+
+/* Byte r of each column takes byte r + 1 (rot1) or r + 2 (rot2). */
+static inline __attribute__((always_inline)) uint8x16_t rot1(uint8x16_t x)
+{
+	uint32x4_t w = vreinterpretq_u32_u8(x);
+
+	return vreinterpretq_u8_u32(vsriq_n_u32(vshlq_n_u32(w, 24), w, 8));
+}
+
+static inline __attribute__((always_inline)) uint8x16_t rot2(uint8x16_t x)
+{
+	return vreinterpretq_u8_u16(vrev32q_u16(vreinterpretq_u16_u8(x)));
+}
+
+/*
+ * out[r] = 2 * (a[r] ^ a[r+1]) ^ a[r+1] ^ a[r+2] ^ a[r+3], with the
+ * multiplication by 2 done across planes.
+ */
+static inline __attribute__((always_inline)) void mix_columns(uint8x16_t *x)
+{
+	uint8x16_t r0, r1, r2, r3, r4, r5, r6, r7;
+	uint8x16_t t0, t1, t2, t3, t4, t5, t6, t7;
+
+	r0 = rot1(x[0]); t0 = veorq_u8(x[0], r0);
+	r1 = rot1(x[1]); t1 = veorq_u8(x[1], r1);
+	r2 = rot1(x[2]); t2 = veorq_u8(x[2], r2);
+	r3 = rot1(x[3]); t3 = veorq_u8(x[3], r3);
+	r4 = rot1(x[4]); t4 = veorq_u8(x[4], r4);
+	r5 = rot1(x[5]); t5 = veorq_u8(x[5], r5);
+	r6 = rot1(x[6]); t6 = veorq_u8(x[6], r6);
+	r7 = rot1(x[7]); t7 = veorq_u8(x[7], r7);
+
+	x[0] = veorq_u8(veorq_u8(t7, r0), rot2(t0));
+	x[1] = veorq_u8(veorq_u8(veorq_u8(t0, t7), r1), rot2(t1));
+	x[2] = veorq_u8(veorq_u8(t1, r2), rot2(t2));
+	x[3] = veorq_u8(veorq_u8(veorq_u8(t2, t7), r3), rot2(t3));
+	x[4] = veorq_u8(veorq_u8(veorq_u8(t3, t7), r4), rot2(t4));
+	x[5] = veorq_u8(veorq_u8(t4, r5), rot2(t5));
+	x[6] = veorq_u8(veorq_u8(t5, r6), rot2(t6));
+	x[7] = veorq_u8(veorq_u8(t6, r7), rot2(t7));
+}
+
+/*
+ * InvMixColumns is MixColumns after a[r] ^= 4 * (a[r] ^ a[r+2]).
+ */
+static inline __attribute__((always_inline))
+void inv_mix_columns(uint8x16_t *x)
+{
+	uint8x16_t w0, w1, w2, w3, w4, w5, w6, w7;
+
+	w0 = veorq_u8(x[0], rot2(x[0]));
+	w1 = veorq_u8(x[1], rot2(x[1]));
+	w2 = veorq_u8(x[2], rot2(x[2]));
+	w3 = veorq_u8(x[3], rot2(x[3]));
+	w4 = veorq_u8(x[4], rot2(x[4]));
+	w5 = veorq_u8(x[5], rot2(x[5]));
+	w6 = veorq_u8(x[6], rot2(x[6]));
+	w7 = veorq_u8(x[7], rot2(x[7]));
+
+	x[0] = veorq_u8(x[0], w6);
+	x[1] = veorq_u8(x[1], veorq_u8(w7, w6));
+	x[2] = veorq_u8(x[2], veorq_u8(w0, w7));
+	x[3] = veorq_u8(x[3], veorq_u8(w1, w6));
+	x[4] = veorq_u8(x[4], veorq_u8(veorq_u8(w2, w7), w6));
+	x[5] = veorq_u8(x[5], veorq_u8(w3, w7));
+	x[6] = veorq_u8(x[6], w4);
+	x[7] = veorq_u8(x[7], w5);
+
+	mix_columns(x);
+}
+
+static inline __attribute__((always_inline))
+void load_blocks(uint8x16_t *x, const unsigned char *in)
+{
+	x[0] = vld1q_u8(in);
+	x[1] = vld1q_u8(in + 16);
+	x[2] = vld1q_u8(in + 32);
+	x[3] = vld1q_u8(in + 48);
+	x[4] = vld1q_u8(in + 64);
+	x[5] = vld1q_u8(in + 80);
+	x[6] = vld1q_u8(in + 96);
+	x[7] = vld1q_u8(in + 112);
+	bitslice(x);
+}
+
+static inline __attribute__((always_inline))
+void store_blocks(uint8x16_t *x, unsigned char *out)
+{
+	bitslice(x);
+	vst1q_u8(out, x[0]);
+	vst1q_u8(out + 16, x[1]);
+	vst1q_u8(out + 32, x[2]);
+	vst1q_u8(out + 48, x[3]);
+	vst1q_u8(out + 64, x[4]);
+	vst1q_u8(out + 80, x[5]);
+	vst1q_u8(out + 96, x[6]);
+	vst1q_u8(out + 112, x[7]);
+}
+
+/*
+ * Encrypt eight consecutive blocks.  @rk is the bit-sliced schedule from
+ * aesbs_convert_key(), (rounds + 1) * 128 bytes.  @out may equal @in.
+ */
+void aesbs_encrypt8(const unsigned char *rk, int rounds,
+		    unsigned char *out, const unsigned char *in)
+{
+	uint8x16_t x[8];
+	int r;
+
+	load_blocks(x, in);
+	add_round_key(x, rk);
+
+	for (r = 1; r < rounds; r++) {
+		rk += AESBS_ROUND_KEY_SIZE;
+		sub_bytes(x);
+		shift_planes(x, shift_rows);
+		mix_columns(x);
+		add_round_key(x, rk);
+	}
+
+	sub_bytes(x);
+	shift_planes(x, shift_rows);
+	add_round_key(x, rk + AESBS_ROUND_KEY_SIZE);
+	store_blocks(x, out);
+}
+
+/* The straightforward inverse cipher, run on the encryption schedule. */
+void aesbs_decrypt8(const unsigned char *rk, int rounds,
+		    unsigned char *out, const unsigned char *in)
+{
+	uint8x16_t x[8];
+	int r;
+
+	rk += rounds * AESBS_ROUND_KEY_SIZE;
+	load_blocks(x, in);
+	add_round_key(x, rk);
+
+	for (r = rounds - 1; r > 0; r--) {
+		rk -= AESBS_ROUND_KEY_SIZE;
+		shift_planes(x, inv_shift_rows);
+		inv_sub_bytes(x);
+		add_round_key(x, rk);
+		inv_mix_columns(x);
+	}
+
+	shift_planes(x, inv_shift_rows);
+	inv_sub_bytes(x);
+	add_round_key(x, rk - AESBS_ROUND_KEY_SIZE);
+	store_blocks(x, out);
+}
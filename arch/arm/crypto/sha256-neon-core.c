@@ -0,0 +1,156 @@
+/*
+ * SHA-256 block transform with a NEON message schedule
+ *
+ * Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * The compression rounds are a serial dependency chain on 32-bit values
+ * and stay in the integer pipeline.  The message schedule is computed four
+ * words at a time in NEON, with the round constants already added, so the
+ * rounds only do one load per step.  The two NEON and integer halves
+ * overlap on the dual-issue Cortex-A cores.
+ *
+ * Must only be called between kernel_neon_begin() and kernel_neon_end().
+ */
+
+#include <arm_neon.h>
+
+static const uint32_t sha256_k[64] __attribute__((aligned(16))) = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ror32(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+
+#define vror_u32(x, n)	vsri_n_u32(vshl_n_u32(x, 32 - (n)), x, n)
+#define vrorq_u32(x, n)	vsriq_n_u32(vshlq_n_u32(x, 32 - (n)), x, n)
+
+/* s0(x) = ror(x, 7) ^ ror(x, 18) ^ (x >> 3) */
+static inline __attribute__((always_inline)) uint32x4_t s0q(uint32x4_t x)
+{
+	return veorq_u32(veorq_u32(vrorq_u32(x, 7), vrorq_u32(x, 18)),
+			 vshrq_n_u32(x, 3));
+}
+
+/* s1(x) = ror(x, 17) ^ ror(x, 19) ^ (x >> 10) */
+static inline __attribute__((always_inline)) uint32x2_t s1d(uint32x2_t x)
+{
+	return veor_u32(veor_u32(vror_u32(x, 17), vror_u32(x, 19)),
+			vshr_n_u32(x, 10));
+}
+
+/*
+ * wk[t] = W[t] + K[t] for the whole block.  W[t..t+3] needs W[t-2] and
+ * W[t-1], so the two upper lanes wait for the two lower ones.
+ */
+static inline __attribute__((always_inline))
+void sha256_schedule(uint32_t *w, uint32_t *wk, const unsigned char *data)
+{
+	uint32x4_t x, k;
+	uint32x2_t lo, hi;
+	int t;
+
+	for (t = 0; t < 16; t += 4) {
+		x = vreinterpretq_u32_u8(vld1q_u8(data + 4 * t));
+#ifndef __ARMEB__
+		x = vreinterpretq_u32_u8(vrev32q_u8(vreinterpretq_u8_u32(x)));
+#endif
+		k = vld1q_u32(sha256_k + t);
+		vst1q_u32(w + t, x);
+		vst1q_u32(wk + t, vaddq_u32(x, k));
+	}
+
+	for (t = 16; t < 64; t += 4) {
+		x = vaddq_u32(vld1q_u32(w + t - 16), s0q(vld1q_u32(w + t - 15)));
+		x = vaddq_u32(x, vld1q_u32(w + t - 7));
+		lo = vadd_u32(vget_low_u32(x), s1d(vld1_u32(w + t - 2)));
+		hi = vadd_u32(vget_high_u32(x), s1d(lo));
+		x = vcombine_u32(lo, hi);
+		k = vld1q_u32(sha256_k + t);
+		vst1q_u32(w + t, x);
+		vst1q_u32(wk + t, vaddq_u32(x, k));
+	}
+}
+
+#define S0(x)		(ror32(x, 2) ^ ror32(x, 13) ^ ror32(x, 22))
+#define S1(x)		(ror32(x, 6) ^ ror32(x, 11) ^ ror32(x, 25))
+#define Ch(x, y, z)	((z) ^ ((x) & ((y) ^ (z))))
+#define Maj(x, y, z)	(((x) & (y)) | ((z) & ((x) | (y))))
+
+#define ROUND(a, b, c, d, e, f, g, h, i) do {				\
+	uint32_t t1 = h + S1(e) + Ch(e, f, g) + wk[i];			\
+	uint32_t t2 = S0(a) + Maj(a, b, c);				\
+	d += t1;							\
+	h = t1 + t2;							\
+} while (0)
+
+/*
+ * void sha256_block_neon(u32 *state, const u8 *data, unsigned int blocks)
+ */
+void sha256_block_neon(uint32_t *state, const unsigned char *data,
+		       unsigned int blocks)
+{
+	uint32_t w[64] __attribute__((aligned(16)));
+	uint32_t wk[64] __attribute__((aligned(16)));
+	uint32_t a, b, c, d, e, f, g, h;
+	int i;
+
+	while (blocks--) {
+		sha256_schedule(w, wk, data);
+
+		a = state[0];
+		b = state[1];
+		c = state[2];
+		d = state[3];
+		e = state[4];
+		f = state[5];
+		g = state[6];
+		h = state[7];
+
+		for (i = 0; i < 64; i += 8) {
+			ROUND(a, b, c, d, e, f, g, h, i);
+			ROUND(h, a, b, c, d, e, f, g, i + 1);
+			ROUND(g, h, a, b, c, d, e, f, i + 2);
+			ROUND(f, g, h, a, b, c, d, e, i + 3);
+			ROUND(e, f, g, h, a, b, c, d, i + 4);
+			ROUND(d, e, f, g, h, a, b, c, i + 5);
+			ROUND(c, d, e, f, g, h, a, b, i + 6);
+			ROUND(b, c, d, e, f, g, h, a, i + 7);
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+
+		data += 64;
+	}
+}
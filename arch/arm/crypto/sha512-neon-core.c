@@ -0,0 +1,174 @@
+/*
+ * SHA-512 block transform for NEON
+ *
+ * Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * On 32-bit ARM every 64-bit add, rotate and logical op of the generic
+ * code is a pair of integer instructions plus carry handling, and the
+ * eight working variables do not fit in the register file.  NEON has
+ * 64-bit lanes: the working variables live in D registers, rotates are a
+ * shift plus shift-insert, Ch and Maj are single VBSL instructions, and
+ * the message schedule runs two words at a time in Q registers.
+ *
+ * Must only be called between kernel_neon_begin() and kernel_neon_end().
+ */
+
+#include <arm_neon.h>
+
+static const uint64_t sha512_k[80] __attribute__((aligned(16))) = {
+	0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL,
+	0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+	0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+	0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+	0xd807aa98a3030242ULL, 0x12835b0145706fbeULL,
+	0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+	0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL,
+	0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+	0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+	0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+	0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL,
+	0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+	0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL,
+	0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+	0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+	0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+	0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL,
+	0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+	0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL,
+	0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+	0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+	0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+	0xd192e819d6ef5218ULL, 0xd69906245565a910ULL,
+	0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+	0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL,
+	0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+	0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+	0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+	0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL,
+	0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+	0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL,
+	0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+	0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+	0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+	0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL,
+	0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+	0x28db77f523047d84ULL, 0x32caab7b40c72493ULL,
+	0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+	0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+	0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+#define vror_u64(x, n)	vsri_n_u64(vshl_n_u64(x, 64 - (n)), x, n)
+#define vrorq_u64(x, n)	vsriq_n_u64(vshlq_n_u64(x, 64 - (n)), x, n)
+
+/* s0(x) = ror(x, 1) ^ ror(x, 8) ^ (x >> 7) */
+static inline __attribute__((always_inline)) uint64x2_t s0q(uint64x2_t x)
+{
+	return veorq_u64(veorq_u64(vrorq_u64(x, 1), vrorq_u64(x, 8)),
+			 vshrq_n_u64(x, 7));
+}
+
+/* s1(x) = ror(x, 19) ^ ror(x, 61) ^ (x >> 6) */
+static inline __attribute__((always_inline)) uint64x2_t s1q(uint64x2_t x)
+{
+	return veorq_u64(veorq_u64(vrorq_u64(x, 19), vrorq_u64(x, 61)),
+			 vshrq_n_u64(x, 6));
+}
+
+/* wk[t] = W[t] + K[t]; W[t] and W[t+1] are independent of each other. */
+static inline __attribute__((always_inline))
+void sha512_schedule(uint64_t *w, uint64_t *wk, const unsigned char *data)
+{
+	uint64x2_t x;
+	int t;
+
+	for (t = 0; t < 16; t += 2) {
+		x = vreinterpretq_u64_u8(vld1q_u8(data + 8 * t));
+#ifndef __ARMEB__
+		x = vreinterpretq_u64_u8(vrev64q_u8(vreinterpretq_u8_u64(x)));
+#endif
+		vst1q_u64(w + t, x);
+		vst1q_u64(wk + t, vaddq_u64(x, vld1q_u64(sha512_k + t)));
+	}
+
+	for (t = 16; t < 80; t += 2) {
+		x = vaddq_u64(vld1q_u64(w + t - 16), s0q(vld1q_u64(w + t - 15)));
+		x = vaddq_u64(x, vld1q_u64(w + t - 7));
+		x = vaddq_u64(x, s1q(vld1q_u64(w + t - 2)));
+		vst1q_u64(w + t, x);
+		vst1q_u64(wk + t, vaddq_u64(x, vld1q_u64(sha512_k + t)));
+	}
+}
+
+#define S0(x)	veor_u64(veor_u64(vror_u64(x, 28), vror_u64(x, 34)),	\
+			 vror_u64(x, 39))
+#define S1(x)	veor_u64(veor_u64(vror_u64(x, 14), vror_u64(x, 18)),	\
+			 vror_u64(x, 41))
+
+/* Ch(e, f, g) = e ? f : g;  Maj(a, b, c) = (a ^ b) ? c : b */
+#define ROUND(a, b, c, d, e, f, g, h, i) do {				\
+	uint64x1_t t1, t2;						\
+	t1 = vadd_u64(vadd_u64(h, S1(e)), vbsl_u64(e, f, g));		\
+	t1 = vadd_u64(t1, vld1_u64(wk + (i)));				\
+	t2 = vadd_u64(S0(a), vbsl_u64(veor_u64(a, b), c, b));		\
+	d = vadd_u64(d, t1);						\
+	h = vadd_u64(t1, t2);						\
+} while (0)
+
+/*
+ * void sha512_block_neon(u64 *state, const u8 *data, unsigned int blocks)
+ */
+void sha512_block_neon(uint64_t *state, const unsigned char *data,
+		       unsigned int blocks)
+{
+	uint64_t w[80] __attribute__((aligned(16)));
+	uint64_t wk[80] __attribute__((aligned(16)));
+	uint64x1_t a, b, c, d, e, f, g, h;
+	int i;
+
+	while (blocks--) {
+		sha512_schedule(w, wk, data);
+
+		a = vld1_u64(state);
+		b = vld1_u64(state + 1);
+		c = vld1_u64(state + 2);
+		d = vld1_u64(state + 3);
+		e = vld1_u64(state + 4);
+		f = vld1_u64(state + 5);
+		g = vld1_u64(state + 6);
+		h = vld1_u64(state + 7);
+
+		for (i = 0; i < 80; i += 8) {
+			ROUND(a, b, c, d, e, f, g, h, i);
+			ROUND(h, a, b, c, d, e, f, g, i + 1);
+			ROUND(g, h, a, b, c, d, e, f, i + 2);
+			ROUND(f, g, h, a, b, c, d, e, i + 3);
+			ROUND(e, f, g, h, a, b, c, d, i + 4);
+			ROUND(d, e, f, g, h, a, b, c, i + 5);
+			ROUND(c, d, e, f, g, h, a, b, i + 6);
+			ROUND(b, c, d, e, f, g, h, a, i + 7);
+		}
+
+		vst1_u64(state, vadd_u64(vld1_u64(state), a));
+		vst1_u64(state + 1, vadd_u64(vld1_u64(state + 1), b));
+		vst1_u64(state + 2, vadd_u64(vld1_u64(state + 2), c));
+		vst1_u64(state + 3, vadd_u64(vld1_u64(state + 3), d));
+		vst1_u64(state + 4, vadd_u64(vld1_u64(state + 4), e));
+		vst1_u64(state + 5, vadd_u64(vld1_u64(state + 5), f));
+		vst1_u64(state + 6, vadd_u64(vld1_u64(state + 6), g));
+		vst1_u64(state + 7, vadd_u64(vld1_u64(state + 7), h));
+
+		data += 128;
+	}
+}
@@ -0,0 +1,39 @@
+/*
+ * linux/arch/arm/include/asm/neon.h
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef __ASM_ARM_NEON_H
+#define __ASM_ARM_NEON_H
+
+#include <asm/hwcap.h>
+
+#define cpu_has_neon()		(!!(elf_hwcap & HWCAP_NEON))
+
+/*
+ * kernel_neon_begin() saves whatever user VFP/NEON state is live in the
+ * hardware, enables the unit and disables preemption; kernel_neon_end()
+ * disables the unit again and re-enables preemption.  The user state is
+ * reloaded lazily on its next VFP instruction.  Pairs may nest.
+ *
+ * Neither may be called from interrupt context, so callers reachable from
+ * there must check in_interrupt() and take a non-NEON path.  Code built
+ * with -mfpu=neon must live in its own compilation unit so the compiler
+ * cannot move NEON instructions outside the begin/end pair.
+ */
+void kernel_neon_begin(void);
+void kernel_neon_end(void);
+
+#ifdef CONFIG_ARM_NEON_COPY
+/*
+ * memcpy(), copy_page() and, through memcpy(), the uaccess copies use
+ * NEON for sizes of at least this many bytes.  ULONG_MAX until the boot
+ * benchmark in arch/arm/lib/copy_neon.c has run.
+ */
+extern unsigned long neon_copy_threshold;
+#endif
+
+#endif /* __ASM_ARM_NEON_H */
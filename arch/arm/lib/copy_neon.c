@@ -0,0 +1,178 @@
+/*
+ *  linux/arch/arm/lib/copy_neon.c
+ *
+ *  NEON paths for large memcpy() and copy_page(), and the boot time
+ *  benchmark that decides from which size they are used.
+ *
+ * Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/hardirq.h>
+#include <linux/irqflags.h>
+#include <linux/gfp.h>
+#include <linux/ktime.h>
+#include <asm/cputype.h>
+#include <asm/neon.h>
+#include <asm/page.h>
+
+/*
+ * The benchmark runs from the initcall thread, which has no live user
+ * VFP state, so it never sees the cost kernel_neon_begin() has in a
+ * VFP-using task: saving that state and the undefined instruction trap
+ * that lazily reloads it on return to user space.  That cost is paid
+ * per copy and swamps any gain on small copies, so NEON is never chosen
+ * below a page even when the measurement would favour it.
+ */
+#define NEON_COPY_BENCH_MIN	PAGE_SIZE
+#define NEON_COPY_BENCH_MAX	(16 * 1024)
+#define NEON_COPY_BENCH_BYTES	(256 * 1024)
+#define NEON_COPY_BENCH_ROUNDS	5
+
+/*
+ * Checked by memcpy() and copy_page() before anything else; NEON is
+ * not touched before the benchmark has run, which is after vfp_init().
+ */
+unsigned long neon_copy_threshold = ULONG_MAX;
+module_param_named(threshold, neon_copy_threshold, ulong, 0644);
+MODULE_PARM_DESC(threshold, "Smallest copy done with NEON");
+
+asmlinkage void __memcpy_neon(void *dest, const void *src, size_t n);
+asmlinkage void *__memcpy_arm(void *dest, const void *src, size_t n);
+asmlinkage void __copy_page_arm(void *to, const void *from);
+
+/*
+ * The threshold can be set from the command line or sysfs, so it does
+ * not prove that there is NEON, or that vfp_init() has run: HWCAP_NEON
+ * is only set there.  kernel_neon_begin() may not be used in interrupt
+ * context.  With interrupts disabled the caller is on a path where the
+ * extra latency of saving the user VFP state is not welcome either.
+ */
+static inline bool neon_copy_usable(void)
+{
+	return cpu_has_neon() && !in_interrupt() && !irqs_disabled();
+}
+
+static void *__memcpy_neon_bulk(void *dest, const void *src, size_t n)
+{
+	size_t bulk = n & ~(size_t)63;
+
+	kernel_neon_begin();
+	__memcpy_neon(dest, src, bulk);
+	kernel_neon_end();
+
+	if (n != bulk)
+		__memcpy_arm(dest + bulk, src + bulk, n - bulk);
+
+	return dest;
+}
+
+/* Called from memcpy() for n >= neon_copy_threshold. */
+void *memcpy_neon(void *dest, const void *src, size_t n)
+{
+	if (n < 64 || !neon_copy_usable())
+		return __memcpy_arm(dest, src, n);
+
+	return __memcpy_neon_bulk(dest, src, n);
+}
+
+/* Called from copy_page() when neon_copy_threshold <= PAGE_SIZE. */
+void copy_page_neon(void *to, const void *from)
+{
+	if (!neon_copy_usable()) {
+		__copy_page_arm(to, from);
+		return;
+	}
+
+	kernel_neon_begin();
+	__memcpy_neon(to, from, PAGE_SIZE);
+	kernel_neon_end();
+}
+
+static s64 __init neon_copy_time(void *(*copy)(void *, const void *, size_t),
+				 void *dest, const void *src, size_t size)
+{
+	s64 best = LLONG_MAX, ns;
+	unsigned int round, i;
+	ktime_t start;
+
+	for (round = 0; round < NEON_COPY_BENCH_ROUNDS; round++) {
+		start = ktime_get();
+		for (i = 0; i < NEON_COPY_BENCH_BYTES / size; i++)
+			copy(dest, src, size);
+		ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+		best = min(best, ns);
+	}
+
+	return best;
+}
+
+/*
+ * Time the ldm/stm copy against the NEON one from NEON_COPY_BENCH_MAX
+ * down to NEON_COPY_BENCH_MIN, with cache-warm buffers, and use NEON
+ * from the smallest size at which it still wins.  All CPUs of the SoCs this runs on are of the
+ * same type, so the boot CPU speaks for them.
+ */
+static int __init neon_copy_bench(void)
+{
+	unsigned int order = get_order(NEON_COPY_BENCH_MAX);
+	unsigned long threshold = ULONG_MAX;
+	s64 arm_ns, neon_ns;
+	void *src, *dest;
+	size_t size;
+
+	if (!cpu_has_neon()) {
+		pr_info("neon_copy: no NEON, using ldm/stm copies\n");
+		return 0;
+	}
+
+	/* a threshold given on the command line wins over the benchmark */
+	if (neon_copy_threshold != ULONG_MAX) {
+		pr_info("neon_copy: NEON for copies of %lu bytes and up (parameter)\n",
+			neon_copy_threshold);
+		return 0;
+	}
+
+	src = (void *)__get_free_pages(GFP_KERNEL, order);
+	dest = (void *)__get_free_pages(GFP_KERNEL, order);
+	if (!src || !dest)
+		goto out;
+
+	memset(src, 0x5a, NEON_COPY_BENCH_MAX);
+
+	for (size = NEON_COPY_BENCH_MAX; size >= NEON_COPY_BENCH_MIN;
+	     size /= 2) {
+		arm_ns = neon_copy_time(__memcpy_arm, dest, src, size);
+		neon_ns = neon_copy_time(__memcpy_neon_bulk, dest, src, size);
+		pr_debug("neon_copy: %zu bytes: ldm/stm %lld ns, neon %lld ns\n",
+			 size, arm_ns, neon_ns);
+		if (neon_ns >= arm_ns)
+			break;
+		threshold = size;
+	}
+
+	neon_copy_threshold = threshold;
+	if (threshold == ULONG_MAX)
+		pr_info("neon_copy: CPU part 0x%03x: ldm/stm copies are faster\n",
+			(read_cpuid_id() >> 4) & 0xfff);
+	else
+		pr_info("neon_copy: CPU part 0x%03x: NEON for copies of %lu bytes and up\n",
+			(read_cpuid_id() >> 4) & 0xfff, threshold);
+
+out:
+	free_pages((unsigned long)dest, order);
+	free_pages((unsigned long)src, order);
+	return 0;
+}
+late_initcall_sync(neon_copy_bench);
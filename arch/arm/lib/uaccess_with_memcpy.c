@@ -20,9 +20,16 @@
 #include <linux/highmem.h>
 #include <asm/current.h>
 #include <asm/page.h>
+#include <asm/neon.h>
 
+/*
+ * Lock the pte of a user page that can be accessed directly through its
+ * user address: present, young and, for writes, writable and dirty; for
+ * reads, accessible to user space.
+ */
 static int
-pin_page_for_write(const void __user *_addr, pte_t **ptep, spinlock_t **ptlp)
+pin_user_page(const void __user *_addr, int write, pte_t **ptep,
+	      spinlock_t **ptlp)
 {
 	unsigned long addr = (unsigned long)_addr;
 	pgd_t *pgd;
@@ -45,7 +52,8 @@ pin_page_for_write(const void __user *_addr, pte_t **ptep, spinlock_t **ptlp)
 
 	pte = pte_offset_map_lock(current->mm, pmd, addr, &ptl);
 	if (unlikely(!pte_present(*pte) || !pte_young(*pte) ||
-	    !pte_write(*pte) || !pte_dirty(*pte))) {
+	    (write ? !pte_write(*pte) || !pte_dirty(*pte) :
+		     !(pte_val(*pte) & L_PTE_USER)))) {
 		pte_unmap_unlock(pte, ptl);
 		return 0;
 	}
@@ -56,6 +64,23 @@ pin_page_for_write(const void __user *_addr, pte_t **ptep, spinlock_t **ptlp)
 	return 1;
 }
 
+#ifdef CONFIG_ARM_NEON_COPY
+/*
+ * Pinning user pages costs mmap_sem and the pte lock, which only pays
+ * off for chunks memcpy() is going to copy with NEON.  The pinned path
+ * copies at most a page at a time, so it is not taken at all when the
+ * threshold (ULONG_MAX when NEON never wins) is above a page, and within
+ * it chunks below the threshold use the plain user access routines.
+ */
+#define uaccess_use_memcpy(n)						\
+	(neon_copy_threshold <= PAGE_SIZE &&				\
+	 (n) >= max(64UL, neon_copy_threshold))
+#define uaccess_chunk_use_memcpy(n)	((n) >= neon_copy_threshold)
+#else
+#define uaccess_use_memcpy(n)		((n) >= 64)
+#define uaccess_chunk_use_memcpy(n)	1
+#endif
+
 static unsigned long noinline
 __copy_to_user_memcpy(void __user *to, const void *from, unsigned long n)
 {
@@ -74,20 +99,35 @@ __copy_to_user_memcpy(void __user *to, const void *from, unsigned long n)
 	while (n) {
 		pte_t *pte;
 		spinlock_t *ptl;
-		int tocopy;
+		int tocopy, left;
+
+		tocopy = (~(unsigned long)to & ~PAGE_MASK) + 1;
+		if (tocopy > n)
+			tocopy = n;
 
-		while (!pin_page_for_write(to, &pte, &ptl)) {
+		if (!uaccess_chunk_use_memcpy(tocopy)) {
+			/* may fault, so not with mmap_sem held */
 			if (!atomic)
 				up_read(&current->mm->mmap_sem);
-			if (__put_user(0, (char __user *)to))
+			left = __copy_to_user_std(to, from, tocopy);
+			n -= tocopy - left;
+			if (left)
 				goto out;
 			if (!atomic)
 				down_read(&current->mm->mmap_sem);
+			to += tocopy;
+			from += tocopy;
+			continue;
 		}
 
-		tocopy = (~(unsigned long)to & ~PAGE_MASK) + 1;
-		if (tocopy > n)
-			tocopy = n;
+		while (!pin_user_page(to, 1, &pte, &ptl)) {
+			if (!atomic)
+				up_read(&current->mm->mmap_sem);
+			if (__put_user(0, (char __user *)to))
+				goto out;
+			if (!atomic)
+				down_read(&current->mm->mmap_sem);
+		}
 
 		memcpy((void *)to, from, tocopy);
 		to += tocopy;
@@ -113,10 +153,93 @@ __copy_to_user(void __user *to, const void *from, unsigned long n)
 	 * With frame pointer disabled, tail call optimization kicks in
 	 * as well making this test almost invisible.
 	 */
-	if (n < 64)
+	if (!uaccess_use_memcpy(n))
 		return __copy_to_user_std(to, from, n);
 	return __copy_to_user_memcpy(to, from, n);
 }
+
+#ifdef CONFIG_ARM_NEON_COPY
+/*
+ * copy_from_user() only goes through memcpy() when memcpy() would use
+ * NEON for the size; the plain ldr/str copy is as fast otherwise.
+ */
+static unsigned long noinline
+__copy_from_user_memcpy(void *to, const void __user *from, unsigned long n)
+{
+	int atomic;
+
+	if (unlikely(segment_eq(get_fs(), KERNEL_DS))) {
+		memcpy(to, (const void *)from, n);
+		return 0;
+	}
+
+	/* the mmap semaphore is taken only if not in an atomic context */
+	atomic = in_atomic();
+
+	if (!atomic)
+		down_read(&current->mm->mmap_sem);
+	while (n) {
+		pte_t *pte;
+		spinlock_t *ptl;
+		int tocopy, left;
+
+		tocopy = (~(unsigned long)from & ~PAGE_MASK) + 1;
+		if (tocopy > n)
+			tocopy = n;
+
+		if (!uaccess_chunk_use_memcpy(tocopy)) {
+			/* may fault, so not with mmap_sem held */
+			if (!atomic)
+				up_read(&current->mm->mmap_sem);
+			left = __copy_from_user_std(to, from, tocopy);
+			n -= tocopy - left;
+			/* the tail of this chunk has been zeroed already */
+			to += tocopy - left;
+			if (left)
+				goto out;
+			if (!atomic)
+				down_read(&current->mm->mmap_sem);
+			from += tocopy;
+			continue;
+		}
+
+		while (!pin_user_page(from, 0, &pte, &ptl)) {
+			char temp;
+
+			if (!atomic)
+				up_read(&current->mm->mmap_sem);
+			if (__get_user(temp, (const char __user *)from))
+				goto out;
+			if (!atomic)
+				down_read(&current->mm->mmap_sem);
+		}
+
+		memcpy(to, (const void *)from, tocopy);
+		to += tocopy;
+		from += tocopy;
+		n -= tocopy;
+
+		pte_unmap_unlock(pte, ptl);
+	}
+	if (!atomic)
+		up_read(&current->mm->mmap_sem);
+
+out:
+	/* like __copy_from_user_std, zero what could not be copied */
+	if (n)
+		memset(to, 0, n);
+	return n;
+}
+
+unsigned long
+__copy_from_user(void *to, const void __user *from, unsigned long n)
+{
+	/* See rational for this in __copy_to_user() above. */
+	if (!uaccess_use_memcpy(n))
+		return __copy_from_user_std(to, from, n);
+	return __copy_from_user_memcpy(to, from, n);
+}
+#endif
 	
 static unsigned long noinline
 __clear_user_memset(void __user *addr, unsigned long n)
@@ -132,7 +255,7 @@ __clear_user_memset(void __user *addr, unsigned long n)
 		spinlock_t *ptl;
 		int tocopy;
 
-		while (!pin_page_for_write(addr, &pte, &ptl)) {
+		while (!pin_user_page(addr, 1, &pte, &ptl)) {
 			up_read(&current->mm->mmap_sem);
 			if (__put_user(0, (char __user *)addr))
 				goto out;
@@ -157,8 +280,11 @@ out:
 
 unsigned long __clear_user(void __user *addr, unsigned long n)
 {
-	/* See rational for this in __copy_to_user() above. */
-	if (n < 64)
+	/*
+	 * See rational for this in __copy_to_user() above.  memset() has
+	 * no NEON path, so with ARM_NEON_COPY pinning never pays off.
+	 */
+	if (IS_ENABLED(CONFIG_ARM_NEON_COPY) || n < 64)
 		return __clear_user_std(addr, n);
 	return __clear_user_memset(addr, n);
 }
@@ -70,6 +70,9 @@ static int bam_adaptive_timer_enabled = 1;
 module_param_named(adaptive_timer_enabled,
 			bam_adaptive_timer_enabled,
 		   int, S_IRUGO | S_IWUSR | S_IWGRP);
+static int bam_rx_copybreak = 128;
+module_param_named(rx_copybreak, bam_rx_copybreak,
+		   int, S_IRUGO | S_IWUSR | S_IWGRP);
 
 #if defined(DEBUG)
 static uint32_t bam_dmux_read_cnt;
@@ -78,6 +81,10 @@ static uint32_t bam_dmux_write_cpy_cnt;
 static uint32_t bam_dmux_write_cpy_bytes;
 static uint32_t bam_dmux_tx_sps_failure_cnt;
 static uint32_t bam_dmux_tx_stall_cnt;
+static uint32_t bam_dmux_tx_sg_cnt;
+static uint32_t bam_dmux_rx_pool_hit_cnt;
+static uint32_t bam_dmux_rx_pool_miss_cnt;
+static uint32_t bam_dmux_rx_copybreak_cnt;
 static atomic_t bam_dmux_ack_out_cnt = ATOMIC_INIT(0);
 static atomic_t bam_dmux_ack_in_cnt = ATOMIC_INIT(0);
 static atomic_t bam_dmux_a2_pwr_cntl_in_cnt = ATOMIC_INIT(0);
@@ -118,6 +125,22 @@ static atomic_t bam_dmux_a2_pwr_cntl_in_cnt = ATOMIC_INIT(0);
 	bam_dmux_tx_stall_cnt++; \
 } while (0)
 
+#define DBG_INC_TX_SG_CNT() do { \
+	bam_dmux_tx_sg_cnt++; \
+} while (0)
+
+#define DBG_INC_RX_POOL_HIT_CNT() do { \
+	bam_dmux_rx_pool_hit_cnt++; \
+} while (0)
+
+#define DBG_INC_RX_POOL_MISS_CNT() do { \
+	bam_dmux_rx_pool_miss_cnt++; \
+} while (0)
+
+#define DBG_INC_RX_COPYBREAK_CNT() do { \
+	bam_dmux_rx_copybreak_cnt++; \
+} while (0)
+
 #define DBG_INC_ACK_OUT_CNT() \
 	atomic_inc(&bam_dmux_ack_out_cnt)
 
@@ -133,6 +156,10 @@ static atomic_t bam_dmux_a2_pwr_cntl_in_cnt = ATOMIC_INIT(0);
 #define DBG_INC_WRITE_CPY(x...) do { } while (0)
 #define DBG_INC_TX_SPS_FAILURE_CNT() do { } while (0)
 #define DBG_INC_TX_STALL_CNT() do { } while (0)
+#define DBG_INC_TX_SG_CNT() do { } while (0)
+#define DBG_INC_RX_POOL_HIT_CNT() do { } while (0)
+#define DBG_INC_RX_POOL_MISS_CNT() do { } while (0)
+#define DBG_INC_RX_COPYBREAK_CNT() do { } while (0)
 #define DBG_INC_ACK_OUT_CNT() do { } while (0)
 #define DBG_INC_A2_POWER_CONTROL_IN_CNT() \
 	do { } while (0)
@@ -159,6 +186,8 @@ struct tx_pkt_info {
 	struct list_head list_node;
 	unsigned ts_sec;
 	unsigned long ts_nsec;
+	uint32_t nr_frags;
+	dma_addr_t frag_dma[0];
 };
 
 struct rx_pkt_info {
@@ -195,6 +224,10 @@ static unsigned long rx_timer_interval;
 static LIST_HEAD(bam_rx_pool);
 static DEFINE_MUTEX(bam_rx_pool_mutexlock);
 static int bam_rx_pool_len;
+static LIST_HEAD(bam_rx_recycle_pool);
+static int bam_rx_recycle_len;
+static uint32_t bam_mux_pad_buf;
+static dma_addr_t bam_mux_pad_dma;
 static LIST_HEAD(bam_tx_pool);
 static DEFINE_SPINLOCK(bam_tx_pool_spinlock);
 static DEFINE_MUTEX(bam_pdev_mutexlock);
@@ -410,10 +443,88 @@ static inline void verify_tx_queue_is_empty(const char *func)
 	spin_unlock_irqrestore(&bam_tx_pool_spinlock, flags);
 }
 
-static void queue_rx(void)
+static struct rx_pkt_info *bam_mux_rx_alloc(void)
 {
 	void *ptr;
 	struct rx_pkt_info *info;
+
+	info = kmalloc(sizeof(struct rx_pkt_info), GFP_KERNEL);
+	if (!info) {
+		pr_err("%s: unable to alloc rx_pkt_info\n", __func__);
+		return NULL;
+	}
+
+	INIT_WORK(&info->work, handle_bam_mux_cmd);
+
+	info->skb = __dev_alloc_skb(BUFFER_SIZE, GFP_KERNEL);
+	if (info->skb == NULL) {
+		DMUX_LOG_KERR("%s: unable to alloc skb\n", __func__);
+		goto fail_info;
+	}
+	ptr = skb_put(info->skb, BUFFER_SIZE);
+
+	info->dma_address = dma_map_single(NULL, ptr, BUFFER_SIZE,
+						DMA_FROM_DEVICE);
+	if (info->dma_address == 0 || info->dma_address == ~0) {
+		DMUX_LOG_KERR("%s: dma_map_single failure %p for %p\n",
+			__func__, (void *)info->dma_address, ptr);
+		goto fail_skb;
+	}
+	return info;
+
+fail_skb:
+	dev_kfree_skb_any(info->skb);
+
+fail_info:
+	kfree(info);
+	return NULL;
+}
+
+static void bam_mux_rx_free(struct rx_pkt_info *info)
+{
+	dma_unmap_single(NULL, info->dma_address, BUFFER_SIZE,
+				DMA_FROM_DEVICE);
+	dev_kfree_skb_any(info->skb);
+	kfree(info);
+}
+
+/*
+ * Buffers whose contents never leave the mux (commands, dropped frames and
+ * frames copied out under rx_copybreak) stay mapped and are parked here so
+ * queue_rx() can post them again without allocating or mapping.
+ */
+static void bam_mux_rx_recycle(struct rx_pkt_info *info)
+{
+	mutex_lock(&bam_rx_pool_mutexlock);
+	if (!in_global_reset && bam_rx_recycle_len < NUM_BUFFERS) {
+		list_add_tail(&info->list_node, &bam_rx_recycle_pool);
+		++bam_rx_recycle_len;
+		info = NULL;
+	}
+	mutex_unlock(&bam_rx_pool_mutexlock);
+
+	if (info)
+		bam_mux_rx_free(info);
+}
+
+static void bam_mux_rx_recycle_flush(void)
+{
+	struct rx_pkt_info *info;
+
+	mutex_lock(&bam_rx_pool_mutexlock);
+	while (!list_empty(&bam_rx_recycle_pool)) {
+		info = list_first_entry(&bam_rx_recycle_pool,
+					struct rx_pkt_info, list_node);
+		list_del(&info->list_node);
+		bam_mux_rx_free(info);
+	}
+	bam_rx_recycle_len = 0;
+	mutex_unlock(&bam_rx_pool_mutexlock);
+}
+
+static void queue_rx(void)
+{
+	struct rx_pkt_info *info;
 	int ret;
 	int rx_len_cached;
 
@@ -425,27 +536,25 @@ static void queue_rx(void)
 		if (in_global_reset)
 			goto fail;
 
-		info = kmalloc(sizeof(struct rx_pkt_info), GFP_KERNEL);
-		if (!info) {
-			pr_err("%s: unable to alloc rx_pkt_info\n", __func__);
-			goto fail;
+		info = NULL;
+		mutex_lock(&bam_rx_pool_mutexlock);
+		if (!list_empty(&bam_rx_recycle_pool)) {
+			info = list_first_entry(&bam_rx_recycle_pool,
+						struct rx_pkt_info, list_node);
+			list_del(&info->list_node);
+			--bam_rx_recycle_len;
 		}
+		mutex_unlock(&bam_rx_pool_mutexlock);
 
-		INIT_WORK(&info->work, handle_bam_mux_cmd);
-
-		info->skb = __dev_alloc_skb(BUFFER_SIZE, GFP_KERNEL);
-		if (info->skb == NULL) {
-			DMUX_LOG_KERR("%s: unable to alloc skb\n", __func__);
-			goto fail_info;
-		}
-		ptr = skb_put(info->skb, BUFFER_SIZE);
-
-		info->dma_address = dma_map_single(NULL, ptr, BUFFER_SIZE,
-							DMA_FROM_DEVICE);
-		if (info->dma_address == 0 || info->dma_address == ~0) {
-			DMUX_LOG_KERR("%s: dma_map_single failure %p for %p\n",
-				__func__, (void *)info->dma_address, ptr);
-			goto fail_skb;
+		if (info) {
+			DBG_INC_RX_POOL_HIT_CNT();
+			dma_sync_single_for_device(NULL, info->dma_address,
+						BUFFER_SIZE, DMA_FROM_DEVICE);
+		} else {
+			DBG_INC_RX_POOL_MISS_CNT();
+			info = bam_mux_rx_alloc();
+			if (!info)
+				goto fail;
 		}
 
 		mutex_lock(&bam_rx_pool_mutexlock);
@@ -461,22 +570,14 @@ static void queue_rx(void)
 			DMUX_LOG_KERR("%s: sps_transfer_one failed %d\n",
 				__func__, ret);
 
-			dma_unmap_single(NULL, info->dma_address, BUFFER_SIZE,
-						DMA_FROM_DEVICE);
-
-			goto fail_skb;
+			bam_mux_rx_free(info);
+			goto fail;
 		}
 		mutex_unlock(&bam_rx_pool_mutexlock);
 
 	}
 	return;
 
-fail_skb:
-	dev_kfree_skb_any(info->skb);
-
-fail_info:
-	kfree(info);
-
 fail:
 	if (rx_len_cached == 0) {
 		DMUX_LOG_KERR("%s: RX queue failure\n", __func__);
@@ -484,29 +585,51 @@ fail:
 	}
 }
 
-static void bam_mux_process_data(struct sk_buff *rx_skb)
+static void bam_mux_process_data(struct rx_pkt_info *info)
 {
 	unsigned long flags;
 	struct bam_mux_hdr *rx_hdr;
+	struct sk_buff *rx_skb = NULL;
 	unsigned long event_data;
+	uint8_t ch_id;
 
-	rx_hdr = (struct bam_mux_hdr *)rx_skb->data;
+	rx_hdr = (struct bam_mux_hdr *)info->skb->data;
+	ch_id = rx_hdr->ch_id;
+
+	/*
+	 * Small frames are copied into a right-sized skb and the DMA buffer
+	 * is recycled; anything larger is handed up in place.
+	 */
+	if (rx_hdr->pkt_len <= bam_rx_copybreak)
+		rx_skb = __dev_alloc_skb(rx_hdr->pkt_len, GFP_KERNEL);
+
+	if (rx_skb) {
+		memcpy(skb_put(rx_skb, rx_hdr->pkt_len), rx_hdr + 1,
+			rx_hdr->pkt_len);
+		bam_mux_rx_recycle(info);
+		DBG_INC_RX_COPYBREAK_CNT();
+	} else {
+		rx_skb = info->skb;
+		dma_unmap_single(NULL, info->dma_address, BUFFER_SIZE,
+					DMA_FROM_DEVICE);
+		kfree(info);
 
-	rx_skb->data = (unsigned char *)(rx_hdr + 1);
-	rx_skb->tail = rx_skb->data + rx_hdr->pkt_len;
-	rx_skb->len = rx_hdr->pkt_len;
-	rx_skb->truesize = rx_hdr->pkt_len + sizeof(struct sk_buff);
+		rx_skb->data = (unsigned char *)(rx_hdr + 1);
+		rx_skb->tail = rx_skb->data + rx_hdr->pkt_len;
+		rx_skb->len = rx_hdr->pkt_len;
+		rx_skb->truesize = rx_hdr->pkt_len + sizeof(struct sk_buff);
+	}
 
 	event_data = (unsigned long)(rx_skb);
 
-	spin_lock_irqsave(&bam_ch[rx_hdr->ch_id].lock, flags);
-	if (bam_ch[rx_hdr->ch_id].notify)
-		bam_ch[rx_hdr->ch_id].notify(
-			bam_ch[rx_hdr->ch_id].priv, BAM_DMUX_RECEIVE,
+	spin_lock_irqsave(&bam_ch[ch_id].lock, flags);
+	if (bam_ch[ch_id].notify)
+		bam_ch[ch_id].notify(
+			bam_ch[ch_id].priv, BAM_DMUX_RECEIVE,
 							event_data);
 	else
 		dev_kfree_skb_any(rx_skb);
-	spin_unlock_irqrestore(&bam_ch[rx_hdr->ch_id].lock, flags);
+	spin_unlock_irqrestore(&bam_ch[ch_id].lock, flags);
 
 	queue_rx();
 }
@@ -545,8 +668,8 @@ static void handle_bam_mux_cmd(struct work_struct *work)
 
 	info = container_of(work, struct rx_pkt_info, work);
 	rx_skb = info->skb;
-	dma_unmap_single(NULL, info->dma_address, BUFFER_SIZE, DMA_FROM_DEVICE);
-	kfree(info);
+	dma_sync_single_for_cpu(NULL, info->dma_address, BUFFER_SIZE,
+					DMA_FROM_DEVICE);
 
 	rx_hdr = (struct bam_mux_hdr *)rx_skb->data;
 
@@ -560,7 +683,7 @@ static void handle_bam_mux_cmd(struct work_struct *work)
 			" pad %d ch %d len %d\n", __func__,
 			rx_hdr->magic_num, rx_hdr->reserved, rx_hdr->cmd,
 			rx_hdr->pad_len, rx_hdr->ch_id, rx_hdr->pkt_len);
-		dev_kfree_skb_any(rx_skb);
+		bam_mux_rx_recycle(info);
 		queue_rx();
 		return;
 	}
@@ -571,7 +694,7 @@ static void handle_bam_mux_cmd(struct work_struct *work)
 			" pad %d ch %d len %d\n", __func__,
 			rx_hdr->ch_id, rx_hdr->reserved, rx_hdr->cmd,
 			rx_hdr->pad_len, rx_hdr->ch_id, rx_hdr->pkt_len);
-		dev_kfree_skb_any(rx_skb);
+		bam_mux_rx_recycle(info);
 		queue_rx();
 		return;
 	}
@@ -579,7 +702,7 @@ static void handle_bam_mux_cmd(struct work_struct *work)
 	switch (rx_hdr->cmd) {
 	case BAM_MUX_HDR_CMD_DATA:
 		DBG_INC_READ_CNT(rx_hdr->pkt_len);
-		bam_mux_process_data(rx_skb);
+		bam_mux_process_data(info);
 		break;
 	case BAM_MUX_HDR_CMD_OPEN:
 		bam_dmux_log("%s: opening cid %d PC enabled\n", __func__,
@@ -590,7 +713,7 @@ static void handle_bam_mux_cmd(struct work_struct *work)
 								__func__);
 			disconnect_ack = 0;
 		}
-		dev_kfree_skb_any(rx_skb);
+		bam_mux_rx_recycle(info);
 		break;
 	case BAM_MUX_HDR_CMD_OPEN_NO_A2_PC:
 		bam_dmux_log("%s: opening cid %d PC disabled\n", __func__,
@@ -602,7 +725,7 @@ static void handle_bam_mux_cmd(struct work_struct *work)
 		}
 
 		handle_bam_mux_cmd_open(rx_hdr);
-		dev_kfree_skb_any(rx_skb);
+		bam_mux_rx_recycle(info);
 		break;
 	case BAM_MUX_HDR_CMD_CLOSE:
 		/* probably should drop pending write */
@@ -613,6 +736,7 @@ static void handle_bam_mux_cmd(struct work_struct *work)
 			bam_dmux_log("%s: close cid %d aborted due to ssr\n",
 					__func__, rx_hdr->ch_id);
 			mutex_unlock(&bam_pdev_mutexlock);
+			bam_mux_rx_recycle(info);
 			break;
 		}
 		spin_lock_irqsave(&bam_ch[rx_hdr->ch_id].lock, flags);
@@ -624,7 +748,7 @@ static void handle_bam_mux_cmd(struct work_struct *work)
 		if (!bam_ch[rx_hdr->ch_id].pdev)
 			pr_err("%s: platform_device_alloc failed\n", __func__);
 		mutex_unlock(&bam_pdev_mutexlock);
-		dev_kfree_skb_any(rx_skb);
+		bam_mux_rx_recycle(info);
 		queue_rx();
 		break;
 	default:
@@ -633,12 +757,23 @@ static void handle_bam_mux_cmd(struct work_struct *work)
 			__func__, rx_hdr->magic_num, rx_hdr->reserved,
 			rx_hdr->cmd, rx_hdr->pad_len, rx_hdr->ch_id,
 			rx_hdr->pkt_len);
-		dev_kfree_skb_any(rx_skb);
+		bam_mux_rx_recycle(info);
 		queue_rx();
 		return;
 	}
 }
 
+static void bam_mux_tx_unmap(struct tx_pkt_info *pkt)
+{
+	uint32_t i;
+
+	dma_unmap_single(NULL, pkt->dma_address, pkt->len, DMA_TO_DEVICE);
+	for (i = 0; i < pkt->nr_frags; i++)
+		dma_unmap_page(NULL, pkt->frag_dma[i],
+			skb_frag_size(&skb_shinfo(pkt->skb)->frags[i]),
+			DMA_TO_DEVICE);
+}
+
 static int bam_mux_write_cmd(void *data, uint32_t len)
 {
 	int rc;
@@ -665,6 +800,7 @@ static int bam_mux_write_cmd(void *data, uint32_t len)
 	pkt->len = len;
 	pkt->dma_address = dma_address;
 	pkt->is_cmd = 1;
+	pkt->nr_frags = 0;
 	set_tx_timestamp(pkt);
 	INIT_WORK(&pkt->work, bam_mux_write_done);
 	spin_lock_irqsave(&bam_tx_pool_spinlock, flags);
@@ -753,9 +889,15 @@ int msm_bam_dmux_write(uint32_t id, struct sk_buff *skb)
 	int rc = 0;
 	struct bam_mux_hdr *hdr;
 	unsigned long flags;
-	struct sk_buff *new_skb = NULL;
 	dma_addr_t dma_address;
 	struct tx_pkt_info *pkt;
+	struct sps_iovec iovec[MAX_SKB_FRAGS + 2];
+	struct sps_transfer transfer;
+	skb_frag_t *frag;
+	uint32_t nr_frags;
+	uint32_t pad;
+	uint32_t n;
+	int sg;
 
 	if (id >= BAM_DMUX_NUM_CHANNELS)
 		return -EINVAL;
@@ -790,86 +932,110 @@ int msm_bam_dmux_write(uint32_t id, struct sk_buff *skb)
 		notify_all(BAM_DMUX_UL_CONNECTED, (unsigned long)(NULL));
 	}
 
-	/* if skb do not have any tailroom for padding,
-	   copy the skb into a new expanded skb */
-	if ((skb->len & 0x3) && (skb_tailroom(skb) < (4 - (skb->len & 0x3)))) {
-		/* revisit, probably dev_alloc_skb and memcpy is effecient */
-		new_skb = skb_copy_expand(skb, skb_headroom(skb),
-					  4 - (skb->len & 0x3), GFP_ATOMIC);
-		if (new_skb == NULL) {
-			pr_err("%s: cannot allocate skb\n", __func__);
-			goto write_fail;
-		}
-		dev_kfree_skb_any(skb);
-		skb = new_skb;
-		DBG_INC_WRITE_CPY(skb->len);
-	}
+	/*
+	 * Paged skbs, and linear skbs without tailroom for the padding, are
+	 * sent as a descriptor chain: head, one per fragment, then the
+	 * padding from a shared zero buffer.  Nothing is copied.
+	 */
+	pad = (4 - (skb->len & 0x3)) & 0x3;
+	sg = skb_is_nonlinear(skb) || (skb_tailroom(skb) < pad);
+	nr_frags = skb_shinfo(skb)->nr_frags;
 
 	hdr = (struct bam_mux_hdr *)skb_push(skb, sizeof(struct bam_mux_hdr));
 
-	/* caller should allocate for hdr and padding
-	   hdr is fine, padding is tricky */
+	/* caller should allocate for hdr */
 	hdr->magic_num = BAM_MUX_HDR_MAGIC_NO;
 	hdr->cmd = BAM_MUX_HDR_CMD_DATA;
 	hdr->reserved = 0;
 	hdr->ch_id = id;
 	hdr->pkt_len = skb->len - sizeof(struct bam_mux_hdr);
-	if (skb->len & 0x3)
-		skb_put(skb, 4 - (skb->len & 0x3));
-
-	hdr->pad_len = skb->len - (sizeof(struct bam_mux_hdr) + hdr->pkt_len);
+	hdr->pad_len = pad;
+	if (!sg)
+		skb_put(skb, pad);
 
 	DBG("%s: data %p, tail %p skb len %d pkt len %d pad len %d\n",
 	    __func__, skb->data, skb->tail, skb->len,
 	    hdr->pkt_len, hdr->pad_len);
 
-	pkt = kmalloc(sizeof(struct tx_pkt_info), GFP_ATOMIC);
+	pkt = kmalloc(sizeof(struct tx_pkt_info) +
+			nr_frags * sizeof(dma_addr_t), GFP_ATOMIC);
 	if (pkt == NULL) {
 		pr_err("%s: mem alloc for tx_pkt_info failed\n", __func__);
-		goto write_fail2;
+		goto write_fail;
 	}
 
-	dma_address = dma_map_single(NULL, skb->data, skb->len,
+	dma_address = dma_map_single(NULL, skb->data, skb_headlen(skb),
 					DMA_TO_DEVICE);
 	if (!dma_address) {
 		pr_err("%s: dma_map_single() failed\n", __func__);
-		goto write_fail3;
+		goto write_fail2;
 	}
 	pkt->skb = skb;
 	pkt->dma_address = dma_address;
+	pkt->len = skb_headlen(skb);
 	pkt->is_cmd = 0;
+	pkt->nr_frags = 0;
+
+	iovec[0].addr = dma_address;
+	iovec[0].size = skb_headlen(skb);
+	iovec[0].flags = 0;
+	n = 1;
+	for (; pkt->nr_frags < nr_frags; pkt->nr_frags++) {
+		frag = &skb_shinfo(skb)->frags[pkt->nr_frags];
+		dma_address = skb_frag_dma_map(NULL, frag, 0,
+					skb_frag_size(frag), DMA_TO_DEVICE);
+		if (!dma_address) {
+			pr_err("%s: skb_frag_dma_map() failed\n", __func__);
+			goto write_fail3;
+		}
+		pkt->frag_dma[pkt->nr_frags] = dma_address;
+		iovec[n].addr = dma_address;
+		iovec[n].size = skb_frag_size(frag);
+		iovec[n].flags = 0;
+		n++;
+	}
+	if (sg && pad) {
+		iovec[n].addr = bam_mux_pad_dma;
+		iovec[n].size = pad;
+		iovec[n].flags = 0;
+		n++;
+	}
+	iovec[n - 1].flags = SPS_IOVEC_FLAG_INT | SPS_IOVEC_FLAG_EOT;
+
+	transfer.iovec_phys = 0;
+	transfer.iovec = iovec;
+	transfer.iovec_count = n;
+	transfer.user = pkt;
+
 	set_tx_timestamp(pkt);
 	INIT_WORK(&pkt->work, bam_mux_write_done);
 	spin_lock_irqsave(&bam_tx_pool_spinlock, flags);
 	list_add_tail(&pkt->list_node, &bam_tx_pool);
-	rc = sps_transfer_one(bam_tx_pipe, dma_address, skb->len,
-				pkt, SPS_IOVEC_FLAG_INT | SPS_IOVEC_FLAG_EOT);
+	rc = sps_transfer(bam_tx_pipe, &transfer);
 	if (rc) {
-		DMUX_LOG_KERR("%s sps_transfer_one failed rc=%d\n",
+		DMUX_LOG_KERR("%s sps_transfer failed rc=%d\n",
 			__func__, rc);
 		list_del(&pkt->list_node);
 		DBG_INC_TX_SPS_FAILURE_CNT();
 		spin_unlock_irqrestore(&bam_tx_pool_spinlock, flags);
-		dma_unmap_single(NULL, pkt->dma_address,
-					pkt->skb->len,	DMA_TO_DEVICE);
+		bam_mux_tx_unmap(pkt);
 		kfree(pkt);
-		if (new_skb)
-			dev_kfree_skb_any(new_skb);
 	} else {
 		spin_unlock_irqrestore(&bam_tx_pool_spinlock, flags);
 		spin_lock_irqsave(&bam_ch[id].lock, flags);
 		bam_ch[id].num_tx_pkts++;
 		spin_unlock_irqrestore(&bam_ch[id].lock, flags);
+		if (sg)
+			DBG_INC_TX_SG_CNT();
 	}
 	ul_packet_written = 1;
 	read_unlock(&ul_wakeup_lock);
 	return rc;
 
 write_fail3:
-	kfree(pkt);
+	bam_mux_tx_unmap(pkt);
 write_fail2:
-	if (new_skb)
-		dev_kfree_skb_any(new_skb);
+	kfree(pkt);
 write_fail:
 	read_unlock(&ul_wakeup_lock);
 	return -ENOMEM;
@@ -1045,6 +1211,19 @@ int msm_bam_dmux_is_ch_low(uint32_t id)
 	return ret;
 }
 
+/*
+ * Clients such as rmnet hand received packets to NAPI, which raises
+ * NET_RX_SOFTIRQ from this process context.  Run it once a batch has been
+ * delivered instead of leaving it pending until the next interrupt.
+ */
+static void bam_mux_rx_run_softirq(void)
+{
+	preempt_disable();
+	if (local_softirq_pending())
+		do_softirq();
+	preempt_enable();
+}
+
 static void rx_switch_to_interrupt_mode(void)
 {
 	struct sps_connect cur_rx_conn;
@@ -1117,11 +1296,12 @@ static void rx_switch_to_interrupt_mode(void)
 		mutex_unlock(&bam_rx_pool_mutexlock);
 		handle_bam_mux_cmd(&info->work);
 	}
+	bam_mux_rx_run_softirq();
 	return;
 
 fail:
 	pr_err("%s: reverting to polling\n", __func__);
-	queue_work_on(0, bam_mux_rx_workqueue, &rx_timer_work);
+	queue_work(bam_mux_rx_workqueue, &rx_timer_work);
 }
 
 static void rx_timer_work_func(struct work_struct *work)
@@ -1129,6 +1309,7 @@ static void rx_timer_work_func(struct work_struct *work)
 	struct sps_iovec iov;
 	struct rx_pkt_info *info;
 	int inactive_cycles = 0;
+	int batch = 0;
 	int ret;
 	u32 buffs_unused, buffs_used;
 
@@ -1137,6 +1318,10 @@ static void rx_timer_work_func(struct work_struct *work)
 		while (bam_connection_is_active) { /* deplete queue loop */
 			if (in_global_reset)
 				return;
+			if (batch >= NUM_BUFFERS) {
+				bam_mux_rx_run_softirq();
+				batch = 0;
+			}
 
 			ret = sps_get_iovec(bam_rx_pipe, &iov);
 			if (ret) {
@@ -1175,6 +1360,12 @@ static void rx_timer_work_func(struct work_struct *work)
 			--bam_rx_pool_len;
 			mutex_unlock(&bam_rx_pool_mutexlock);
 			handle_bam_mux_cmd(&info->work);
+			batch++;
+		}
+
+		if (batch) {
+			bam_mux_rx_run_softirq();
+			batch = 0;
 		}
 
 		if (inactive_cycles >= POLLING_INACTIVITY) {
@@ -1233,14 +1424,7 @@ static void bam_mux_tx_notify(struct sps_event_notify *notify)
 	switch (notify->event_id) {
 	case SPS_EVENT_EOT:
 		pkt = notify->data.transfer.user;
-		if (!pkt->is_cmd)
-			dma_unmap_single(NULL, pkt->dma_address,
-						pkt->skb->len,
-						DMA_TO_DEVICE);
-		else
-			dma_unmap_single(NULL, pkt->dma_address,
-						pkt->len,
-						DMA_TO_DEVICE);
+		bam_mux_tx_unmap(pkt);
 		queue_work(bam_mux_tx_workqueue, &pkt->work);
 		break;
 	default:
@@ -1279,11 +1463,7 @@ static void bam_mux_rx_notify(struct sps_event_notify *notify)
 			}
 			grab_wakelock();
 			polling_mode = 1;
-			/*
-			 * run on core 0 so that netif_rx() in rmnet uses only
-			 * one queue
-			 */
-			queue_work_on(0, bam_mux_rx_workqueue, &rx_timer_work);
+			queue_work(bam_mux_rx_workqueue, &rx_timer_work);
 		}
 		break;
 	default:
@@ -1335,7 +1515,12 @@ static int debug_stats(char *buf, int max)
 			"skb copy bytes:  %u\n"
 			"sps tx failures: %u\n"
 			"sps tx stalls:   %u\n"
+			"tx sg (no copy): %u\n"
+			"rx pool hits:    %u\n"
+			"rx pool misses:  %u\n"
+			"rx copybreak:    %u\n"
 			"rx queue len:    %d\n"
+			"rx recycle len:  %d\n"
 			"a2 ack out cnt:  %d\n"
 			"a2 ack in cnt:   %d\n"
 			"a2 pwr cntl in:  %d\n",
@@ -1345,7 +1530,12 @@ static int debug_stats(char *buf, int max)
 			bam_dmux_write_cpy_bytes,
 			bam_dmux_tx_sps_failure_cnt,
 			bam_dmux_tx_stall_cnt,
+			bam_dmux_tx_sg_cnt,
+			bam_dmux_rx_pool_hit_cnt,
+			bam_dmux_rx_pool_miss_cnt,
+			bam_dmux_rx_copybreak_cnt,
 			bam_rx_pool_len,
+			bam_rx_recycle_len,
 			atomic_read(&bam_dmux_ack_out_cnt),
 			atomic_read(&bam_dmux_ack_in_cnt),
 			atomic_read(&bam_dmux_a2_pwr_cntl_in_cnt)
@@ -1851,13 +2041,11 @@ static void disconnect_to_bam(void)
 		node = bam_rx_pool.next;
 		list_del(node);
 		info = container_of(node, struct rx_pkt_info, list_node);
-		dma_unmap_single(NULL, info->dma_address, BUFFER_SIZE,
-							DMA_FROM_DEVICE);
-		dev_kfree_skb_any(info->skb);
-		kfree(info);
+		bam_mux_rx_free(info);
 	}
 	bam_rx_pool_len = 0;
 	mutex_unlock(&bam_rx_pool_mutexlock);
+	bam_mux_rx_recycle_flush();
 
 	if (disconnect_ack)
 		toggle_apps_ack();
@@ -1991,17 +2179,11 @@ static int restart_notifier_cb(struct notifier_block *this,
 		list_del(node);
 		info = container_of(node, struct tx_pkt_info,
 							list_node);
-		if (!info->is_cmd) {
-			dma_unmap_single(NULL, info->dma_address,
-						info->skb->len,
-						DMA_TO_DEVICE);
+		bam_mux_tx_unmap(info);
+		if (!info->is_cmd)
 			dev_kfree_skb_any(info->skb);
-		} else {
-			dma_unmap_single(NULL, info->dma_address,
-						info->len,
-						DMA_TO_DEVICE);
+		else
 			kfree(info->skb);
-		}
 		kfree(info);
 	}
 	spin_unlock_irqrestore(&bam_tx_pool_spinlock, flags);
@@ -2333,13 +2515,22 @@ static int bam_dmux_probe(struct platform_device *pdev)
 	if (rc)
 		pr_err("%s: unable to set dfab clock rate\n", __func__);
 
+	/* padding source for uplink descriptor chains, never unmapped */
+	bam_mux_pad_dma = dma_map_single(NULL, &bam_mux_pad_buf,
+				sizeof(bam_mux_pad_buf), DMA_TO_DEVICE);
+	if (!bam_mux_pad_dma) {
+		pr_err("%s: unable to map tx padding\n", __func__);
+		return -ENOMEM;
+	}
+
 	/*
-	 * setup the workqueue so that it can be pinned to core 0 and not
-	 * block the watchdog pet function, so that netif_rx() in rmnet
-	 * only uses one queue.
+	 * Receive processing may run on any core.  Clients deliver packets
+	 * through NAPI, which keeps them in order, but the rx work itself
+	 * must never run on two cores at once.
 	 */
 	bam_mux_rx_workqueue = alloc_workqueue("bam_dmux_rx",
-					WQ_MEM_RECLAIM | WQ_CPU_INTENSIVE, 1);
+					WQ_MEM_RECLAIM | WQ_CPU_INTENSIVE |
+					WQ_NON_REENTRANT, 1);
 	if (!bam_mux_rx_workqueue)
 		return -ENOMEM;
 
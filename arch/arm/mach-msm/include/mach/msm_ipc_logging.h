@@ -110,6 +110,11 @@ void ipc_log_write(void *ctxt, struct encode_context *ectxt);
 /*
  * ipc_log_string: Helper function to log a string
  *
+ * Only the format pointer and the arguments are stored; the string is
+ * formatted when the log is read.  @fmt must stay valid until the
+ * context is destroyed, and %p extensions that dereference their
+ * argument see the object as it is at read time.  Safe from any context.
+ *
  * @ilctxt: Debug Log Context created using ipc_log_context_create()
  * @fmt:    Data specified using format specifiers
  */
@@ -123,9 +128,7 @@ int ipc_log_string(void *ilctxt, const char *fmt, ...) __printf(2, 3);
  * @size:    size of the buffer
  * @returns: 0 if no data read; >0 number of bytes read; < 0 error
  *
- * If no data is available to be read, then the ilctxt::read_avail
- * completion is reinitialized.  This allows clients to block
- * until new log data is save.
+ * Clients may sleep on ilctxt::read_wait until new log data is saved.
  */
 int ipc_log_extract(void *ilctxt, char *buff, int size);
 
@@ -193,6 +193,47 @@ int xdr_recv_int32(struct msm_rpc_xdr *xdr, int32_t *value);
 int xdr_recv_uint32(struct msm_rpc_xdr *xdr, uint32_t *value);
 int xdr_recv_bytes(struct msm_rpc_xdr *xdr, void **data, uint32_t *size);
 
+/*
+ * Precomputed layouts for fixed argument/result structures.  Each field
+ * is one XDR word on the wire; xdr_send_layout()/xdr_recv_layout() check
+ * the buffer once for the whole structure instead of once per word.
+ */
+enum msm_rpc_xdr_type {
+	XDR_TYPE_UINT32,
+	XDR_TYPE_INT32,
+	XDR_TYPE_UINT16,
+	XDR_TYPE_INT16,
+	XDR_TYPE_UINT8,
+	XDR_TYPE_INT8,
+};
+
+struct msm_rpc_xdr_field {
+	uint16_t offset;
+	uint16_t type;
+};
+
+struct msm_rpc_xdr_layout {
+	const struct msm_rpc_xdr_field *fields;
+	uint32_t count;
+};
+
+#define XDR_FIELD(_type, _struct, _member) \
+	{ .offset = offsetof(_struct, _member), .type = XDR_TYPE_##_type }
+
+#define DEFINE_XDR_LAYOUT(_name, _fields) \
+	const struct msm_rpc_xdr_layout _name = { \
+		.fields = _fields, .count = ARRAY_SIZE(_fields) }
+
+static inline uint32_t xdr_layout_size(const struct msm_rpc_xdr_layout *l)
+{
+	return l->count * sizeof(uint32_t);
+}
+
+int xdr_send_layout(struct msm_rpc_xdr *xdr,
+		    const struct msm_rpc_xdr_layout *layout, const void *obj);
+int xdr_recv_layout(struct msm_rpc_xdr *xdr,
+		    const struct msm_rpc_xdr_layout *layout, void *obj);
+
 struct msm_rpc_server
 {
 	struct list_head list;
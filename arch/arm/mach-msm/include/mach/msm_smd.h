@@ -322,6 +322,40 @@ const char *smd_pid_to_subsystem(uint32_t pid);
  */
 int smd_is_pkt_avail(smd_channel_t *ch);
 
+/**
+ * smd_read_packets() - read as many whole packets as are available
+ * @ch: packet channel to read from
+ * @data: destination buffer, packets are stored back to back
+ * @len: size of @data
+ * @sizes: filled with the size of each packet read
+ * @max_pkts: number of entries in @sizes
+ * @returns: number of packets read, or a negative error code
+ *
+ * Packets that are not yet completely in the FIFO or don't fit in the
+ * remaining space are left for the next call.  The remote is signalled
+ * once for the whole batch.
+ */
+int smd_read_packets(smd_channel_t *ch, void *data, int len, int *sizes,
+		     int max_pkts);
+
+/**
+ * smd_set_coalesce() - coalesce write interrupts to the remote processor
+ * @ch: channel
+ * @bytes: signal once this many bytes are pending, 0 to disable
+ * @usecs: signal pending data after at most this long
+ * @returns: 0 on success, -EINVAL if @bytes is set without @usecs
+ *
+ * Packet channels only count whole packets; the remote is never
+ * signalled in the middle of one.
+ */
+int smd_set_coalesce(smd_channel_t *ch, unsigned bytes, unsigned usecs);
+
+/**
+ * smd_flush() - signal the remote for any coalesced writes now
+ * @ch: channel
+ */
+int smd_flush(smd_channel_t *ch);
+
 /**
  * smd_module_init_notifier_register() - Register a smd module
  *					 init notifier block
@@ -461,6 +495,23 @@ static inline int smd_write_segment_avail(smd_channel_t *ch)
 	return -ENODEV;
 }
 
+static inline int smd_read_packets(smd_channel_t *ch, void *data, int len,
+				   int *sizes, int max_pkts)
+{
+	return -ENODEV;
+}
+
+static inline int
+smd_set_coalesce(smd_channel_t *ch, unsigned bytes, unsigned usecs)
+{
+	return -ENODEV;
+}
+
+static inline int smd_flush(smd_channel_t *ch)
+{
+	return -ENODEV;
+}
+
 static inline const char *smd_edge_to_subsystem(uint32_t type)
 {
 	return NULL;
@@ -26,6 +26,9 @@
 #include <linux/wait.h>
 #include <linux/delay.h>
 #include <linux/completion.h>
+#include <linux/mutex.h>
+#include <linux/percpu.h>
+#include <linux/log2.h>
 
 #include <mach/msm_ipc_logging.h>
 
@@ -127,6 +130,14 @@ int msg_read(struct ipc_log_context *ilctxt,
 	return sizeof(hdr) + (int)hdr.size;
 }
 
+/* wake log_cont readers without taking the wait queue lock per record */
+static inline void ipc_log_wake(struct ipc_log_context *ilctxt)
+{
+	smp_mb();
+	if (waitqueue_active(&ilctxt->read_wait))
+		wake_up_interruptible(&ilctxt->read_wait);
+}
+
 /*
  * Commits messages to the FIFO.  If the FIFO is full, then enough
  * messages are dropped to create space for the new message.
@@ -165,9 +176,9 @@ void ipc_log_write(void *ctxt, struct encode_context *ectxt)
 	}
 	ilctxt->write_page->hdr.write_offset += bytes_to_write;
 	ilctxt->write_avail -= ectxt->offset;
-	complete(&ilctxt->read_avail);
 	spin_unlock(&ilctxt->ipc_log_context_lock);
 	spin_unlock_irqrestore(&ipc_log_context_list_lock, flags);
+	ipc_log_wake(ilctxt);
 }
 EXPORT_SYMBOL(ipc_log_write);
 
@@ -316,33 +327,188 @@ EXPORT_SYMBOL(tsv_byte_array_write);
 /*
  * Helper function to log a string
  *
+ * The record goes into this cpu's ring with interrupts off; no lock is
+ * shared with other cpus or with the reader.
+ *
  * @ilctxt ipc_log_context created using ipc_log_context_create()
  * @fmt Data specified using format specifiers
  */
 int ipc_log_string(void *ilctxt, const char *fmt, ...)
 {
-	struct encode_context ectxt;
-	int avail_size, data_size, hdr_size = sizeof(struct tsv_header);
+	struct ipc_log_context *ctxt = (struct ipc_log_context *)ilctxt;
+	struct ipc_log_cpu *lc;
+	struct ipc_log_rec *rec;
+	unsigned long flags, seq;
 	va_list arg_list;
+	int words;
 
-	if (!ilctxt)
+	if (!ctxt)
 		return -EINVAL;
 
-	msg_encode_start(&ectxt, TSV_TYPE_STRING);
-	tsv_timestamp_write(&ectxt);
-	avail_size = (MAX_MSG_SIZE - (ectxt.offset + hdr_size));
+	local_irq_save(flags);
+	lc = this_cpu_ptr(ctxt->cpu_logs);
+	seq = lc->head;
+	rec = &lc->recs[seq & (ctxt->nr_recs - 1)];
+	rec->seq = 0;
+	smp_wmb();
+
+	rec->ts = sched_clock();
 	va_start(arg_list, fmt);
-	data_size = vsnprintf((ectxt.buff + ectxt.offset + hdr_size),
-			      avail_size, fmt, arg_list);
+	words = vbin_printf(rec->args, IPC_LOG_REC_WORDS, fmt, arg_list);
 	va_end(arg_list);
-	tsv_write_header(&ectxt, TSV_TYPE_BYTE_ARRAY, data_size);
-	ectxt.offset += data_size;
-	msg_encode_end(&ectxt);
-	ipc_log_write(ilctxt, &ectxt);
+	if (words <= IPC_LOG_REC_WORDS) {
+		rec->fmt = fmt;
+	} else {
+		va_start(arg_list, fmt);
+		vsnprintf((char *)rec->args, sizeof(rec->args), fmt, arg_list);
+		va_end(arg_list);
+		rec->fmt = NULL;
+		lc->truncated++;
+	}
+
+	smp_wmb();
+	rec->seq = seq + 1;
+	/* a reader that sees the new head must also see the seq */
+	smp_wmb();
+	lc->head = seq + 1;
+	local_irq_restore(flags);
+
+	ipc_log_wake(ctxt);
 	return 0;
 }
 EXPORT_SYMBOL(ipc_log_string);
 
+/*
+ * Fetches the oldest unread record of @lc into lc->next.  A record the
+ * writer overwrote before we got to it, including one overwritten while
+ * we were copying it, is counted as dropped.
+ *
+ * @returns 0 - nothing left on this cpu
+ *          1 - lc->next is valid
+ */
+static int ipc_log_cpu_next(struct ipc_log_context *ilctxt,
+			    struct ipc_log_cpu *lc)
+{
+	struct ipc_log_rec *slot;
+	unsigned long head, seq;
+
+	if (lc->have_next)
+		return 1;
+
+	for (;;) {
+		head = ACCESS_ONCE(lc->head);
+		if (lc->tail == head)
+			return 0;
+		if (head - lc->tail > ilctxt->nr_recs) {
+			lc->dropped += head - ilctxt->nr_recs - lc->tail;
+			lc->tail = head - ilctxt->nr_recs;
+		}
+		smp_rmb();
+
+		slot = &lc->recs[lc->tail & (ilctxt->nr_recs - 1)];
+		seq = ACCESS_ONCE(slot->seq);
+		smp_rmb();
+		memcpy(&lc->next, slot, sizeof(lc->next));
+		smp_rmb();
+		if (seq == lc->tail + 1 && ACCESS_ONCE(slot->seq) == seq)
+			break;
+
+		lc->dropped++;
+		lc->tail++;
+	}
+
+	lc->tail++;
+	lc->have_next = 1;
+	return 1;
+}
+
+static int ipc_log_rec_format(struct ipc_log_rec *rec, char *buff, int size)
+{
+	unsigned long long val = rec->ts;
+	unsigned long nanosec_rem;
+	int i;
+
+	nanosec_rem = do_div(val, 1000000000U);
+	i = scnprintf(buff, size, "[%6u.%09lu] ", (unsigned)val, nanosec_rem);
+	if (rec->fmt)
+		i += min(bstr_printf(buff + i, size - i, rec->fmt, rec->args),
+			 size - i - 1);
+	else
+		i += scnprintf(buff + i, size - i, "%s", (char *)rec->args);
+	return i;
+}
+
+/*
+ * Formats ipc_log_string() records from all cpus, oldest first, into the
+ * decode context.  Called with ilctxt::read_lock held.
+ */
+static void ipc_log_extract_strings(struct ipc_log_context *ilctxt,
+				    struct decode_context *dctxt)
+{
+	struct ipc_log_cpu *lc, *oldest;
+	unsigned long dropped;
+	int cpu, i;
+
+	while (dctxt->size >= MAX_MSG_DECODED_SIZE) {
+		oldest = NULL;
+		dropped = 0;
+		for_each_possible_cpu(cpu) {
+			lc = per_cpu_ptr(ilctxt->cpu_logs, cpu);
+			if (ipc_log_cpu_next(ilctxt, lc) &&
+			    (!oldest || lc->next.ts < oldest->next.ts))
+				oldest = lc;
+			dropped += lc->dropped;
+		}
+
+		if (dropped != ilctxt->dropped_reported) {
+			IPC_SPRINTF_DECODE(dctxt,
+				"[ipc_logging: %lu messages dropped]\n",
+				dropped - ilctxt->dropped_reported);
+			ilctxt->dropped_reported = dropped;
+			continue;
+		}
+		if (!oldest)
+			break;
+
+		i = ipc_log_rec_format(&oldest->next, dctxt->buff,
+				       dctxt->size);
+		dctxt->buff += i;
+		dctxt->size -= i;
+		oldest->have_next = 0;
+	}
+}
+
+/* nothing left to read, checked without locks */
+int ipc_log_empty(struct ipc_log_context *ilctxt)
+{
+	struct ipc_log_cpu *lc;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		lc = per_cpu_ptr(ilctxt->cpu_logs, cpu);
+		if (lc->have_next || ACCESS_ONCE(lc->head) != lc->tail)
+			return 0;
+	}
+	return is_ilctxt_empty(ilctxt);
+}
+
+int ipc_log_stats(struct ipc_log_context *ilctxt, char *buff, int size)
+{
+	struct ipc_log_cpu *lc;
+	int cpu, i = 0;
+
+	mutex_lock(&ilctxt->read_lock);
+	for_each_possible_cpu(cpu) {
+		lc = per_cpu_ptr(ilctxt->cpu_logs, cpu);
+		i += scnprintf(buff + i, size - i,
+			       "cpu%d: written %lu dropped %lu truncated %lu\n",
+			       cpu, ACCESS_ONCE(lc->head), lc->dropped,
+			       ACCESS_ONCE(lc->truncated));
+	}
+	mutex_unlock(&ilctxt->read_lock);
+	return i;
+}
+
 /**
  * ipc_log_extract - Reads and deserializes log
  *
@@ -351,9 +517,8 @@ EXPORT_SYMBOL(ipc_log_string);
  * @size:    size of the buffer
  * @returns: 0 if no data read; >0 number of bytes read; < 0 error
  *
- * If no data is available to be read, then the ilctxt::read_avail
- * completion is reinitialized.  This allows clients to block
- * until new log data is save.
+ * Messages committed with ipc_log_write() come first, then the
+ * ipc_log_string() records of all cpus in timestamp order.
  */
 int ipc_log_extract(void *ctxt, char *buff, int size)
 {
@@ -370,7 +535,8 @@ int ipc_log_extract(void *ctxt, char *buff, int size)
 	dctxt.output_format = OUTPUT_DEBUGFS;
 	dctxt.buff = buff;
 	dctxt.size = size;
-	read_lock_irqsave(&ipc_log_context_list_lock, flags);
+	mutex_lock(&ilctxt->read_lock);
+	spin_lock_irqsave(&ipc_log_context_list_lock, flags);
 	spin_lock(&ilctxt->ipc_log_context_lock);
 	while (dctxt.size >= MAX_MSG_DECODED_SIZE &&
 	       !is_ilctxt_empty(ilctxt)) {
@@ -378,19 +544,20 @@ int ipc_log_extract(void *ctxt, char *buff, int size)
 		deserialize_func = get_deserialization_func(ilctxt,
 							ectxt.hdr.type);
 		spin_unlock(&ilctxt->ipc_log_context_lock);
-		read_unlock_irqrestore(&ipc_log_context_list_lock, flags);
+		spin_unlock_irqrestore(&ipc_log_context_list_lock, flags);
 		if (deserialize_func)
 			deserialize_func(&ectxt, &dctxt);
 		else
 			pr_err("%s: unknown message 0x%x\n",
 				__func__, ectxt.hdr.type);
-		read_lock_irqsave(&ipc_log_context_list_lock, flags);
+		spin_lock_irqsave(&ipc_log_context_list_lock, flags);
 		spin_lock(&ilctxt->ipc_log_context_lock);
 	}
-	if ((size - dctxt.size) == 0)
-		init_completion(&ilctxt->read_avail);
 	spin_unlock(&ilctxt->ipc_log_context_lock);
-	read_unlock_irqrestore(&ipc_log_context_list_lock, flags);
+	spin_unlock_irqrestore(&ipc_log_context_list_lock, flags);
+
+	ipc_log_extract_strings(ilctxt, &dctxt);
+	mutex_unlock(&ilctxt->read_lock);
 	return size - dctxt.size;
 }
 EXPORT_SYMBOL(ipc_log_extract);
@@ -552,12 +719,24 @@ static void *get_deserialization_func(struct ipc_log_context *ilctxt,
 	return NULL;
 }
 
+static void ipc_log_free_cpus(struct ipc_log_context *ilctxt)
+{
+	int cpu;
+
+	if (!ilctxt->cpu_logs)
+		return;
+	for_each_possible_cpu(cpu)
+		kfree(per_cpu_ptr(ilctxt->cpu_logs, cpu)->recs);
+	free_percpu(ilctxt->cpu_logs);
+}
+
 void *ipc_log_context_create(int max_num_pages,
 			     const char *mod_name)
 {
 	struct ipc_log_context *ctxt;
 	struct ipc_log_page *pg = NULL;
-	int page_cnt, local_log_id;
+	struct ipc_log_cpu *lc;
+	int page_cnt, local_log_id, cpu;
 	unsigned long flags;
 
 	ctxt = kzalloc(sizeof(struct ipc_log_context), GFP_KERNEL);
@@ -566,8 +745,26 @@ void *ipc_log_context_create(int max_num_pages,
 		return 0;
 	}
 
+	/* each cpu gets as much string history as the whole log used to */
+	ctxt->nr_recs = rounddown_pow_of_two(max(max_num_pages, 1) *
+					     PAGE_SIZE / IPC_LOG_REC_SIZE);
+	ctxt->cpu_logs = alloc_percpu(struct ipc_log_cpu);
+	if (!ctxt->cpu_logs)
+		goto release_ipc_log_cpus;
+	for_each_possible_cpu(cpu) {
+		lc = per_cpu_ptr(ctxt->cpu_logs, cpu);
+		lc->recs = kcalloc(ctxt->nr_recs, sizeof(struct ipc_log_rec),
+				   GFP_KERNEL);
+		if (!lc->recs) {
+			pr_err("%s: cannot create ipc_log records\n",
+			       __func__);
+			goto release_ipc_log_cpus;
+		}
+	}
+
 	local_log_id = atomic_add_return(1, &next_log_id);
-	init_completion(&ctxt->read_avail);
+	init_waitqueue_head(&ctxt->read_wait);
+	mutex_init(&ctxt->read_lock);
 	INIT_LIST_HEAD(&ctxt->page_list);
 	INIT_LIST_HEAD(&ctxt->dfunc_info_list);
 	spin_lock_init(&ctxt->ipc_log_context_lock);
@@ -609,6 +806,8 @@ release_ipc_log_context:
 		list_del(&pg->hdr.list);
 		kfree(pg);
 	}
+release_ipc_log_cpus:
+	ipc_log_free_cpus(ctxt);
 	kfree(ctxt);
 	return 0;
 }
@@ -634,10 +833,11 @@ int ipc_log_context_destroy(void *ctxt)
 		kfree(pg);
 	}
 
-	write_lock_irqsave(&ipc_log_context_list_lock, flags);
+	spin_lock_irqsave(&ipc_log_context_list_lock, flags);
 	list_del(&ilctxt->list);
-	write_unlock_irqrestore(&ipc_log_context_list_lock, flags);
+	spin_unlock_irqrestore(&ipc_log_context_list_lock, flags);
 
+	ipc_log_free_cpus(ilctxt);
 	kfree(ilctxt);
 	return 0;
 }
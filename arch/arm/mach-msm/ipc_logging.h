@@ -30,6 +30,41 @@ struct ipc_log_page {
 	char data[PAGE_SIZE - sizeof(struct ipc_log_page_header)];
 };
 
+/*
+ * ipc_log_string() records: the format pointer and its arguments as packed
+ * by vbin_printf(), turned into text only when the log is read.  Arguments
+ * that don't fit are formatted at log time into args[] instead, truncated,
+ * and fmt is left NULL.
+ */
+#define IPC_LOG_REC_SIZE	128
+#define IPC_LOG_REC_WORDS	((IPC_LOG_REC_SIZE - sizeof(u64) - \
+				  sizeof(unsigned long) - sizeof(char *)) / \
+				 sizeof(u32))
+
+struct ipc_log_rec {
+	u64 ts;
+	unsigned long seq;	/* sequence number + 1, 0 while being written */
+	const char *fmt;
+	u32 args[IPC_LOG_REC_WORDS];
+};
+
+/*
+ * Per-cpu record ring.  Only the owning cpu writes it, with interrupts
+ * off, and it never waits for the reader: when the ring is full the
+ * oldest record is overwritten and the reader counts it as dropped.
+ */
+struct ipc_log_cpu {
+	unsigned long head;		/* records ever written */
+	unsigned long truncated;
+	struct ipc_log_rec *recs;
+
+	/* reader side, under ipc_log_context::read_lock */
+	unsigned long tail ____cacheline_aligned;
+	unsigned long dropped;
+	int have_next;
+	struct ipc_log_rec next;
+};
+
 struct ipc_log_context {
 	struct list_head list;
 	struct list_head page_list;
@@ -41,7 +76,12 @@ struct ipc_log_context {
 	struct dentry *dent;
 	struct list_head dfunc_info_list;
 	spinlock_t ipc_log_context_lock;
-	struct completion read_avail;
+	wait_queue_head_t read_wait;
+
+	struct ipc_log_cpu __percpu *cpu_logs;
+	unsigned long nr_recs;		/* per cpu, power of two */
+	struct mutex read_lock;
+	unsigned long dropped_reported;
 };
 
 struct dfunc_info {
@@ -73,6 +113,10 @@ extern spinlock_t ipc_log_context_list_lock;
 extern int msg_read(struct ipc_log_context *ilctxt,
 		    struct encode_context *ectxt);
 
+extern int ipc_log_empty(struct ipc_log_context *ilctxt);
+extern int ipc_log_stats(struct ipc_log_context *ilctxt,
+			 char *buff, int size);
+
 static inline int is_ilctxt_empty(struct ipc_log_context *ilctxt)
 {
 	if (!ilctxt)
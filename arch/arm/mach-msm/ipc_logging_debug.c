@@ -47,8 +47,8 @@ static int debug_log(struct ipc_log_context *ilctxt,
 	do {
 		i = ipc_log_extract(ilctxt, buff, size - 1);
 		if (cont && i == 0) {
-			wait_for_completion_interruptible(&ilctxt->read_avail);
-			if (signal_pending(current))
+			if (wait_event_interruptible(ilctxt->read_wait,
+						     !ipc_log_empty(ilctxt)))
 				break;
 		}
 	} while (cont && i == 0);
@@ -105,6 +105,24 @@ static ssize_t debug_read_cont(struct file *file, char __user *buff,
 	return debug_read_helper(file, buff, count, ppos, 1);
 }
 
+static ssize_t debug_read_stats(struct file *file, char __user *buff,
+				size_t count, loff_t *ppos)
+{
+	struct ipc_log_context *ilctxt = file->private_data;
+	char *buffer;
+	int bsize;
+	ssize_t ret;
+
+	buffer = kmalloc(PAGE_SIZE, GFP_KERNEL);
+	if (!buffer)
+		return -ENOMEM;
+
+	bsize = ipc_log_stats(ilctxt, buffer, PAGE_SIZE);
+	ret = simple_read_from_buffer(buff, count, ppos, buffer, bsize);
+	kfree(buffer);
+	return ret;
+}
+
 static int debug_open(struct inode *inode, struct file *file)
 {
 	file->private_data = inode->i_private;
@@ -121,6 +139,11 @@ static const struct file_operations debug_ops_cont = {
 	.open = debug_open,
 };
 
+static const struct file_operations debug_ops_stats = {
+	.read = debug_read_stats,
+	.open = debug_open,
+};
+
 static void debug_create(const char *name, mode_t mode,
 			 struct dentry *dent,
 			 struct ipc_log_context *ilctxt,
@@ -165,6 +188,8 @@ void create_ctx_debugfs(struct ipc_log_context *ctxt,
 				     ctxt, &debug_ops);
 			debug_create("log_cont", 0444, ctxt->dent,
 				     ctxt, &debug_ops_cont);
+			debug_create("stats", 0444, ctxt->dent,
+				     ctxt, &debug_ops_stats);
 		}
 	}
 	add_deserialization_func((void *)ctxt,
@@ -27,6 +27,9 @@
 #include <linux/platform_device.h>
 #include <linux/uaccess.h>
 #include <linux/debugfs.h>
+#include <linux/rculist.h>
+#include <linux/srcu.h>
+#include <linux/kref.h>
 
 #include <asm/uaccess.h>
 #include <asm/byteorder.h>
@@ -96,6 +99,32 @@ static DEFINE_MUTEX(control_ports_lock);
 static struct list_head local_ports[LP_HASH_SIZE];
 static DEFINE_MUTEX(local_ports_lock);
 
+/*
+ * The packet path looks up local ports, routing table entries and remote
+ * ports inside an ipc_router_srcu read section rather than under
+ * local_ports_lock, routing_table_lock and rt_entry->lock; those mutexes
+ * now only serialise updaters.  Sleepable RCU because a reader goes on to
+ * write to the transport or call a port's notify callback.
+ *
+ * A remote port found this way outlives the read section only through the
+ * reference msm_ipc_router_lookup_remote_port() takes; the routing table
+ * holds one more, dropped a grace period after the port is unlinked.
+ *
+ * Closing a port waits for all readers, so it must not be done from a
+ * notify callback, which runs inside a read section and would wait for
+ * itself; such callers have to defer the close to process context.
+ * ipc_router_assert_not_reader() has lockdep catch it.
+ */
+static struct srcu_struct ipc_router_srcu;
+
+#define ipc_router_assert_not_reader()					\
+	rcu_lockdep_assert(!srcu_read_lock_held(&ipc_router_srcu),	\
+			   "ipc_router port closed from a notify callback")
+
+/* rx queue depth at which packets for a port without notify are dropped */
+static int rx_queue_limit;
+module_param(rx_queue_limit, int, S_IRUGO | S_IWUSR | S_IWGRP);
+
 #define SRV_HASH_SIZE 32
 static struct list_head server_list[SRV_HASH_SIZE];
 static DEFINE_MUTEX(server_list_lock);
@@ -116,6 +145,8 @@ struct msm_ipc_server_port {
 #define RP_HASH_SIZE 32
 struct msm_ipc_router_remote_port {
 	struct list_head list;
+	struct list_head reap;
+	struct kref ref;
 	uint32_t node_id;
 	uint32_t port_id;
 	uint32_t restart_state;
@@ -236,18 +267,21 @@ static int add_routing_table_entry(
 		return -EINVAL;
 
 	key = (rt_entry->node_id % RT_HASH_SIZE);
-	list_add_tail(&rt_entry->list, &routing_table[key]);
+	list_add_tail_rcu(&rt_entry->list, &routing_table[key]);
 	return 0;
 }
 
-/*Please take routing_table_lock before calling this function*/
+/*
+ * Please take routing_table_lock or be in an ipc_router_srcu read section
+ * before calling this function
+ */
 static struct msm_ipc_routing_table_entry *lookup_routing_table(
 	uint32_t node_id)
 {
 	uint32_t key = (node_id % RT_HASH_SIZE);
 	struct msm_ipc_routing_table_entry *rt_entry;
 
-	list_for_each_entry(rt_entry, &routing_table[key], list) {
+	list_for_each_entry_rcu(rt_entry, &routing_table[key], list) {
 		if (rt_entry->node_id == node_id)
 			return rt_entry;
 	}
@@ -362,6 +396,42 @@ void release_pkt(struct rr_packet *pkt)
 	return;
 }
 
+static void update_rx_stats(struct msm_ipc_port *port_ptr, uint32_t len)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&port_ptr->port_lock, flags);
+	port_ptr->num_rx++;
+	port_ptr->num_rx_bytes += len;
+	spin_unlock_irqrestore(&port_ptr->port_lock, flags);
+}
+
+/*
+ * Queue @pkt for a reader of @port_ptr, or drop and release it if the
+ * port's rx queue limit has been reached.  Returns 0 if queued.
+ */
+static int post_pkt_to_port(struct msm_ipc_port *port_ptr,
+			    struct rr_packet *pkt)
+{
+	mutex_lock(&port_ptr->port_rx_q_lock);
+	if (port_ptr->rx_q_limit &&
+	    port_ptr->rx_q_len >= port_ptr->rx_q_limit) {
+		port_ptr->num_rx_dropped++;
+		mutex_unlock(&port_ptr->port_rx_q_lock);
+		RR("port %08x rx queue full, packet dropped\n",
+		   port_ptr->this_port.port_id);
+		release_pkt(pkt);
+		return -EAGAIN;
+	}
+	wake_lock(&port_ptr->port_rx_wake_lock);
+	list_add_tail(&pkt->list, &port_ptr->port_rx_q);
+	port_ptr->rx_q_len++;
+	update_rx_stats(port_ptr, pkt->length);
+	wake_up(&port_ptr->port_rx_wait_q);
+	mutex_unlock(&port_ptr->port_rx_q_lock);
+	return 0;
+}
+
 static int post_control_ports(struct rr_packet *pkt)
 {
 	struct msm_ipc_port *port_ptr;
@@ -376,6 +446,7 @@ static int post_control_ports(struct rr_packet *pkt)
 		cloned_pkt = clone_pkt(pkt);
 		wake_lock(&port_ptr->port_rx_wake_lock);
 		list_add_tail(&cloned_pkt->list, &port_ptr->port_rx_q);
+		port_ptr->rx_q_len++;
 		wake_up(&port_ptr->port_rx_wait_q);
 		mutex_unlock(&port_ptr->port_rx_q_lock);
 	}
@@ -428,7 +499,7 @@ void msm_ipc_router_add_local_port(struct msm_ipc_port *port_ptr)
 
 	key = (port_ptr->this_port.port_id & (LP_HASH_SIZE - 1));
 	mutex_lock(&local_ports_lock);
-	list_add_tail(&port_ptr->list, &local_ports[key]);
+	list_add_tail_rcu(&port_ptr->list, &local_ports[key]);
 	mutex_unlock(&local_ports_lock);
 }
 
@@ -467,20 +538,22 @@ struct msm_ipc_port *msm_ipc_router_create_raw_port(void *endpoint,
 	port_ptr->endpoint = endpoint;
 	port_ptr->notify = notify;
 	port_ptr->priv = priv;
+	port_ptr->rx_q_limit = rx_queue_limit;
 
 	msm_ipc_router_add_local_port(port_ptr);
 	return port_ptr;
 }
 
 /*
- * Should be called with local_ports_lock locked
+ * Should be called with local_ports_lock locked or inside an
+ * ipc_router_srcu read section
  */
 static struct msm_ipc_port *msm_ipc_router_lookup_local_port(uint32_t port_id)
 {
 	int key = (port_id & (LP_HASH_SIZE - 1));
 	struct msm_ipc_port *port_ptr;
 
-	list_for_each_entry(port_ptr, &local_ports[key], list) {
+	list_for_each_entry_rcu(port_ptr, &local_ports[key], list) {
 		if (port_ptr->this_port.port_id == port_id) {
 			return port_ptr;
 		}
@@ -488,6 +561,34 @@ static struct msm_ipc_port *msm_ipc_router_lookup_local_port(uint32_t port_id)
 	return NULL;
 }
 
+static void msm_ipc_router_release_remote_port(struct kref *ref)
+{
+	kfree(container_of(ref, struct msm_ipc_router_remote_port, ref));
+}
+
+static void msm_ipc_router_put_remote_port(
+	struct msm_ipc_router_remote_port *rport_ptr)
+{
+	kref_put(&rport_ptr->ref, msm_ipc_router_release_remote_port);
+}
+
+/*
+ * Unlinked remote ports can't be found any more, so wake anyone sleeping
+ * on their quota rather than leave them waiting for a RESUME_TX.
+ */
+static void msm_ipc_router_abort_remote_port(
+	struct msm_ipc_router_remote_port *rport_ptr)
+{
+	mutex_lock(&rport_ptr->quota_lock);
+	rport_ptr->restart_state = RESTART_PEND;
+	wake_up(&rport_ptr->quota_wait);
+	mutex_unlock(&rport_ptr->quota_lock);
+}
+
+/*
+ * Returns the remote port with a reference held, which the caller drops
+ * with msm_ipc_router_put_remote_port().
+ */
 static struct msm_ipc_router_remote_port *msm_ipc_router_lookup_remote_port(
 						uint32_t node_id,
 						uint32_t port_id)
@@ -495,28 +596,28 @@ static struct msm_ipc_router_remote_port *msm_ipc_router_lookup_remote_port(
 	struct msm_ipc_router_remote_port *rport_ptr;
 	struct msm_ipc_routing_table_entry *rt_entry;
 	int key = (port_id & (RP_HASH_SIZE - 1));
+	int idx;
 
-	mutex_lock(&routing_table_lock);
+	idx = srcu_read_lock(&ipc_router_srcu);
 	rt_entry = lookup_routing_table(node_id);
 	if (!rt_entry) {
-		mutex_unlock(&routing_table_lock);
+		srcu_read_unlock(&ipc_router_srcu, idx);
 		pr_err("%s: Node is not up\n", __func__);
 		return NULL;
 	}
 
-	mutex_lock(&rt_entry->lock);
-	list_for_each_entry(rport_ptr,
+	list_for_each_entry_rcu(rport_ptr,
 			    &rt_entry->remote_port_list[key], list) {
 		if (rport_ptr->port_id == port_id) {
 			if (rport_ptr->restart_state != RESTART_NORMAL)
 				rport_ptr = NULL;
-			mutex_unlock(&rt_entry->lock);
-			mutex_unlock(&routing_table_lock);
+			else
+				kref_get(&rport_ptr->ref);
+			srcu_read_unlock(&ipc_router_srcu, idx);
 			return rport_ptr;
 		}
 	}
-	mutex_unlock(&rt_entry->lock);
-	mutex_unlock(&routing_table_lock);
+	srcu_read_unlock(&ipc_router_srcu, idx);
 	return NULL;
 }
 
@@ -527,21 +628,11 @@ static struct msm_ipc_router_remote_port *msm_ipc_router_create_remote_port(
 	struct msm_ipc_router_remote_port *rport_ptr;
 	struct msm_ipc_routing_table_entry *rt_entry;
 	int key = (port_id & (RP_HASH_SIZE - 1));
+	int idx;
 
-	mutex_lock(&routing_table_lock);
-	rt_entry = lookup_routing_table(node_id);
-	if (!rt_entry) {
-		mutex_unlock(&routing_table_lock);
-		pr_err("%s: Node is not up\n", __func__);
-		return NULL;
-	}
-
-	mutex_lock(&rt_entry->lock);
 	rport_ptr = kmalloc(sizeof(struct msm_ipc_router_remote_port),
 			    GFP_KERNEL);
 	if (!rport_ptr) {
-		mutex_unlock(&rt_entry->lock);
-		mutex_unlock(&routing_table_lock);
 		pr_err("%s: Remote port alloc failed\n", __func__);
 		return NULL;
 	}
@@ -549,12 +640,24 @@ static struct msm_ipc_router_remote_port *msm_ipc_router_create_remote_port(
 	rport_ptr->node_id = node_id;
 	rport_ptr->restart_state = RESTART_NORMAL;
 	rport_ptr->tx_quota_cnt = 0;
+	kref_init(&rport_ptr->ref);
 	init_waitqueue_head(&rport_ptr->quota_wait);
 	mutex_init(&rport_ptr->quota_lock);
-	list_add_tail(&rport_ptr->list,
+
+	idx = srcu_read_lock(&ipc_router_srcu);
+	rt_entry = lookup_routing_table(node_id);
+	if (!rt_entry) {
+		srcu_read_unlock(&ipc_router_srcu, idx);
+		kfree(rport_ptr);
+		pr_err("%s: Node is not up\n", __func__);
+		return NULL;
+	}
+
+	mutex_lock(&rt_entry->lock);
+	list_add_tail_rcu(&rport_ptr->list,
 		      &rt_entry->remote_port_list[key]);
 	mutex_unlock(&rt_entry->lock);
-	mutex_unlock(&routing_table_lock);
+	srcu_read_unlock(&ipc_router_srcu, idx);
 	return rport_ptr;
 }
 
@@ -577,10 +680,12 @@ static void msm_ipc_router_destroy_remote_port(
 	}
 
 	mutex_lock(&rt_entry->lock);
-	list_del(&rport_ptr->list);
-	kfree(rport_ptr);
+	list_del_rcu(&rport_ptr->list);
 	mutex_unlock(&rt_entry->lock);
 	mutex_unlock(&routing_table_lock);
+	msm_ipc_router_abort_remote_port(rport_ptr);
+	synchronize_srcu(&ipc_router_srcu);
+	msm_ipc_router_put_remote_port(rport_ptr);
 	return;
 }
 
@@ -953,6 +1058,7 @@ static int forward_msg(struct msm_ipc_router_xprt_info *xprt_info,
 	struct rr_header *hdr;
 	struct msm_ipc_router_xprt_info *fwd_xprt_info;
 	struct msm_ipc_routing_table_entry *rt_entry;
+	int idx;
 
 	if (!xprt_info || !pkt)
 		return -EINVAL;
@@ -963,36 +1069,31 @@ static int forward_msg(struct msm_ipc_router_xprt_info *xprt_info,
 
 	hdr = (struct rr_header *)head_pkt->data;
 	dst_node_id = hdr->dst_node_id;
-	mutex_lock(&routing_table_lock);
+	idx = srcu_read_lock(&ipc_router_srcu);
 	rt_entry = lookup_routing_table(dst_node_id);
-	if (!(rt_entry) || !(rt_entry->xprt_info)) {
-		mutex_unlock(&routing_table_lock);
+	fwd_xprt_info = rt_entry ? srcu_dereference(rt_entry->xprt_info,
+						    &ipc_router_srcu) : NULL;
+	if (!fwd_xprt_info) {
+		srcu_read_unlock(&ipc_router_srcu, idx);
 		pr_err("%s: Routing table not initialized\n", __func__);
 		return -ENODEV;
 	}
 
-	mutex_lock(&rt_entry->lock);
-	fwd_xprt_info = rt_entry->xprt_info;
-	mutex_lock(&fwd_xprt_info->tx_lock);
 	if (xprt_info->remote_node_id == fwd_xprt_info->remote_node_id) {
-		mutex_unlock(&fwd_xprt_info->tx_lock);
-		mutex_unlock(&rt_entry->lock);
-		mutex_unlock(&routing_table_lock);
+		srcu_read_unlock(&ipc_router_srcu, idx);
 		pr_err("%s: Discarding Command to route back\n", __func__);
 		return -EINVAL;
 	}
 
 	if (xprt_info->xprt->link_id == fwd_xprt_info->xprt->link_id) {
-		mutex_unlock(&fwd_xprt_info->tx_lock);
-		mutex_unlock(&rt_entry->lock);
-		mutex_unlock(&routing_table_lock);
+		srcu_read_unlock(&ipc_router_srcu, idx);
 		pr_err("%s: DST in the same cluster\n", __func__);
 		return 0;
 	}
+	mutex_lock(&fwd_xprt_info->tx_lock);
 	fwd_xprt_info->xprt->write(pkt, pkt->length, fwd_xprt_info->xprt);
 	mutex_unlock(&fwd_xprt_info->tx_lock);
-	mutex_unlock(&rt_entry->lock);
-	mutex_unlock(&routing_table_lock);
+	srcu_read_unlock(&ipc_router_srcu, idx);
 
 	return 0;
 }
@@ -1007,10 +1108,8 @@ static void reset_remote_port_info(uint32_t node_id, uint32_t port_id)
 			__func__, node_id, port_id);
 		return;
 	}
-	mutex_lock(&rport_ptr->quota_lock);
-	rport_ptr->restart_state = RESTART_PEND;
-	wake_up(&rport_ptr->quota_wait);
-	mutex_unlock(&rport_ptr->quota_lock);
+	msm_ipc_router_abort_remote_port(rport_ptr);
+	msm_ipc_router_put_remote_port(rport_ptr);
 	return;
 }
 
@@ -1107,6 +1206,7 @@ static void msm_ipc_cleanup_remote_port_info(uint32_t node_id)
 {
 	struct msm_ipc_routing_table_entry *rt_entry, *tmp_rt_entry;
 	struct msm_ipc_router_remote_port *rport_ptr, *tmp_rport_ptr;
+	LIST_HEAD(reap_list);
 	int i, j;
 
 	mutex_lock(&routing_table_lock);
@@ -1122,14 +1222,23 @@ static void msm_ipc_cleanup_remote_port_info(uint32_t node_id)
 				list_for_each_entry_safe(rport_ptr,
 					tmp_rport_ptr,
 					&rt_entry->remote_port_list[j], list) {
-					list_del(&rport_ptr->list);
-					kfree(rport_ptr);
+					list_del_rcu(&rport_ptr->list);
+					list_add_tail(&rport_ptr->reap,
+						      &reap_list);
 				}
 			}
 			mutex_unlock(&rt_entry->lock);
 		}
 	}
 	mutex_unlock(&routing_table_lock);
+
+	if (list_empty(&reap_list))
+		return;
+	list_for_each_entry(rport_ptr, &reap_list, reap)
+		msm_ipc_router_abort_remote_port(rport_ptr);
+	synchronize_srcu(&ipc_router_srcu);
+	list_for_each_entry_safe(rport_ptr, tmp_rport_ptr, &reap_list, reap)
+		msm_ipc_router_put_remote_port(rport_ptr);
 }
 
 static void msm_ipc_cleanup_routing_table(
@@ -1148,7 +1257,7 @@ static void msm_ipc_cleanup_routing_table(
 		list_for_each_entry(rt_entry, &routing_table[i], list) {
 			mutex_lock(&rt_entry->lock);
 			if (rt_entry->xprt_info == xprt_info)
-				rt_entry->xprt_info = NULL;
+				rcu_assign_pointer(rt_entry->xprt_info, NULL);
 			mutex_unlock(&rt_entry->lock);
 		}
 	}
@@ -1218,7 +1327,7 @@ static int process_control_msg(struct msm_ipc_router_xprt_info *xprt_info,
 		}
 		mutex_lock(&rt_entry->lock);
 		rt_entry->neighbor_node_id = xprt_info->remote_node_id;
-		rt_entry->xprt_info = xprt_info;
+		rcu_assign_pointer(rt_entry->xprt_info, xprt_info);
 		mutex_unlock(&rt_entry->lock);
 		mutex_unlock(&routing_table_lock);
 		msm_ipc_cleanup_remote_port_info(xprt_info->remote_node_id);
@@ -1252,6 +1361,7 @@ static int process_control_msg(struct msm_ipc_router_xprt_info *xprt_info,
 		rport_ptr->tx_quota_cnt = 0;
 		mutex_unlock(&rport_ptr->quota_lock);
 		wake_up(&rport_ptr->quota_wait);
+		msm_ipc_router_put_remote_port(rport_ptr);
 		break;
 
 	case IPC_ROUTER_CTRL_CMD_NEW_SERVER:
@@ -1297,8 +1407,11 @@ static int process_control_msg(struct msm_ipc_router_xprt_info *xprt_info,
 				return -ENOMEM;
 			}
 
-			if (!msm_ipc_router_lookup_remote_port(
-					msg->srv.node_id, msg->srv.port_id)) {
+			rport_ptr = msm_ipc_router_lookup_remote_port(
+					msg->srv.node_id, msg->srv.port_id);
+			if (rport_ptr) {
+				msm_ipc_router_put_remote_port(rport_ptr);
+			} else {
 				rport_ptr = msm_ipc_router_create_remote_port(
 					msg->srv.node_id, msg->srv.port_id);
 				if (!rport_ptr)
@@ -1331,8 +1444,10 @@ static int process_control_msg(struct msm_ipc_router_xprt_info *xprt_info,
 		    msg->cli.node_id, msg->cli.port_id);
 		rport_ptr = msm_ipc_router_lookup_remote_port(msg->cli.node_id,
 							msg->cli.port_id);
-		if (rport_ptr)
+		if (rport_ptr) {
 			msm_ipc_router_destroy_remote_port(rport_ptr);
+			msm_ipc_router_put_remote_port(rport_ptr);
+		}
 
 		relay_msg(xprt_info, pkt);
 		post_control_ports(pkt);
@@ -1358,6 +1473,7 @@ static void do_read_data(struct work_struct *work)
 	struct msm_ipc_port_addr *src_addr;
 	struct msm_ipc_router_remote_port *rport_ptr;
 	uint32_t resume_tx, resume_tx_node_id, resume_tx_port_id;
+	int idx;
 
 	struct msm_ipc_router_xprt_info *xprt_info =
 		container_of(work,
@@ -1434,13 +1550,15 @@ static void do_read_data(struct work_struct *work)
 
 	rport_ptr = msm_ipc_router_lookup_remote_port(hdr->src_node_id,
 						      hdr->src_port_id);
+	if (rport_ptr)
+		msm_ipc_router_put_remote_port(rport_ptr);
 
-	mutex_lock(&local_ports_lock);
+	idx = srcu_read_lock(&ipc_router_srcu);
 	port_ptr = msm_ipc_router_lookup_local_port(hdr->dst_port_id);
 	if (!port_ptr) {
 		pr_err("%s: No local port id %08x\n", __func__,
 			hdr->dst_port_id);
-		mutex_unlock(&local_ports_lock);
+		srcu_read_unlock(&ipc_router_srcu, idx);
 		release_pkt(pkt);
 		goto process_done;
 	}
@@ -1452,18 +1570,14 @@ static void do_read_data(struct work_struct *work)
 		if (!rport_ptr) {
 			pr_err("%s: Remote port %08x:%08x creation failed\n",
 				__func__, hdr->src_node_id, hdr->src_port_id);
-			mutex_unlock(&local_ports_lock);
+			srcu_read_unlock(&ipc_router_srcu, idx);
 			goto process_done;
 		}
 	}
 
 	if (!port_ptr->notify) {
-		mutex_lock(&port_ptr->port_rx_q_lock);
-		wake_lock(&port_ptr->port_rx_wake_lock);
-		list_add_tail(&pkt->list, &port_ptr->port_rx_q);
-		wake_up(&port_ptr->port_rx_wait_q);
-		mutex_unlock(&port_ptr->port_rx_q_lock);
-		mutex_unlock(&local_ports_lock);
+		post_pkt_to_port(port_ptr, pkt);
+		srcu_read_unlock(&ipc_router_srcu, idx);
 	} else {
 		mutex_lock(&port_ptr->port_rx_q_lock);
 		src_addr = kmalloc(sizeof(struct msm_ipc_port_addr),
@@ -1473,10 +1587,11 @@ static void do_read_data(struct work_struct *work)
 			src_addr->port_id = hdr->src_port_id;
 		}
 		skb_pull(head_skb, IPC_ROUTER_HDR_SIZE);
-		mutex_unlock(&local_ports_lock);
+		update_rx_stats(port_ptr, pkt->length);
 		port_ptr->notify(MSM_IPC_ROUTER_READ_CB, pkt->pkt_fragment_q,
 				 src_addr, port_ptr->priv);
 		mutex_unlock(&port_ptr->port_rx_q_lock);
+		srcu_read_unlock(&ipc_router_srcu, idx);
 		pkt->pkt_fragment_q = NULL;
 		src_addr = NULL;
 		release_pkt(pkt);
@@ -1603,6 +1718,7 @@ static int loopback_data(struct msm_ipc_port *src,
 	struct rr_header *hdr;
 	struct msm_ipc_port *port_ptr;
 	struct rr_packet *pkt;
+	int idx, ret;
 
 	if (!data) {
 		pr_err("%s: Invalid pkt pointer\n", __func__);
@@ -1636,23 +1752,21 @@ static int loopback_data(struct msm_ipc_port *src,
 	hdr->dst_port_id = port_id;
 	pkt->length += IPC_ROUTER_HDR_SIZE;
 
-	mutex_lock(&local_ports_lock);
+	idx = srcu_read_lock(&ipc_router_srcu);
 	port_ptr = msm_ipc_router_lookup_local_port(port_id);
 	if (!port_ptr) {
 		pr_err("%s: Local port %d not present\n", __func__, port_id);
-		mutex_unlock(&local_ports_lock);
+		srcu_read_unlock(&ipc_router_srcu, idx);
 		release_pkt(pkt);
 		return -ENODEV;
 	}
 
-	mutex_lock(&port_ptr->port_rx_q_lock);
-	wake_lock(&port_ptr->port_rx_wake_lock);
-	list_add_tail(&pkt->list, &port_ptr->port_rx_q);
-	wake_up(&port_ptr->port_rx_wait_q);
-	mutex_unlock(&port_ptr->port_rx_q_lock);
-	mutex_unlock(&local_ports_lock);
+	ret = pkt->length;
+	if (post_pkt_to_port(port_ptr, pkt))
+		ret = -EAGAIN;
+	srcu_read_unlock(&ipc_router_srcu, idx);
 
-	return pkt->length;
+	return ret;
 }
 
 static int msm_ipc_router_write_pkt(struct msm_ipc_port *src,
@@ -1663,7 +1777,8 @@ static int msm_ipc_router_write_pkt(struct msm_ipc_port *src,
 	struct rr_header *hdr;
 	struct msm_ipc_router_xprt_info *xprt_info;
 	struct msm_ipc_routing_table_entry *rt_entry;
-	int ret;
+	unsigned long flags;
+	int ret, idx;
 	DEFINE_WAIT(__wait);
 
 	if (!rport_ptr || !src || !pkt)
@@ -1718,27 +1833,31 @@ static int msm_ipc_router_write_pkt(struct msm_ipc_port *src,
 		hdr->confirm_rx = 1;
 	mutex_unlock(&rport_ptr->quota_lock);
 
-	mutex_lock(&routing_table_lock);
+	idx = srcu_read_lock(&ipc_router_srcu);
 	rt_entry = lookup_routing_table(hdr->dst_node_id);
-	if (!rt_entry || !rt_entry->xprt_info) {
-		mutex_unlock(&routing_table_lock);
+	xprt_info = rt_entry ? srcu_dereference(rt_entry->xprt_info,
+						&ipc_router_srcu) : NULL;
+	if (!xprt_info) {
+		srcu_read_unlock(&ipc_router_srcu, idx);
 		pr_err("%s: Remote node %d not up\n",
 			__func__, hdr->dst_node_id);
 		return -ENODEV;
 	}
-	mutex_lock(&rt_entry->lock);
-	xprt_info = rt_entry->xprt_info;
 	mutex_lock(&xprt_info->tx_lock);
 	ret = xprt_info->xprt->write(pkt, pkt->length, xprt_info->xprt);
 	mutex_unlock(&xprt_info->tx_lock);
-	mutex_unlock(&rt_entry->lock);
-	mutex_unlock(&routing_table_lock);
+	srcu_read_unlock(&ipc_router_srcu, idx);
 
 	if (ret < 0) {
 		pr_err("%s: Write on XPRT failed\n", __func__);
 		return ret;
 	}
 
+	spin_lock_irqsave(&src->port_lock, flags);
+	src->num_tx++;
+	src->num_tx_bytes += pkt->length;
+	spin_unlock_irqrestore(&src->port_lock, flags);
+
 	RAW_HDR("[w rr_h] "
 		"ver=%i,type=%s,src_nid=%08x,src_port_id=%08x,"
 		"confirm_rx=%i,size=%3i,dst_pid=%08x,dst_cid=%08x\n",
@@ -1818,11 +1937,13 @@ int msm_ipc_router_send_to(struct msm_ipc_port *src,
 
 	pkt = create_pkt(data);
 	if (!pkt) {
+		msm_ipc_router_put_remote_port(rport_ptr);
 		pr_err("%s: Pkt creation failed\n", __func__);
 		return -ENOMEM;
 	}
 
 	ret = msm_ipc_router_write_pkt(src, rport_ptr, pkt);
+	msm_ipc_router_put_remote_port(rport_ptr);
 	release_pkt(pkt);
 
 	return ret;
@@ -1850,6 +1971,7 @@ int msm_ipc_router_read(struct msm_ipc_port *port_ptr,
 		return -ETOOSMALL;
 	}
 	list_del(&pkt->list);
+	port_ptr->rx_q_len--;
 	if (list_empty(&port_ptr->port_rx_q))
 		wake_unlock(&port_ptr->port_rx_wake_lock);
 	*data = pkt->pkt_fragment_q;
@@ -1933,6 +2055,10 @@ struct msm_ipc_port *msm_ipc_router_create_port(
 	return port_ptr;
 }
 
+/*
+ * Must not be called from a port's notify callback, see ipc_router_srcu.
+ * Once it returns, no notify callback of the port is running any more.
+ */
 int msm_ipc_router_close_port(struct msm_ipc_port *port_ptr)
 {
 	union rr_control_msg msg;
@@ -1942,10 +2068,14 @@ int msm_ipc_router_close_port(struct msm_ipc_port *port_ptr)
 	if (!port_ptr)
 		return -EINVAL;
 
+	ipc_router_assert_not_reader();
+
 	if (port_ptr->type == SERVER_PORT || port_ptr->type == CLIENT_PORT) {
 		mutex_lock(&local_ports_lock);
-		list_del(&port_ptr->list);
+		list_del_rcu(&port_ptr->list);
 		mutex_unlock(&local_ports_lock);
+		/* no packet path reader can still be delivering to it */
+		synchronize_srcu(&ipc_router_srcu);
 
 		if (port_ptr->type == SERVER_PORT) {
 			msg.cmd = IPC_ROUTER_CTRL_CMD_REMOVE_SERVER;
@@ -2019,9 +2149,12 @@ int msm_ipc_router_bind_control_port(struct msm_ipc_port *port_ptr)
 	if (!port_ptr)
 		return -EINVAL;
 
+	ipc_router_assert_not_reader();
+
 	mutex_lock(&local_ports_lock);
-	list_del(&port_ptr->list);
+	list_del_rcu(&port_ptr->list);
 	mutex_unlock(&local_ports_lock);
+	synchronize_srcu(&ipc_router_srcu);
 	port_ptr->type = CONTROL_PORT;
 	mutex_lock(&control_ports_lock);
 	list_add_tail(&port_ptr->list, &control_ports);
@@ -2257,6 +2390,10 @@ static int dump_local_ports(char *buf, int max)
 			i += scnprintf(buf + i, max - i, "# bytes rx'd %ld\n",
 				       port_ptr->num_rx_bytes);
 			spin_unlock_irqrestore(&port_ptr->port_lock, flags);
+			i += scnprintf(buf + i, max - i, "# pkts queued %d\n",
+				       port_ptr->rx_q_len);
+			i += scnprintf(buf + i, max - i, "# pkts dropped %d\n",
+				       port_ptr->num_rx_dropped);
 			i += scnprintf(buf + i, max - i, "\n");
 		}
 	}
@@ -2394,6 +2531,8 @@ static void msm_ipc_router_remove_xprt(struct msm_ipc_router_xprt *xprt)
 		wake_lock_destroy(&xprt_info->wakelock);
 
 		xprt->priv = 0;
+		/* senders may still hold it from the routing table */
+		synchronize_srcu(&ipc_router_srcu);
 		kfree(xprt_info);
 	}
 }
@@ -2530,6 +2669,9 @@ static int __init msm_ipc_router_init(void)
 	struct msm_ipc_routing_table_entry *rt_entry;
 
 	msm_ipc_router_debug_mask |= SMEM_LOG;
+	ret = init_srcu_struct(&ipc_router_srcu);
+	if (ret)
+		return ret;
 	msm_ipc_router_workqueue =
 		create_singlethread_workqueue("msm_ipc_router");
 	if (!msm_ipc_router_workqueue)
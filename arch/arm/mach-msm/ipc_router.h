@@ -117,6 +117,8 @@ struct msm_ipc_port {
 
 	struct list_head port_rx_q;
 	struct mutex port_rx_q_lock;
+	uint32_t rx_q_len;
+	uint32_t rx_q_limit;
 	char rx_wakelock_name[MAX_WAKELOCK_NAME_SZ];
 	struct wake_lock port_rx_wake_lock;
 	wait_queue_head_t port_rx_wait_q;
@@ -132,6 +134,7 @@ struct msm_ipc_port {
 	uint32_t num_rx;
 	unsigned long num_tx_bytes;
 	unsigned long num_rx_bytes;
+	uint32_t num_rx_dropped;
 	void *priv;
 };
 
@@ -188,6 +191,7 @@ int msm_ipc_router_lookup_server_name(struct msm_ipc_port_name *srv_name,
 				      struct msm_ipc_server_info *srv_info,
 				      int num_entries_in_array,
 				      uint32_t lookup_mask);
+/* not from a notify callback: it waits for running callbacks to return */
 int msm_ipc_router_close_port(struct msm_ipc_port *port_ptr);
 
 struct msm_ipc_port *msm_ipc_router_create_port(
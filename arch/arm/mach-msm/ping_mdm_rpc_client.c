@@ -72,6 +72,21 @@ struct ping_mdm_register_data_cb_cb_ret {
 	uint32_t result;
 };
 
+static const struct msm_rpc_xdr_field ping_mdm_register_cb_fields[] = {
+	XDR_FIELD(UINT32, struct ping_mdm_register_cb_arg, cb_id),
+	XDR_FIELD(INT32, struct ping_mdm_register_cb_arg, val),
+};
+static DEFINE_XDR_LAYOUT(ping_mdm_register_cb_layout,
+			 ping_mdm_register_cb_fields);
+
+/* fields following the data array */
+static const struct msm_rpc_xdr_field ping_mdm_data_cb_tail_fields[] = {
+	XDR_FIELD(UINT32, struct ping_mdm_register_data_cb_cb_arg, size),
+	XDR_FIELD(UINT32, struct ping_mdm_register_data_cb_cb_arg, sum),
+};
+static DEFINE_XDR_LAYOUT(ping_mdm_data_cb_tail_layout,
+			 ping_mdm_data_cb_tail_fields);
+
 static struct dentry *dent;
 static uint32_t test_res;
 static int reg_cb_num, reg_cb_num_req;
@@ -98,8 +113,7 @@ static int ping_mdm_register_cb(struct msm_rpc_client *client,
 	struct ping_mdm_register_cb_arg arg;
 	void *cb_func;
 
-	xdr_recv_uint32(xdr, &arg.cb_id);             /* cb_id */
-	xdr_recv_int32(xdr, &arg.val);                /* val */
+	xdr_recv_layout(xdr, &ping_mdm_register_cb_layout, &arg);
 
 	cb_func = msm_rpc_get_cb_func(client, arg.cb_id);
 	if (cb_func) {
@@ -135,8 +149,7 @@ static int ping_mdm_data_cb(struct msm_rpc_client *client,
 	xdr_recv_array(xdr, (void **)(&(arg.data)), &size, 64,
 		       sizeof(uint32_t), (void *)xdr_recv_uint32);
 
-	xdr_recv_uint32(xdr, &arg.size);           /* size */
-	xdr_recv_uint32(xdr, &arg.sum);            /* sum */
+	xdr_recv_layout(xdr, &ping_mdm_data_cb_tail_layout, &arg);
 
 	cb_func = msm_rpc_get_cb_func(client, arg.cb_id);
 	if (cb_func) {
@@ -0,0 +1,220 @@
+/* Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+/*
+ * RPC router loopback test.  Registers an APPS server and calls it from
+ * an APPS client over the local loopback transport, so the whole router
+ * path (XDR encode, routing, reply matching, XDR decode) is exercised
+ * without the modem.  Reading debugfs "rpc_loopback_test" checks that
+ * the echo procedure returns its arguments intact and prints the mean
+ * round-trip time of the null and echo procedures.
+ */
+
+#include <linux/types.h>
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/debugfs.h>
+#include <linux/fs.h>
+#include <linux/mutex.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/err.h>
+#include <mach/msm_rpcrouter.h>
+
+#define LOOPBACK_TEST_PROG	0x30000fff
+#define LOOPBACK_TEST_VERS	0x00010001
+
+#define LOOPBACK_TEST_NULL_PROC	0
+#define LOOPBACK_TEST_ECHO_PROC	1
+
+static unsigned int iterations = 1000;
+module_param(iterations, uint, 0644);
+
+struct loopback_echo {
+	uint32_t a;
+	int32_t b;
+	uint16_t c;
+	int16_t d;
+	uint8_t e;
+	int8_t f;
+};
+
+static const struct msm_rpc_xdr_field loopback_echo_fields[] = {
+	XDR_FIELD(UINT32, struct loopback_echo, a),
+	XDR_FIELD(INT32, struct loopback_echo, b),
+	XDR_FIELD(UINT16, struct loopback_echo, c),
+	XDR_FIELD(INT16, struct loopback_echo, d),
+	XDR_FIELD(UINT8, struct loopback_echo, e),
+	XDR_FIELD(INT8, struct loopback_echo, f),
+};
+static DEFINE_XDR_LAYOUT(loopback_echo_layout, loopback_echo_fields);
+
+static struct dentry *dent;
+static struct msm_rpc_client *rpc_client;
+static DEFINE_MUTEX(loopback_test_lock);
+
+static int loopback_test_echo(struct msm_rpc_server *server,
+			      struct msm_rpc_xdr *xdr)
+{
+	struct loopback_echo arg;
+	int rc;
+
+	if (xdr_recv_layout(xdr, &loopback_echo_layout, &arg))
+		return -EINVAL;
+
+	xdr_start_accepted_reply(xdr, RPC_ACCEPTSTAT_SUCCESS);
+	xdr_send_layout(xdr, &loopback_echo_layout, &arg);
+	rc = xdr_send_msg(xdr);
+	if (rc < 0)
+		pr_err("%s: sending reply failed: %d\n", __func__, rc);
+	else
+		rc = 1;
+
+	return rc;
+}
+
+static int loopback_test_call(struct msm_rpc_server *server,
+			      struct rpc_request_hdr *req,
+			      struct msm_rpc_xdr *xdr)
+{
+	switch (req->procedure) {
+	case LOOPBACK_TEST_NULL_PROC:
+		return 0;
+	case LOOPBACK_TEST_ECHO_PROC:
+		return loopback_test_echo(server, xdr);
+	default:
+		return -ENODEV;
+	}
+}
+
+static struct msm_rpc_server rpc_server = {
+	.prog = LOOPBACK_TEST_PROG,
+	.vers = LOOPBACK_TEST_VERS,
+	.rpc_call2 = loopback_test_call,
+};
+
+static int loopback_echo_arg(struct msm_rpc_client *client,
+			     struct msm_rpc_xdr *xdr, void *data)
+{
+	return xdr_send_layout(xdr, &loopback_echo_layout, data);
+}
+
+static int loopback_echo_ret(struct msm_rpc_client *client,
+			     struct msm_rpc_xdr *xdr, void *data)
+{
+	return xdr_recv_layout(xdr, &loopback_echo_layout, data);
+}
+
+static int loopback_test_echo_one(unsigned int n)
+{
+	struct loopback_echo arg, ret;
+	int rc;
+
+	arg.a = 0x80000000 | n;
+	arg.b = -(int32_t)n;
+	arg.c = 0xfff0 | (n & 0xf);
+	arg.d = -(int16_t)(n & 0x7fff);
+	arg.e = n;
+	arg.f = -(int8_t)(n & 0x7f);
+	memset(&ret, 0, sizeof(ret));
+
+	rc = msm_rpc_client_req2(rpc_client, LOOPBACK_TEST_ECHO_PROC,
+				 loopback_echo_arg, &arg,
+				 loopback_echo_ret, &ret, -1);
+	if (rc)
+		return rc;
+
+	if (ret.a != arg.a || ret.b != arg.b || ret.c != arg.c ||
+	    ret.d != arg.d || ret.e != arg.e || ret.f != arg.f) {
+		pr_err("%s: echo %u mismatch\n", __func__, n);
+		return -EIO;
+	}
+	return 0;
+}
+
+static int loopback_test_run(char *buf, int max)
+{
+	ktime_t start;
+	s64 null_ns, echo_ns;
+	unsigned int i, n = max_t(unsigned int, iterations, 1);
+	int rc = 0;
+
+	if (!rpc_client) {
+		rpc_client = msm_rpc_register_client2("rpcloopback",
+						      LOOPBACK_TEST_PROG,
+						      LOOPBACK_TEST_VERS,
+						      0, NULL);
+		if (IS_ERR(rpc_client)) {
+			rc = PTR_ERR(rpc_client);
+			rpc_client = NULL;
+			return scnprintf(buf, max, "client: %d\n", rc);
+		}
+	}
+
+	start = ktime_get();
+	for (i = 0; i < n && !rc; i++)
+		rc = msm_rpc_client_req2(rpc_client, LOOPBACK_TEST_NULL_PROC,
+					 NULL, NULL, NULL, NULL, -1);
+	null_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	if (rc)
+		return scnprintf(buf, max, "null call %u: %d\n", i, rc);
+
+	start = ktime_get();
+	for (i = 0; i < n && !rc; i++)
+		rc = loopback_test_echo_one(i);
+	echo_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	if (rc)
+		return scnprintf(buf, max, "echo call %u: %d\n", i, rc);
+
+	return scnprintf(buf, max, "%u calls: null %lld ns, echo %lld ns\n",
+			 n, div_s64(null_ns, n), div_s64(echo_ns, n));
+}
+
+static ssize_t loopback_test_read(struct file *fp, char __user *ubuf,
+				  size_t count, loff_t *ppos)
+{
+	char buf[128];
+	int len;
+
+	if (*ppos)
+		return 0;
+
+	mutex_lock(&loopback_test_lock);
+	len = loopback_test_run(buf, sizeof(buf));
+	mutex_unlock(&loopback_test_lock);
+
+	return simple_read_from_buffer(ubuf, count, ppos, buf, len);
+}
+
+static const struct file_operations loopback_test_ops = {
+	.read = loopback_test_read,
+};
+
+static int __init rpcrouter_loopback_test_init(void)
+{
+	int rc;
+
+	rc = msm_rpc_create_server2(&rpc_server);
+	if (rc) {
+		pr_err("%s: server create failed: %d\n", __func__, rc);
+		return rc;
+	}
+
+	dent = debugfs_create_file("rpc_loopback_test", 0444, NULL,
+				   NULL, &loopback_test_ops);
+	if (IS_ERR(dent))
+		dent = NULL;
+	return 0;
+}
+
+late_initcall(rpcrouter_loopback_test_init);
@@ -670,7 +670,10 @@ EXPORT_SYMBOL(smsm_check_for_modem_crash);
 
 /* the spinlock is used to synchronize between the
  * irq handler and code that mutates the channel
- * list or fiddles with channel state
+ * list or fiddles with channel state.  The FIFO
+ * data path uses the per channel rx_lock/tx_lock,
+ * which nest inside smd_lock and never the other
+ * way around.
  */
 static DEFINE_SPINLOCK(smd_lock);
 DEFINE_SPINLOCK(smem_lock);
@@ -1156,6 +1159,7 @@ static int ch_read(struct smd_channel *ch, void *_data, int len, int user_buf)
 		ch_read_done(ch, n);
 	}
 
+	ch->stats.rx_bytes += orig_len - len;
 	return orig_len - len;
 }
 
@@ -1280,8 +1284,12 @@ static void smd_state_change(struct smd_channel *ch,
 	case SMD_SS_CLOSED:
 		if (ch->half_ch->get_state(ch->send) == SMD_SS_OPENED) {
 			ch_set_state(ch, SMD_SS_CLOSING);
-			ch->current_packet = 0;
+			spin_lock(&ch->tx_lock);
 			ch->pending_pkt_sz = 0;
+			spin_unlock(&ch->tx_lock);
+			spin_lock(&ch->rx_lock);
+			ch->current_packet = 0;
+			spin_unlock(&ch->rx_lock);
 			ch->notify(ch->priv, SMD_EVENT_CLOSE);
 		}
 		break;
@@ -1341,6 +1349,8 @@ static void handle_smd_irq(struct list_head *list,
 				ch_flags |= 4;
 			}
 		}
+		if (ch_flags)
+			ch->stats.rx_intr++;
 		tmp = ch->half_ch->get_state(ch->recv);
 		if (tmp != ch->last_state) {
 			SMx_POWER_INFO("SMD ch%d '%s' State change %d->%d\n",
@@ -1349,7 +1359,9 @@ static void handle_smd_irq(struct list_head *list,
 			state_change = 1;
 		}
 		if (ch_flags & 0x3) {
+			spin_lock(&ch->rx_lock);
 			ch->update_state(ch);
+			spin_unlock(&ch->rx_lock);
 			SMx_POWER_INFO(
 				"SMD ch%d '%s' Data event 0x%x tx%d/rx%d %dr/%dw : %dr/%dw\n",
 				ch->n, ch->name,
@@ -1526,7 +1538,80 @@ static int smd_is_packet(struct smd_alloc_elm *alloc_elm)
 		return 0;
 }
 
-static int smd_stream_write(smd_channel_t *ch, const void *_data, int len,
+static void smd_signal_other_cpu(smd_channel_t *ch)
+{
+	ch->stats.tx_intr++;
+	ch->notify_other_cpu(ch);
+}
+
+/* signal the remote if anything was written since it was last told */
+static void smd_tx_flush(smd_channel_t *ch)
+{
+	if (atomic_xchg(&ch->tx_unsignalled, 0))
+		smd_signal_other_cpu(ch);
+}
+
+static enum hrtimer_restart smd_coalesce_timer_fn(struct hrtimer *timer)
+{
+	struct smd_channel *ch = container_of(timer, struct smd_channel,
+					      coalesce_timer);
+
+	smd_tx_flush(ch);
+	return HRTIMER_NORESTART;
+}
+
+/*
+ * @n bytes are complete in the FIFO: either interrupt the remote now or,
+ * with coalescing on, once coalesce_bytes have built up or coalesce_usecs
+ * have passed.  A write that found the FIFO full always signals, as the
+ * remote has to drain it before the writer can make progress.
+ */
+static void smd_tx_notify(smd_channel_t *ch, unsigned n, int fifo_full)
+{
+	if (!ch->coalesce_bytes) {
+		atomic_set(&ch->tx_unsignalled, 0);
+		smd_signal_other_cpu(ch);
+		return;
+	}
+
+	if (atomic_add_return(n, &ch->tx_unsignalled) >= ch->coalesce_bytes ||
+			fifo_full) {
+		hrtimer_try_to_cancel(&ch->coalesce_timer);
+		smd_tx_flush(ch);
+	} else if (!hrtimer_is_queued(&ch->coalesce_timer)) {
+		/*
+		 * Not hrtimer_active(): that is also true while the callback
+		 * runs, and bytes added after its flush would then wait for
+		 * the next write.  Restarting a running timer is fine.
+		 */
+		hrtimer_start(&ch->coalesce_timer,
+			ns_to_ktime((u64)ch->coalesce_usecs * NSEC_PER_USEC),
+			HRTIMER_MODE_REL);
+	}
+}
+
+/*
+ * Writers copying from kernel buffers may run from the notify callback or
+ * other atomic context and are serialised by the channel's tx_lock.  Copies
+ * from user space can fault, so those are left to the caller to serialise
+ * as they always were.
+ */
+static inline void smd_tx_lock(smd_channel_t *ch, int user_buf,
+			       unsigned long *flags)
+{
+	if (!user_buf)
+		spin_lock_irqsave(&ch->tx_lock, *flags);
+}
+
+static inline void smd_tx_unlock(smd_channel_t *ch, int user_buf,
+				 unsigned long flags)
+{
+	if (!user_buf)
+		spin_unlock_irqrestore(&ch->tx_lock, flags);
+}
+
+/* copy into the FIFO without signalling the remote */
+static int __smd_stream_write(smd_channel_t *ch, const void *_data, int len,
 				int user_buf)
 {
 	void *ptr;
@@ -1535,7 +1620,6 @@ static int smd_stream_write(smd_channel_t *ch, const void *_data, int len,
 	int orig_len = len;
 	int r = 0;
 
-	SMD_DBG("smd_stream_write() %d -> ch%d\n", len, ch->n);
 	if (len < 0)
 		return -EINVAL;
 	else if (len == 0)
@@ -1566,15 +1650,31 @@ static int smd_stream_write(smd_channel_t *ch, const void *_data, int len,
 			break;
 	}
 
-	if (orig_len - len)
-		ch->notify_other_cpu(ch);
-
+	ch->stats.tx_bytes += orig_len - len;
 	return orig_len - len;
 }
 
+static int smd_stream_write(smd_channel_t *ch, const void *_data, int len,
+				int user_buf)
+{
+	unsigned long flags;
+	int r;
+
+	SMD_DBG("smd_stream_write() %d -> ch%d\n", len, ch->n);
+	smd_tx_lock(ch, user_buf, &flags);
+	r = __smd_stream_write(ch, _data, len, user_buf);
+	smd_tx_unlock(ch, user_buf, flags);
+	/* outside tx_lock: the loopback "interrupt" takes smd_lock */
+	if (r > 0)
+		smd_tx_notify(ch, r, r < len);
+
+	return r;
+}
+
 static int smd_packet_write(smd_channel_t *ch, const void *_data, int len,
 				int user_buf)
 {
+	unsigned long flags;
 	int ret;
 	unsigned hdr[5];
 
@@ -1584,28 +1684,38 @@ static int smd_packet_write(smd_channel_t *ch, const void *_data, int len,
 	else if (len == 0)
 		return 0;
 
-	if (smd_stream_write_avail(ch) < (len + SMD_HEADER_SIZE))
+	smd_tx_lock(ch, user_buf, &flags);
+	if (smd_stream_write_avail(ch) < (len + SMD_HEADER_SIZE)) {
+		smd_tx_unlock(ch, user_buf, flags);
 		return -ENOMEM;
+	}
 
 	hdr[0] = len;
 	hdr[1] = hdr[2] = hdr[3] = hdr[4] = 0;
 
 
-	ret = smd_stream_write(ch, hdr, sizeof(hdr), 0);
+	ret = __smd_stream_write(ch, hdr, sizeof(hdr), 0);
 	if (ret < 0 || ret != sizeof(hdr)) {
+		smd_tx_unlock(ch, user_buf, flags);
 		SMD_DBG("%s failed to write pkt header: "
 			"%d returned\n", __func__, ret);
+		if (ret > 0)
+			smd_tx_notify(ch, ret, 1);
 		return -1;
 	}
 
 
-	ret = smd_stream_write(ch, _data, len, user_buf);
+	ret = __smd_stream_write(ch, _data, len, user_buf);
+	smd_tx_unlock(ch, user_buf, flags);
 	if (ret < 0 || ret != len) {
 		SMD_DBG("%s failed to write pkt data: "
 			"%d returned\n", __func__, ret);
+		smd_tx_notify(ch, sizeof(hdr) + max(ret, 0), 1);
 		return ret;
 	}
 
+	/* one interrupt per packet at most, never in the middle of one */
+	smd_tx_notify(ch, sizeof(hdr) + len, 0);
 	return len;
 }
 
@@ -1619,7 +1729,7 @@ static int smd_stream_read(smd_channel_t *ch, void *data, int len, int user_buf)
 	r = ch_read(ch, data, len, user_buf);
 	if (r > 0)
 		if (!read_intr_blocked(ch))
-			ch->notify_other_cpu(ch);
+			smd_signal_other_cpu(ch);
 
 	return r;
 }
@@ -1638,12 +1748,12 @@ static int smd_packet_read(smd_channel_t *ch, void *data, int len, int user_buf)
 	r = ch_read(ch, data, len, user_buf);
 	if (r > 0)
 		if (!read_intr_blocked(ch))
-			ch->notify_other_cpu(ch);
+			smd_signal_other_cpu(ch);
 
-	spin_lock_irqsave(&smd_lock, flags);
+	spin_lock_irqsave(&ch->rx_lock, flags);
 	ch->current_packet -= r;
 	update_packet_state(ch);
-	spin_unlock_irqrestore(&smd_lock, flags);
+	spin_unlock_irqrestore(&ch->rx_lock, flags);
 
 	return r;
 }
@@ -1662,10 +1772,13 @@ static int smd_packet_read_from_cb(smd_channel_t *ch, void *data, int len,
 	r = ch_read(ch, data, len, user_buf);
 	if (r > 0)
 		if (!read_intr_blocked(ch))
-			ch->notify_other_cpu(ch);
+			smd_signal_other_cpu(ch);
 
+	/* smd_lock is held by the caller, rx_lock nests inside it */
+	spin_lock(&ch->rx_lock);
 	ch->current_packet -= r;
 	update_packet_state(ch);
+	spin_unlock(&ch->rx_lock);
 
 	return r;
 }
@@ -1748,6 +1861,15 @@ static int smd_alloc_v1(struct smd_channel *ch)
 
 #endif
 
+/* one lockdep class for every channel's data path locks */
+static void smd_init_ch_locks(struct smd_channel *ch)
+{
+	spin_lock_init(&ch->rx_lock);
+	spin_lock_init(&ch->tx_lock);
+	hrtimer_init(&ch->coalesce_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	ch->coalesce_timer.function = smd_coalesce_timer_fn;
+}
+
 static int smd_alloc_channel(struct smd_alloc_elm *alloc_elm)
 {
 	struct smd_channel *ch;
@@ -1766,6 +1888,7 @@ static int smd_alloc_channel(struct smd_alloc_elm *alloc_elm)
 	}
 
 	ch->fifo_mask = ch->fifo_size - 1;
+	smd_init_ch_locks(ch);
 
 	/* probe_worker guarentees ch->type will be a valid type */
 	if (ch->type == SMD_APPS_MODEM)
@@ -1854,6 +1977,7 @@ static int smd_alloc_loopback_channel(void)
 	ch->fifo_mask = ch->fifo_size - 1;
 	ch->type = SMD_LOOPBACK_TYPE;
 	ch->notify_other_cpu = notify_loopback_smd;
+	smd_init_ch_locks(ch);
 
 	ch->read = smd_stream_read;
 	ch->write = smd_stream_write;
@@ -2025,6 +2149,11 @@ int smd_close(smd_channel_t *ch)
 
 	SMD_INFO("smd_close(%s)\n", ch->name);
 
+	/* the timer may take smd_lock (loopback), so stop it first */
+	hrtimer_cancel(&ch->coalesce_timer);
+	smd_tx_flush(ch);
+	ch->coalesce_bytes = 0;
+
 	spin_lock_irqsave(&smd_lock, flags);
 	list_del(&ch->ch_list);
 	if (ch->n == SMD_LOOPBACK_CID) {
@@ -2052,6 +2181,7 @@ EXPORT_SYMBOL(smd_close);
 
 int smd_write_start(smd_channel_t *ch, int len)
 {
+	unsigned long flags;
 	int ret;
 	unsigned hdr[5];
 
@@ -2068,7 +2198,9 @@ int smd_write_start(smd_channel_t *ch, int len)
 		return -EINVAL;
 	}
 
+	spin_lock_irqsave(&ch->tx_lock, flags);
 	if (ch->pending_pkt_sz) {
+		spin_unlock_irqrestore(&ch->tx_lock, flags);
 		pr_err("%s: packet of size: %d in progress\n", __func__,
 			ch->pending_pkt_sz);
 		return -EBUSY;
@@ -2077,6 +2209,7 @@ int smd_write_start(smd_channel_t *ch, int len)
 
 	if (smd_stream_write_avail(ch) < (SMD_HEADER_SIZE)) {
 		ch->pending_pkt_sz = 0;
+		spin_unlock_irqrestore(&ch->tx_lock, flags);
 		SMD_DBG("%s: no space to write packet header\n", __func__);
 		return -EAGAIN;
 	}
@@ -2085,18 +2218,22 @@ int smd_write_start(smd_channel_t *ch, int len)
 	hdr[1] = hdr[2] = hdr[3] = hdr[4] = 0;
 
 
-	ret = smd_stream_write(ch, hdr, sizeof(hdr), 0);
+	ret = __smd_stream_write(ch, hdr, sizeof(hdr), 0);
 	if (ret < 0 || ret != sizeof(hdr)) {
 		ch->pending_pkt_sz = 0;
+		spin_unlock_irqrestore(&ch->tx_lock, flags);
 		pr_err("%s: packet header failed to write\n", __func__);
 		return -EPERM;
 	}
+	spin_unlock_irqrestore(&ch->tx_lock, flags);
+	atomic_add(sizeof(hdr), &ch->tx_unsignalled);
 	return 0;
 }
 EXPORT_SYMBOL(smd_write_start);
 
 int smd_write_segment(smd_channel_t *ch, void *data, int len, int user_buf)
 {
+	unsigned long flags;
 	int bytes_written;
 
 	if (!ch) {
@@ -2118,9 +2255,19 @@ int smd_write_segment(smd_channel_t *ch, void *data, int len, int user_buf)
 		return -EINVAL;
 	}
 
-	bytes_written = smd_stream_write(ch, data, len, user_buf);
-
+	smd_tx_lock(ch, user_buf, &flags);
+	bytes_written = __smd_stream_write(ch, data, len, user_buf);
 	ch->pending_pkt_sz -= bytes_written;
+	smd_tx_unlock(ch, user_buf, flags);
+
+	/*
+	 * The remote only sees the packet once smd_write_end() flushes it,
+	 * unless the FIFO filled up and it has to start draining early.
+	 */
+	if (bytes_written < len)
+		smd_tx_notify(ch, bytes_written, 1);
+	else
+		atomic_add(bytes_written, &ch->tx_unsignalled);
 
 	return bytes_written;
 }
@@ -2138,6 +2285,7 @@ int smd_write_end(smd_channel_t *ch)
 		return -E2BIG;
 	}
 
+	smd_tx_notify(ch, 0, 0);
 	return 0;
 }
 EXPORT_SYMBOL(smd_write_end);
@@ -2176,6 +2324,75 @@ int smd_read(smd_channel_t *ch, void *data, int len)
 }
 EXPORT_SYMBOL(smd_read);
 
+int smd_read_packets(smd_channel_t *ch, void *data, int len, int *sizes,
+		     int max_pkts)
+{
+	unsigned long flags;
+	unsigned char *buf = data;
+	int n = 0, total = 0;
+	int r;
+
+	if (!ch) {
+		pr_err("%s: Invalid channel specified\n", __func__);
+		return -ENODEV;
+	}
+	if (!ch->is_pkt_ch || len < 0 || max_pkts < 1 || !sizes)
+		return -EINVAL;
+
+	spin_lock_irqsave(&ch->rx_lock, flags);
+	update_packet_state(ch);
+	while (n < max_pkts && ch->current_packet &&
+			ch->current_packet <= len - total &&
+			smd_stream_read_avail(ch) >= ch->current_packet) {
+		r = ch_read(ch, buf + total, ch->current_packet, 0);
+		sizes[n++] = r;
+		total += r;
+		ch->current_packet -= r;
+		update_packet_state(ch);
+	}
+	spin_unlock_irqrestore(&ch->rx_lock, flags);
+
+	if (total && !read_intr_blocked(ch))
+		smd_signal_other_cpu(ch);
+
+	return n;
+}
+EXPORT_SYMBOL(smd_read_packets);
+
+int smd_set_coalesce(smd_channel_t *ch, unsigned bytes, unsigned usecs)
+{
+	if (!ch) {
+		pr_err("%s: Invalid channel specified\n", __func__);
+		return -ENODEV;
+	}
+	if (bytes && !usecs)
+		return -EINVAL;
+
+	ch->coalesce_usecs = usecs;
+	ch->coalesce_bytes = bytes;
+	if (!bytes) {
+		hrtimer_cancel(&ch->coalesce_timer);
+		smd_tx_flush(ch);
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL(smd_set_coalesce);
+
+int smd_flush(smd_channel_t *ch)
+{
+	if (!ch) {
+		pr_err("%s: Invalid channel specified\n", __func__);
+		return -ENODEV;
+	}
+
+	hrtimer_try_to_cancel(&ch->coalesce_timer);
+	smd_tx_flush(ch);
+
+	return 0;
+}
+EXPORT_SYMBOL(smd_flush);
+
 int smd_read_user_buffer(smd_channel_t *ch, void *data, int len)
 {
 	if (!ch) {
@@ -2418,14 +2635,93 @@ int smd_is_pkt_avail(smd_channel_t *ch)
 	if (ch->current_packet)
 		return 1;
 
-	spin_lock_irqsave(&smd_lock, flags);
+	spin_lock_irqsave(&ch->rx_lock, flags);
 	update_packet_state(ch);
-	spin_unlock_irqrestore(&smd_lock, flags);
+	spin_unlock_irqrestore(&ch->rx_lock, flags);
 
 	return ch->current_packet ? 1 : 0;
 }
 EXPORT_SYMBOL(smd_is_pkt_avail);
 
+static int smd_ch_stats_list(char *buf, int max, struct list_head *list)
+{
+	struct smd_channel *ch;
+	int i = 0;
+
+	list_for_each_entry(ch, list, ch_list) {
+		struct smd_ch_stats *st = &ch->stats;
+		unsigned long intr = st->tx_intr + st->rx_intr;
+
+		i += scnprintf(buf + i, max - i,
+			"%-20s %3d %10lu %10lu %12lu %12lu %10lu %5u/%-6u\n",
+			ch->name, ch->n, st->tx_intr, st->rx_intr,
+			st->tx_bytes, st->rx_bytes,
+			intr ? (st->tx_bytes + st->rx_bytes) / intr : 0,
+			ch->coalesce_bytes, ch->coalesce_usecs);
+	}
+	return i;
+}
+
+static struct smd_channel *smd_ch_find_open(const char *name,
+					    struct list_head *list)
+{
+	struct smd_channel *ch;
+
+	list_for_each_entry(ch, list, ch_list)
+		if (!strncmp(name, ch->name, SMD_MAX_CH_NAME_LEN))
+			return ch;
+	return NULL;
+}
+
+/*
+ * Coalescing knob for smd_debug: applies to the first open channel called
+ * @name on any edge.  Channels are never freed, only moved between lists,
+ * so using one after dropping smd_lock is safe even if it closes.
+ */
+int smd_set_coalesce_by_name(const char *name, unsigned bytes,
+			     unsigned usecs)
+{
+	struct list_head *lists[] = {
+		&smd_ch_list_modem, &smd_ch_list_dsp, &smd_ch_list_dsps,
+		&smd_ch_list_wcnss, &smd_ch_list_rpm, &smd_ch_list_loopback,
+	};
+	struct smd_channel *ch = NULL;
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(&smd_lock, flags);
+	for (i = 0; i < ARRAY_SIZE(lists) && !ch; i++)
+		ch = smd_ch_find_open(name, lists[i]);
+	spin_unlock_irqrestore(&smd_lock, flags);
+
+	if (!ch)
+		return -ENODEV;
+	return smd_set_coalesce(ch, bytes, usecs);
+}
+
+/* per channel interrupt counts for open channels, for smd_debug */
+int smd_ch_stats_dump(char *buf, int max)
+{
+	unsigned long flags;
+	int i;
+
+	i = scnprintf(buf, max,
+		"%-20s %3s %10s %10s %12s %12s %10s %s\n",
+		"name", "cid", "tx_intr", "rx_intr", "tx_bytes", "rx_bytes",
+		"bytes/intr", "coalesce");
+
+	spin_lock_irqsave(&smd_lock, flags);
+	i += smd_ch_stats_list(buf + i, max - i, &smd_ch_list_modem);
+	i += smd_ch_stats_list(buf + i, max - i, &smd_ch_list_dsp);
+	i += smd_ch_stats_list(buf + i, max - i, &smd_ch_list_dsps);
+	i += smd_ch_stats_list(buf + i, max - i, &smd_ch_list_wcnss);
+	i += smd_ch_stats_list(buf + i, max - i, &smd_ch_list_rpm);
+	i += smd_ch_stats_list(buf + i, max - i, &smd_ch_list_loopback);
+	spin_unlock_irqrestore(&smd_lock, flags);
+
+	return i;
+}
+
 
 /* -------------------------------------------------------------------------- */
 
@@ -19,6 +19,7 @@
 #include <linux/list.h>
 #include <linux/ctype.h>
 #include <linux/jiffies.h>
+#include <linux/uaccess.h>
 
 #include <mach/msm_iomap.h>
 
@@ -521,6 +522,119 @@ static int debug_test_smsm(char *buf, int max)
 	return i;
 }
 
+/*
+ * Coalesced writes and batched packet reads over the modem's LOOPBACK
+ * channel, which echoes every packet back.  Skipped when the channel is
+ * already held by smd_pkt or smd_tty, or the modem doesn't provide it.
+ */
+#define SMD_LB_PKTS	8
+
+static struct completion smd_lb_open;
+static struct completion smd_lb_data;
+static char smd_lb_tx[1024];
+static char smd_lb_rx[1024];
+
+static void smd_lb_notify(void *priv, unsigned event)
+{
+	if (event == SMD_EVENT_OPEN)
+		complete_all(&smd_lb_open);
+	else if (event == SMD_EVENT_DATA)
+		complete_all(&smd_lb_data);
+}
+
+/* batch-read @pkts echoed packets of 16, 32, ... bytes and check them */
+static int smd_lb_collect(smd_channel_t *ch, int pkts)
+{
+	int sizes[SMD_LB_PKTS];
+	int got = 0, total = 0;
+	int n, k;
+
+	while (got < pkts) {
+		INIT_COMPLETION(smd_lb_data);
+		n = smd_read_packets(ch, smd_lb_rx + total,
+				     sizeof(smd_lb_rx) - total, sizes,
+				     pkts - got);
+		if (n < 0)
+			return n;
+		for (k = 0; k < n; k++) {
+			if (sizes[k] != 16 * (got + k + 1))
+				return -EIO;
+			total += sizes[k];
+		}
+		got += n;
+		if (!n && !wait_for_completion_timeout(&smd_lb_data,
+						       msecs_to_jiffies(100)))
+			return -ETIMEDOUT;
+	}
+	return memcmp(smd_lb_tx, smd_lb_rx, total) ? -EIO : 0;
+}
+
+static int debug_test_smd_loopback(char *buf, int max)
+{
+	smd_channel_t *ch;
+	unsigned long intr;
+	int i = 0;
+	int test_num = 0;
+	int ret, n, off;
+
+	for (n = 0; n < sizeof(smd_lb_tx); n++)
+		smd_lb_tx[n] = n;
+
+	INIT_COMPLETION(smd_lb_open);
+	smsm_change_state(SMSM_APPS_STATE, 0, SMSM_SMD_LOOPBACK);
+	ret = smd_named_open_on_edge("LOOPBACK", SMD_APPS_MODEM, &ch, NULL,
+				     smd_lb_notify);
+	if (ret) {
+		i += scnprintf(buf + i, max - i,
+			       "LOOPBACK not available (%d), skipped\n", ret);
+		return i;
+	}
+
+	/* Test case 1 - coalesced packets are signalled once, on flush */
+	do {
+		test_num++;
+		UT_GT_INT((int)wait_for_completion_timeout(&smd_lb_open,
+					msecs_to_jiffies(1000)), 0);
+		ret = smd_set_coalesce(ch, 4096, 100000);
+		UT_EQ_INT(ret, 0);
+
+		intr = ch->stats.tx_intr;
+		for (n = 0, off = 0; n < SMD_LB_PKTS; n++) {
+			ret = smd_write(ch, smd_lb_tx + off, 16 * (n + 1));
+			if (ret != 16 * (n + 1))
+				break;
+			off += ret;
+		}
+		UT_EQ_INT(n, SMD_LB_PKTS);
+		UT_EQ_INT((int)(ch->stats.tx_intr - intr), 0);
+		ret = smd_flush(ch);
+		UT_EQ_INT(ret, 0);
+		UT_EQ_INT((int)(ch->stats.tx_intr - intr), 1);
+
+		ret = smd_lb_collect(ch, SMD_LB_PKTS);
+		UT_EQ_INT(ret, 0);
+
+		i += scnprintf(buf + i, max - i, "Test %d - PASS\n", test_num);
+	} while (0);
+
+	/* Test case 2 - the timer signals a packet below the threshold */
+	do {
+		test_num++;
+		ret = smd_set_coalesce(ch, 4096, 1000);
+		UT_EQ_INT(ret, 0);
+		ret = smd_write(ch, smd_lb_tx, 16);
+		UT_EQ_INT(ret, 16);
+		ret = smd_lb_collect(ch, 1);
+		UT_EQ_INT(ret, 0);
+
+		i += scnprintf(buf + i, max - i, "Test %d - PASS\n", test_num);
+	} while (0);
+
+	smd_set_coalesce(ch, 0, 0);
+	smd_close(ch);
+	return i;
+}
+
 static int debug_read_mem(char *buf, int max)
 {
 	unsigned n;
@@ -621,6 +735,11 @@ fail:
 }
 #endif
 
+static int debug_read_ch_stats(char *buf, int max)
+{
+	return smd_ch_stats_dump(buf, max);
+}
+
 static int debug_read_smem_version(char *buf, int max)
 {
 	struct smem_shared *shared = (void *) MSM_SHARED_RAM_BASE;
@@ -755,6 +874,33 @@ static const struct file_operations debug_ops = {
 	.open = simple_open,
 };
 
+/* "<channel> <bytes> <usecs>", see smd_set_coalesce() */
+static ssize_t debug_coalesce_write(struct file *file,
+				    const char __user *ubuf,
+				    size_t count, loff_t *ppos)
+{
+	char kbuf[64];
+	char name[SMD_MAX_CH_NAME_LEN];
+	unsigned bytes, usecs;
+	int ret;
+
+	if (count >= sizeof(kbuf))
+		return -EINVAL;
+	if (copy_from_user(kbuf, ubuf, count))
+		return -EFAULT;
+	kbuf[count] = 0;
+
+	if (sscanf(kbuf, "%19s %u %u", name, &bytes, &usecs) != 3)
+		return -EINVAL;
+	ret = smd_set_coalesce_by_name(name, bytes, usecs);
+	return ret ? ret : count;
+}
+
+static const struct file_operations debug_coalesce_ops = {
+	.write = debug_coalesce_write,
+	.open = simple_open,
+};
+
 static void debug_create(const char *name, umode_t mode,
 			 struct dentry *dent,
 			 int (*fill)(char *buf, int max))
@@ -781,6 +927,12 @@ static int __init smd_debugfs_init(void)
 	debug_create("print_f3", 0444, dent, debug_f3);
 	debug_create("int_stats", 0444, dent, debug_int_stats);
 	debug_create("int_stats_reset", 0444, dent, debug_int_stats_reset);
+	debug_create("ch_stats", 0444, dent, debug_read_ch_stats);
+	debugfs_create_file("coalesce", 0200, dent, NULL, &debug_coalesce_ops);
+	debug_create("loopback_test", 0444, dent, debug_test_smd_loopback);
+
+	init_completion(&smd_lb_open);
+	init_completion(&smd_lb_data);
 
 	/* NNV: this is google only stuff */
 	debug_create("build", 0444, dent, debug_read_build_id);
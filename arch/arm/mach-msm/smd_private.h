@@ -19,6 +19,7 @@
 #include <linux/types.h>
 #include <linux/spinlock.h>
 #include <linux/platform_device.h>
+#include <linux/hrtimer.h>
 #include <mach/msm_smsm.h>
 #include <mach/msm_smd.h>
 
@@ -205,6 +206,13 @@ struct smem_ram_ptn {
 	unsigned reserved2, reserved3, reserved4, reserved5;
 } __attribute__ ((__packed__));
 
+struct smd_ch_stats {
+	unsigned long tx_intr;		/* interrupts sent to the remote */
+	unsigned long rx_intr;		/* interrupts serviced for this ch */
+	unsigned long tx_bytes;
+	unsigned long rx_bytes;
+};
+
 struct smd_channel {
 	volatile void __iomem *send; /* some variant of smd_half_channel */
 	volatile void __iomem *recv; /* some variant of smd_half_channel */
@@ -239,6 +247,22 @@ struct smd_channel {
 
 	char is_pkt_ch;
 
+	/*
+	 * Data path locks, nested inside smd_lock.  rx_lock covers
+	 * current_packet and the packet header parsing on the receive FIFO,
+	 * tx_lock covers the transmit FIFO head and pending_pkt_sz.
+	 */
+	spinlock_t rx_lock;
+	spinlock_t tx_lock;
+
+	/* interrupt coalescing, see smd_set_coalesce() */
+	unsigned coalesce_bytes;
+	unsigned coalesce_usecs;
+	atomic_t tx_unsignalled;
+	struct hrtimer coalesce_timer;
+
+	struct smd_ch_stats stats;
+
 	/*
 	 * private internal functions to access *send and *recv.
 	 * never to be exported outside of smd
@@ -312,4 +336,8 @@ struct interrupt_stat {
 };
 extern struct interrupt_stat interrupt_stats[NUM_SMD_SUBSYSTEMS];
 
+int smd_ch_stats_dump(char *buf, int max);
+int smd_set_coalesce_by_name(const char *name, unsigned bytes,
+			     unsigned usecs);
+
 #endif
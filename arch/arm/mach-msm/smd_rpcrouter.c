@@ -331,6 +331,7 @@ static void modem_reset_cleanup(struct rpcrouter_xprt_info *xprt_info)
 		list_for_each_entry_safe(reply, reply_tmp,
 					 &ept->reply_pend_q, list) {
 			list_del(&reply->list);
+			hlist_del(&reply->hnode);
 			kfree(reply);
 		}
 		list_for_each_entry_safe(reply, reply_tmp,
@@ -597,6 +598,7 @@ struct msm_rpc_endpoint *msm_rpcrouter_create_local_endpoint(dev_t dev)
 {
 	struct msm_rpc_endpoint *ept;
 	unsigned long flags;
+	int i;
 
 	ept = kmalloc(sizeof(struct msm_rpc_endpoint), GFP_KERNEL);
 	if (!ept)
@@ -631,6 +633,8 @@ struct msm_rpc_endpoint *msm_rpcrouter_create_local_endpoint(dev_t dev)
 	spin_lock_init(&ept->read_q_lock);
 	INIT_LIST_HEAD(&ept->reply_avail_q);
 	INIT_LIST_HEAD(&ept->reply_pend_q);
+	for (i = 0; i < RPCROUTER_REPLY_HASH_SIZE; i++)
+		INIT_HLIST_HEAD(&ept->reply_pend_hash[i]);
 	spin_lock_init(&ept->reply_q_lock);
 	spin_lock_init(&ept->restart_lock);
 	init_waitqueue_head(&ept->restart_wait);
@@ -681,6 +685,7 @@ int msm_rpcrouter_destroy_local_endpoint(struct msm_rpc_endpoint *ept)
 	spin_lock_irqsave(&ept->reply_q_lock, flags);
 	list_for_each_entry_safe(reply, reply_tmp, &ept->reply_pend_q, list) {
 		list_del(&reply->list);
+		hlist_del(&reply->hnode);
 		kfree(reply);
 	}
 	list_for_each_entry_safe(reply, reply_tmp, &ept->reply_avail_q, list) {
@@ -1486,21 +1491,44 @@ static int msm_rpc_write_pkt(
 	return needed;
 }
 
+/*
+ * Pending replies are also hashed by xid so that matching a reply against
+ * a busy server endpoint doesn't walk every outstanding request.  Remote
+ * xids are sequential, so the low bits of the host order value spread
+ * them evenly.  Caller holds reply_q_lock.
+ */
+static struct hlist_head *reply_pend_bucket(struct msm_rpc_endpoint *ept,
+					    uint32_t xid)
+{
+	return &ept->reply_pend_hash[be32_to_cpu(xid) &
+				     (RPCROUTER_REPLY_HASH_SIZE - 1)];
+}
+
+static struct msm_rpc_reply *find_pend_reply(struct msm_rpc_endpoint *ept,
+					     uint32_t xid)
+{
+	struct msm_rpc_reply *reply;
+	struct hlist_node *n;
+
+	hlist_for_each_entry(reply, n, reply_pend_bucket(ept, xid), hnode)
+		if (reply->xid == xid)
+			return reply;
+	return NULL;
+}
+
 static struct msm_rpc_reply *get_pend_reply(struct msm_rpc_endpoint *ept,
 					    uint32_t xid)
 {
 	unsigned long flags;
 	struct msm_rpc_reply *reply;
 	spin_lock_irqsave(&ept->reply_q_lock, flags);
-	list_for_each_entry(reply, &ept->reply_pend_q, list) {
-		if (reply->xid == xid) {
-			list_del(&reply->list);
-			spin_unlock_irqrestore(&ept->reply_q_lock, flags);
-			return reply;
-		}
+	reply = find_pend_reply(ept, xid);
+	if (reply) {
+		list_del(&reply->list);
+		hlist_del(&reply->hnode);
 	}
 	spin_unlock_irqrestore(&ept->reply_q_lock, flags);
-	return NULL;
+	return reply;
 }
 
 void get_requesting_client(struct msm_rpc_endpoint *ept, uint32_t xid,
@@ -1513,18 +1541,14 @@ void get_requesting_client(struct msm_rpc_endpoint *ept, uint32_t xid,
 		return;
 
 	spin_lock_irqsave(&ept->reply_q_lock, flags);
-	list_for_each_entry(reply, &ept->reply_pend_q, list) {
-		if (reply->xid == xid) {
-			clnt_info->pid = reply->pid;
-			clnt_info->cid = reply->cid;
-			clnt_info->prog = reply->prog;
-			clnt_info->vers = reply->vers;
-			spin_unlock_irqrestore(&ept->reply_q_lock, flags);
-			return;
-		}
+	reply = find_pend_reply(ept, xid);
+	if (reply) {
+		clnt_info->pid = reply->pid;
+		clnt_info->cid = reply->cid;
+		clnt_info->prog = reply->prog;
+		clnt_info->vers = reply->vers;
 	}
 	spin_unlock_irqrestore(&ept->reply_q_lock, flags);
-	return;
 }
 
 static void set_avail_reply(struct msm_rpc_endpoint *ept,
@@ -1574,6 +1598,7 @@ static void set_pend_reply(struct msm_rpc_endpoint *ept,
 		D("%s: take reply lock on ept %p\n", __func__, ept);
 		wake_lock(&ept->reply_q_wake_lock);
 		list_add_tail(&reply->list, &ept->reply_pend_q);
+		hlist_add_head(&reply->hnode, reply_pend_bucket(ept, reply->xid));
 		spin_unlock_irqrestore(&ept->reply_q_lock, flags);
 }
 
@@ -169,6 +169,80 @@ int xdr_recv_bytes(struct msm_rpc_xdr *xdr, void **data,
 	return 0;
 }
 
+int xdr_send_layout(struct msm_rpc_xdr *xdr,
+		    const struct msm_rpc_xdr_layout *layout, const void *obj)
+{
+	const struct msm_rpc_xdr_field *f = layout->fields;
+	__be32 *out = xdr->out_buf + xdr->out_index;
+	uint32_t i, v;
+
+	if ((xdr->out_index + xdr_layout_size(layout)) > xdr->out_size) {
+		pr_err("%s: xdr out buffer full\n", __func__);
+		return -1;
+	}
+
+	for (i = 0; i < layout->count; i++, f++) {
+		const void *p = obj + f->offset;
+
+		switch (f->type) {
+		case XDR_TYPE_UINT16:
+			v = *(const uint16_t *)p;
+			break;
+		case XDR_TYPE_INT16:
+			v = *(const int16_t *)p;
+			break;
+		case XDR_TYPE_UINT8:
+			v = *(const uint8_t *)p;
+			break;
+		case XDR_TYPE_INT8:
+			v = *(const int8_t *)p;
+			break;
+		default:
+			v = *(const uint32_t *)p;
+			break;
+		}
+		out[i] = cpu_to_be32(v);
+	}
+
+	xdr->out_index += xdr_layout_size(layout);
+	return 0;
+}
+
+int xdr_recv_layout(struct msm_rpc_xdr *xdr,
+		    const struct msm_rpc_xdr_layout *layout, void *obj)
+{
+	const struct msm_rpc_xdr_field *f = layout->fields;
+	const __be32 *in = xdr->in_buf + xdr->in_index;
+	uint32_t i, v;
+
+	if ((xdr->in_index + xdr_layout_size(layout)) > xdr->in_size) {
+		pr_err("%s: xdr in buffer full\n", __func__);
+		return -1;
+	}
+
+	for (i = 0; i < layout->count; i++, f++) {
+		void *p = obj + f->offset;
+
+		v = be32_to_cpu(in[i]);
+		switch (f->type) {
+		case XDR_TYPE_UINT16:
+		case XDR_TYPE_INT16:
+			*(uint16_t *)p = v;
+			break;
+		case XDR_TYPE_UINT8:
+		case XDR_TYPE_INT8:
+			*(uint8_t *)p = v;
+			break;
+		default:
+			*(uint32_t *)p = v;
+			break;
+		}
+	}
+
+	xdr->in_index += xdr_layout_size(layout);
+	return 0;
+}
+
 int xdr_send_pointer(struct msm_rpc_xdr *xdr, void **obj,
 		     uint32_t obj_size, void *xdr_op)
 {
@@ -272,43 +346,55 @@ int xdr_recv_array(struct msm_rpc_xdr *xdr, void **addr, uint32_t *size,
 	return 0;
 }
 
+static const struct msm_rpc_xdr_field rpc_req_fields[] = {
+	XDR_FIELD(UINT32, struct rpc_request_hdr, xid),
+	XDR_FIELD(UINT32, struct rpc_request_hdr, type),
+	XDR_FIELD(UINT32, struct rpc_request_hdr, rpc_vers),
+	XDR_FIELD(UINT32, struct rpc_request_hdr, prog),
+	XDR_FIELD(UINT32, struct rpc_request_hdr, vers),
+	XDR_FIELD(UINT32, struct rpc_request_hdr, procedure),
+	XDR_FIELD(UINT32, struct rpc_request_hdr, cred_flavor),
+	XDR_FIELD(UINT32, struct rpc_request_hdr, cred_length),
+	XDR_FIELD(UINT32, struct rpc_request_hdr, verf_flavor),
+	XDR_FIELD(UINT32, struct rpc_request_hdr, verf_length),
+};
+static DEFINE_XDR_LAYOUT(rpc_req_layout, rpc_req_fields);
+
+static const struct msm_rpc_xdr_field rpc_reply_fields[] = {
+	XDR_FIELD(UINT32, struct rpc_reply_hdr, xid),
+	XDR_FIELD(UINT32, struct rpc_reply_hdr, type),
+	XDR_FIELD(UINT32, struct rpc_reply_hdr, reply_stat),
+};
+static DEFINE_XDR_LAYOUT(rpc_reply_layout, rpc_reply_fields);
+
+static const struct msm_rpc_xdr_field rpc_acc_hdr_fields[] = {
+	XDR_FIELD(UINT32, struct rpc_reply_hdr, data.acc_hdr.verf_flavor),
+	XDR_FIELD(UINT32, struct rpc_reply_hdr, data.acc_hdr.verf_length),
+	XDR_FIELD(UINT32, struct rpc_reply_hdr, data.acc_hdr.accept_stat),
+};
+static DEFINE_XDR_LAYOUT(rpc_acc_hdr_layout, rpc_acc_hdr_fields);
+
 int xdr_recv_req(struct msm_rpc_xdr *xdr, struct rpc_request_hdr *req)
 {
-	int rc = 0;
 	if (!req)
 		return -1;
 
-	rc |= xdr_recv_uint32(xdr, &req->xid);           /* xid */
-	rc |= xdr_recv_uint32(xdr, &req->type);          /* type */
-	rc |= xdr_recv_uint32(xdr, &req->rpc_vers);      /* rpc_vers */
-	rc |= xdr_recv_uint32(xdr, &req->prog);          /* prog */
-	rc |= xdr_recv_uint32(xdr, &req->vers);          /* vers */
-	rc |= xdr_recv_uint32(xdr, &req->procedure);     /* procedure */
-	rc |= xdr_recv_uint32(xdr, &req->cred_flavor);   /* cred_flavor */
-	rc |= xdr_recv_uint32(xdr, &req->cred_length);   /* cred_length */
-	rc |= xdr_recv_uint32(xdr, &req->verf_flavor);   /* verf_flavor */
-	rc |= xdr_recv_uint32(xdr, &req->verf_length);   /* verf_length */
-
-	return rc;
+	return xdr_recv_layout(xdr, &rpc_req_layout, req);
 }
 
 int xdr_recv_reply(struct msm_rpc_xdr *xdr, struct rpc_reply_hdr *reply)
 {
-	int rc = 0;
+	int rc;
 
 	if (!reply)
 		return -1;
 
-	rc |= xdr_recv_uint32(xdr, &reply->xid);           /* xid */
-	rc |= xdr_recv_uint32(xdr, &reply->type);          /* type */
-	rc |= xdr_recv_uint32(xdr, &reply->reply_stat);    /* reply_stat */
+	rc = xdr_recv_layout(xdr, &rpc_reply_layout, reply);
+	if (rc)
+		return rc;
 
-	/* acc_hdr */
-	if (reply->reply_stat == RPCMSG_REPLYSTAT_ACCEPTED) {
-		rc |= xdr_recv_uint32(xdr, &reply->data.acc_hdr.verf_flavor);
-		rc |= xdr_recv_uint32(xdr, &reply->data.acc_hdr.verf_length);
-		rc |= xdr_recv_uint32(xdr, &reply->data.acc_hdr.accept_stat);
-	}
+	if (reply->reply_stat == RPCMSG_REPLYSTAT_ACCEPTED)
+		rc = xdr_recv_layout(xdr, &rpc_acc_hdr_layout, reply);
 
 	return rc;
 }
@@ -18,6 +18,7 @@
 #include <linux/sched.h>
 #include <linux/smp.h>
 #include <linux/init.h>
+#include <linux/module.h>
 #include <linux/uaccess.h>
 #include <linux/user.h>
 #include <linux/proc_fs.h>
@@ -547,6 +548,57 @@ void vfp_flush_hwstate(struct thread_info *thread)
 	put_cpu();
 }
 
+#ifdef CONFIG_NEON
+/*
+ * Kernel mode NEON.  The unit is only handed to the kernel outside of
+ * interrupt context and with preemption disabled, so the kernel's own
+ * NEON register contents never need to be preserved; only the user
+ * state that is live in the hardware is saved, and marking the CPU as
+ * owning no state makes the next user VFP instruction reload it.
+ *
+ * Sections may nest (a NEON user calling memcpy(), which may itself use
+ * NEON); only the outermost pair enables and disables the unit.
+ */
+static DEFINE_PER_CPU(unsigned int, kernel_neon_depth);
+
+void kernel_neon_begin(void)
+{
+	struct thread_info *thread = current_thread_info();
+	unsigned int cpu;
+	u32 fpexc;
+
+	BUG_ON(in_interrupt());
+	cpu = get_cpu();
+
+	if (per_cpu(kernel_neon_depth, cpu)++)
+		return;
+
+	fpexc = fmrx(FPEXC) | FPEXC_EN;
+	fmxr(FPEXC, fpexc);
+
+	/*
+	 * Under UP the owner of the hardware state may be a task other
+	 * than current.
+	 */
+	if (vfp_state_in_hw(cpu, thread))
+		vfp_save_state(&thread->vfpstate, fpexc);
+#ifndef CONFIG_SMP
+	else if (vfp_current_hw_state[cpu] != NULL)
+		vfp_save_state(vfp_current_hw_state[cpu], fpexc);
+#endif
+	vfp_current_hw_state[cpu] = NULL;
+}
+EXPORT_SYMBOL(kernel_neon_begin);
+
+void kernel_neon_end(void)
+{
+	if (!--__get_cpu_var(kernel_neon_depth))
+		fmxr(FPEXC, fmrx(FPEXC) & ~FPEXC_EN);
+	put_cpu();
+}
+EXPORT_SYMBOL(kernel_neon_end);
+#endif /* CONFIG_NEON */
+
 /*
  * Save the current VFP state into the provided structures and prepare
  * for entry into a new function (signal handler).
@@ -33,6 +33,13 @@
 #include <linux/jiffies.h>
 #include <linux/timex.h>
 #include <linux/interrupt.h>
+#include <linux/kthread.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/sched.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/cpumask.h>
 #include "tcrypt.h"
 #include "internal.h"
 
@@ -920,6 +927,481 @@ out:
 	crypto_free_ablkcipher(tfm);
 }
 
+/*
+ * Multi-threaded benchmark (modes 600-699): one kthread per CPU keeps
+ * "depth" requests in flight against a shared tfm for "sec" seconds and
+ * records the latency of every request in a log-linear histogram, so
+ * that generic, NEON and hardware implementations can be compared under
+ * concurrent load.
+ */
+#define TCRYPT_MT_SUB_SHIFT	3
+#define TCRYPT_MT_SUB		(1 << TCRYPT_MT_SUB_SHIFT)
+#define TCRYPT_MT_BUCKETS	((64 - TCRYPT_MT_SUB_SHIFT + 1) << \
+				 TCRYPT_MT_SUB_SHIFT)
+#define TCRYPT_MT_IV_SIZE	32
+#define TCRYPT_MT_DIGEST_SIZE	64
+
+static unsigned int threads;
+static unsigned int depth = 1;
+static unsigned int blen;
+
+static u32 mt_block_sizes[] = { 64, 512, 1024, 4096, 65536, 0 };
+
+struct tcrypt_mt_thread;
+
+struct tcrypt_mt_req {
+	struct tcrypt_mt_thread *t;
+	struct list_head list;
+	void *req;
+	struct scatterlist sg;
+	void *buf;
+	u8 iv[TCRYPT_MT_IV_SIZE];
+	u8 result[TCRYPT_MT_DIGEST_SIZE];
+	s64 start;
+	s64 end;
+	int err;
+};
+
+struct tcrypt_mt_bench {
+	int (*op)(struct tcrypt_mt_req *r);
+	struct completion start;
+	s64 end_ns;
+	int abort;
+};
+
+struct tcrypt_mt_thread {
+	struct tcrypt_mt_bench *bench;
+	struct task_struct *task;
+	struct completion exited;
+	spinlock_t lock;
+	struct list_head done;
+	struct tcrypt_mt_req *reqs;
+	unsigned int inflight;
+	int err;
+	u64 ops;
+	s64 last_end;
+	u64 max_ns;
+	u32 hist[TCRYPT_MT_BUCKETS];
+};
+
+static unsigned int tcrypt_mt_bucket(u64 ns)
+{
+	unsigned int msb;
+
+	if (ns < TCRYPT_MT_SUB)
+		return ns;
+
+	msb = fls64(ns) - 1;
+	return ((msb - TCRYPT_MT_SUB_SHIFT + 1) << TCRYPT_MT_SUB_SHIFT) |
+	       ((ns >> (msb - TCRYPT_MT_SUB_SHIFT)) & (TCRYPT_MT_SUB - 1));
+}
+
+/* Lower bound of a histogram bucket, within 1/8 of any value in it. */
+static u64 tcrypt_mt_bucket_ns(unsigned int idx)
+{
+	unsigned int msb;
+
+	if (idx < TCRYPT_MT_SUB)
+		return idx;
+
+	msb = (idx >> TCRYPT_MT_SUB_SHIFT) + TCRYPT_MT_SUB_SHIFT - 1;
+	return (u64)(TCRYPT_MT_SUB | (idx & (TCRYPT_MT_SUB - 1))) <<
+	       (msb - TCRYPT_MT_SUB_SHIFT);
+}
+
+static u64 tcrypt_mt_percentile(const u32 *hist, u64 count,
+				unsigned int permille)
+{
+	u64 target = div_u64(count * permille + 999, 1000);
+	u64 seen = 0;
+	unsigned int i;
+
+	for (i = 0; i < TCRYPT_MT_BUCKETS; i++) {
+		seen += hist[i];
+		if (seen && seen >= target)
+			return tcrypt_mt_bucket_ns(i);
+	}
+
+	return 0;
+}
+
+static int tcrypt_mt_encrypt(struct tcrypt_mt_req *r)
+{
+	return crypto_ablkcipher_encrypt(r->req);
+}
+
+static int tcrypt_mt_decrypt(struct tcrypt_mt_req *r)
+{
+	return crypto_ablkcipher_decrypt(r->req);
+}
+
+static int tcrypt_mt_digest(struct tcrypt_mt_req *r)
+{
+	return crypto_ahash_digest(r->req);
+}
+
+static void tcrypt_mt_done(struct tcrypt_mt_req *r, int err)
+{
+	struct tcrypt_mt_thread *t = r->t;
+	unsigned long flags;
+
+	r->err = err;
+	r->end = ktime_to_ns(ktime_get());
+
+	spin_lock_irqsave(&t->lock, flags);
+	list_add_tail(&r->list, &t->done);
+	spin_unlock_irqrestore(&t->lock, flags);
+}
+
+static void tcrypt_mt_complete(struct crypto_async_request *req, int err)
+{
+	struct tcrypt_mt_req *r = req->data;
+	struct task_struct *task;
+
+	if (err == -EINPROGRESS)
+		return;
+
+	/*
+	 * Once r is on the done list the thread may finish and the run
+	 * free r and t, and drop its task reference; keep our own.
+	 */
+	task = r->t->task;
+	get_task_struct(task);
+	tcrypt_mt_done(r, err);
+	wake_up_process(task);
+	put_task_struct(task);
+}
+
+static void tcrypt_mt_submit(struct tcrypt_mt_thread *t,
+			     struct tcrypt_mt_req *r)
+{
+	int ret;
+
+	t->inflight++;
+	r->start = ktime_to_ns(ktime_get());
+
+	ret = t->bench->op(r);
+	if (ret != -EINPROGRESS && ret != -EBUSY)
+		tcrypt_mt_done(r, ret);
+}
+
+static int tcrypt_mt_thread_fn(void *data)
+{
+	struct tcrypt_mt_thread *t = data;
+	struct tcrypt_mt_bench *bench = t->bench;
+	struct tcrypt_mt_req *r, *tmp;
+	unsigned int i;
+	LIST_HEAD(done);
+	u64 ns;
+
+	wait_for_completion(&bench->start);
+
+	if (!bench->abort)
+		for (i = 0; i < depth; i++)
+			tcrypt_mt_submit(t, &t->reqs[i]);
+
+	for (;;) {
+		set_current_state(TASK_UNINTERRUPTIBLE);
+
+		spin_lock_irq(&t->lock);
+		list_splice_init(&t->done, &done);
+		spin_unlock_irq(&t->lock);
+
+		if (list_empty(&done)) {
+			if (!t->inflight)
+				break;
+			schedule();
+			continue;
+		}
+		__set_current_state(TASK_RUNNING);
+
+		list_for_each_entry_safe(r, tmp, &done, list) {
+			list_del(&r->list);
+			t->inflight--;
+
+			if (r->err) {
+				if (!t->err)
+					t->err = r->err;
+				continue;
+			}
+
+			ns = r->end - r->start;
+			t->hist[tcrypt_mt_bucket(ns)]++;
+			t->max_ns = max(t->max_ns, ns);
+			t->last_end = max(t->last_end, r->end);
+			t->ops++;
+
+			if (!t->err && r->end < bench->end_ns)
+				tcrypt_mt_submit(t, r);
+		}
+
+		cond_resched();
+	}
+	__set_current_state(TASK_RUNNING);
+
+	complete(&t->exited);
+	return 0;
+}
+
+static void tcrypt_mt_free_reqs(struct tcrypt_mt_thread *t, int hash)
+{
+	unsigned int i;
+
+	if (!t->reqs)
+		return;
+
+	for (i = 0; i < depth; i++) {
+		if (hash)
+			ahash_request_free(t->reqs[i].req);
+		else
+			ablkcipher_request_free(t->reqs[i].req);
+		kfree(t->reqs[i].buf);
+	}
+	kfree(t->reqs);
+}
+
+static int tcrypt_mt_alloc_reqs(struct tcrypt_mt_thread *t, void *tfm,
+				int hash, unsigned int len)
+{
+	struct tcrypt_mt_req *r;
+	unsigned int i;
+
+	t->reqs = kcalloc(depth, sizeof(*t->reqs), GFP_KERNEL);
+	if (!t->reqs)
+		return -ENOMEM;
+
+	for (i = 0; i < depth; i++) {
+		r = &t->reqs[i];
+		r->t = t;
+
+		r->buf = kmalloc(len, GFP_KERNEL);
+		if (!r->buf)
+			return -ENOMEM;
+		memset(r->buf, 0xff, len);
+		sg_init_one(&r->sg, r->buf, len);
+		memset(r->iv, 0xff, sizeof(r->iv));
+
+		if (hash) {
+			struct ahash_request *req;
+
+			req = ahash_request_alloc(tfm, GFP_KERNEL);
+			if (!req)
+				return -ENOMEM;
+			ahash_request_set_callback(req,
+						   CRYPTO_TFM_REQ_MAY_BACKLOG,
+						   tcrypt_mt_complete, r);
+			ahash_request_set_crypt(req, &r->sg, r->result, len);
+			r->req = req;
+		} else {
+			struct ablkcipher_request *req;
+
+			req = ablkcipher_request_alloc(tfm, GFP_KERNEL);
+			if (!req)
+				return -ENOMEM;
+			ablkcipher_request_set_callback(req,
+						CRYPTO_TFM_REQ_MAY_BACKLOG,
+						tcrypt_mt_complete, r);
+			ablkcipher_request_set_crypt(req, &r->sg, &r->sg, len,
+						     r->iv);
+			r->req = req;
+		}
+	}
+
+	return 0;
+}
+
+static int tcrypt_mt_run(const char *desc, void *tfm, int hash,
+			 int (*op)(struct tcrypt_mt_req *r), unsigned int len)
+{
+	unsigned int nthreads = threads ?: num_online_cpus();
+	unsigned int duration = sec ?: 1;
+	struct tcrypt_mt_thread *ts;
+	struct tcrypt_mt_bench bench;
+	u64 ops = 0, max_ns = 0, elapsed;
+	u32 *hist;
+	s64 start, last_end = 0;
+	unsigned int i, j, started = 0;
+	int cpu = -1;
+	int ret = 0;
+
+	if (!depth)
+		return -EINVAL;
+
+	ts = vzalloc(nthreads * sizeof(*ts));
+	hist = kzalloc(TCRYPT_MT_BUCKETS * sizeof(*hist), GFP_KERNEL);
+	if (!ts || !hist) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	bench.op = op;
+	bench.abort = 0;
+	init_completion(&bench.start);
+
+	for (i = 0; i < nthreads; i++) {
+		struct tcrypt_mt_thread *t = &ts[i];
+
+		t->bench = &bench;
+		spin_lock_init(&t->lock);
+		INIT_LIST_HEAD(&t->done);
+		init_completion(&t->exited);
+
+		ret = tcrypt_mt_alloc_reqs(t, tfm, hash, len);
+		if (ret)
+			break;
+
+		cpu = cpumask_next(cpu, cpu_online_mask);
+		if (cpu >= nr_cpu_ids)
+			cpu = cpumask_first(cpu_online_mask);
+
+		t->task = kthread_create(tcrypt_mt_thread_fn, t, "tcrypt/%u", i);
+		if (IS_ERR(t->task)) {
+			ret = PTR_ERR(t->task);
+			break;
+		}
+		/* completions may wake the thread after it has exited */
+		get_task_struct(t->task);
+		kthread_bind(t->task, cpu);
+		wake_up_process(t->task);
+		started++;
+	}
+
+	if (ret)
+		bench.abort = 1;
+
+	start = ktime_to_ns(ktime_get());
+	bench.end_ns = start + (s64)duration * NSEC_PER_SEC;
+	complete_all(&bench.start);
+
+	for (i = 0; i < started; i++) {
+		wait_for_completion(&ts[i].exited);
+		put_task_struct(ts[i].task);
+	}
+
+	if (ret) {
+		pr_err("tcrypt: failed to start %s threads: %d\n", desc, ret);
+		goto out;
+	}
+
+	for (i = 0; i < nthreads; i++) {
+		struct tcrypt_mt_thread *t = &ts[i];
+
+		if (t->err && !ret)
+			ret = t->err;
+		ops += t->ops;
+		max_ns = max(max_ns, t->max_ns);
+		if (t->last_end > last_end)
+			last_end = t->last_end;
+		for (j = 0; j < TCRYPT_MT_BUCKETS; j++)
+			hist[j] += t->hist[j];
+	}
+
+	if (ret) {
+		pr_err("tcrypt: %s failed: %d\n", desc, ret);
+		goto out;
+	}
+
+	elapsed = div_u64(max_t(s64, last_end - start, NSEC_PER_USEC),
+			  NSEC_PER_USEC);
+
+	pr_info("%s: %u threads, depth %u, %u byte blocks: "
+		"%llu opers/sec, %llu bytes/sec, latency ns "
+		"p50 %llu p90 %llu p99 %llu max %llu\n",
+		desc, nthreads, depth, len,
+		div64_u64(ops * USEC_PER_SEC, elapsed),
+		div64_u64(ops * len * USEC_PER_SEC, elapsed),
+		tcrypt_mt_percentile(hist, ops, 500),
+		tcrypt_mt_percentile(hist, ops, 900),
+		tcrypt_mt_percentile(hist, ops, 990),
+		max_ns);
+
+out:
+	if (ts)
+		for (i = 0; i < nthreads; i++)
+			tcrypt_mt_free_reqs(&ts[i], hash);
+	vfree(ts);
+	kfree(hist);
+	return ret;
+}
+
+static int test_mt_acipher_speed(const char *algo, int enc, u8 *keysize)
+{
+	struct crypto_ablkcipher *tfm;
+	char desc[CRYPTO_MAX_ALG_NAME + 32];
+	static u8 key[64];
+	u32 *b_size;
+	int ret = 0;
+
+	tfm = crypto_alloc_ablkcipher(algo, 0, 0);
+	if (IS_ERR(tfm)) {
+		pr_err("failed to load transform for %s: %ld\n", algo,
+		       PTR_ERR(tfm));
+		return PTR_ERR(tfm);
+	}
+
+	memset(key, 0xff, sizeof(key));
+
+	for (; *keysize && !ret; keysize++) {
+		crypto_ablkcipher_clear_flags(tfm, ~0);
+		if (crypto_ablkcipher_setkey(tfm, key, *keysize))
+			continue;
+
+		snprintf(desc, sizeof(desc), "%s (%s) %s %d bit key", algo,
+			 crypto_tfm_alg_driver_name(crypto_ablkcipher_tfm(tfm)),
+			 enc == ENCRYPT ? "encryption" : "decryption",
+			 *keysize * 8);
+
+		for (b_size = blen ? &blen : mt_block_sizes;
+		     *b_size && !ret; b_size++) {
+			ret = tcrypt_mt_run(desc, tfm, 0,
+					    enc == ENCRYPT ? tcrypt_mt_encrypt :
+							     tcrypt_mt_decrypt,
+					    *b_size);
+			if (blen)
+				break;
+		}
+	}
+
+	crypto_free_ablkcipher(tfm);
+	return ret;
+}
+
+static int test_mt_ahash_speed(const char *algo)
+{
+	struct crypto_ahash *tfm;
+	char desc[CRYPTO_MAX_ALG_NAME + 32];
+	u32 *b_size;
+	int ret = 0;
+
+	tfm = crypto_alloc_ahash(algo, 0, 0);
+	if (IS_ERR(tfm)) {
+		pr_err("failed to load transform for %s: %ld\n", algo,
+		       PTR_ERR(tfm));
+		return PTR_ERR(tfm);
+	}
+
+	if (crypto_ahash_digestsize(tfm) > TCRYPT_MT_DIGEST_SIZE) {
+		pr_err("digestsize(%u) > %d\n", crypto_ahash_digestsize(tfm),
+		       TCRYPT_MT_DIGEST_SIZE);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	snprintf(desc, sizeof(desc), "%s (%s)", algo,
+		 crypto_tfm_alg_driver_name(crypto_ahash_tfm(tfm)));
+
+	for (b_size = blen ? &blen : mt_block_sizes; *b_size && !ret;
+	     b_size++) {
+		ret = tcrypt_mt_run(desc, tfm, 1, tcrypt_mt_digest, *b_size);
+		if (blen)
+			break;
+	}
+
+out:
+	crypto_free_ahash(tfm);
+	return ret;
+}
+
 static void test_available(void)
 {
 	char **name = check;
@@ -1414,6 +1896,10 @@ static int do_test(int m)
 		test_hash_speed("ghash-generic", sec, hash_speed_template_16);
 		if (mode > 300 && mode < 400) break;
 
+	case 319:
+		test_hash_speed("crc32c", sec, generic_hash_speed_template);
+		if (mode > 300 && mode < 400) break;
+
 	case 399:
 		break;
 
@@ -1563,6 +2049,42 @@ static int do_test(int m)
 				   speed_template_32_64);
 		break;
 
+	case 600:
+		/* fall through */
+
+	case 601:
+		if (alg) {
+			ret += test_mt_acipher_speed(alg, ENCRYPT,
+						     speed_template_16_24_32) < 0;
+			ret += test_mt_acipher_speed(alg, DECRYPT,
+						     speed_template_16_24_32) < 0;
+		} else {
+			test_mt_acipher_speed("cbc(aes)", ENCRYPT,
+					      speed_template_16_24_32);
+			test_mt_acipher_speed("cbc(aes)", DECRYPT,
+					      speed_template_16_24_32);
+			test_mt_acipher_speed("ctr(aes)", ENCRYPT,
+					      speed_template_16_24_32);
+			test_mt_acipher_speed("xts(aes)", ENCRYPT,
+					      speed_template_32_48_64);
+			test_mt_acipher_speed("xts(aes)", DECRYPT,
+					      speed_template_32_48_64);
+		}
+		if (mode > 600 && mode < 700) break;
+
+	case 602:
+		if (alg) {
+			ret += test_mt_ahash_speed(alg) < 0;
+		} else {
+			test_mt_ahash_speed("sha1");
+			test_mt_ahash_speed("sha256");
+			test_mt_ahash_speed("sha512");
+		}
+		if (mode > 600 && mode < 700) break;
+
+	case 699:
+		break;
+
 	case 1000:
 		test_available();
 		break;
@@ -1588,7 +2110,8 @@ static int __init tcrypt_mod_init(void)
 			goto err_free_tv;
 	}
 
-	if (alg)
+	/* the multi-threaded modes take alg as the algorithm to measure */
+	if (alg && !(mode >= 600 && mode < 700))
 		err = do_alg_test(alg, type, mask);
 	else
 		err = do_test(mode);
@@ -1631,6 +2154,14 @@ module_param(mode, int, 0);
 module_param(sec, uint, 0);
 MODULE_PARM_DESC(sec, "Length in seconds of speed tests "
 		      "(defaults to zero which uses CPU cycles instead)");
+module_param(threads, uint, 0);
+MODULE_PARM_DESC(threads, "Threads for modes 600-699, one per CPU "
+			  "(defaults to zero which uses all online CPUs)");
+module_param(depth, uint, 0);
+MODULE_PARM_DESC(depth, "Requests in flight per thread for modes 600-699");
+module_param(blen, uint, 0);
+MODULE_PARM_DESC(blen, "Buffer size for modes 600-699 "
+		       "(defaults to zero which runs a range of sizes)");
 
 MODULE_LICENSE("GPL");
 MODULE_DESCRIPTION("Quick & dirty crypto testing module");
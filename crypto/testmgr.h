@@ -6109,14 +6109,14 @@ static struct cipher_testvec cast6_dec_tv_template[] = {
  */
 #define AES_ENC_TEST_VECTORS 3
 #define AES_DEC_TEST_VECTORS 3
-#define AES_CBC_ENC_TEST_VECTORS 4
-#define AES_CBC_DEC_TEST_VECTORS 4
+#define AES_CBC_ENC_TEST_VECTORS 6
+#define AES_CBC_DEC_TEST_VECTORS 6
 #define AES_LRW_ENC_TEST_VECTORS 8
 #define AES_LRW_DEC_TEST_VECTORS 8
 #define AES_XTS_ENC_TEST_VECTORS 5
 #define AES_XTS_DEC_TEST_VECTORS 5
-#define AES_CTR_ENC_TEST_VECTORS 3
-#define AES_CTR_DEC_TEST_VECTORS 3
+#define AES_CTR_ENC_TEST_VECTORS 6
+#define AES_CTR_DEC_TEST_VECTORS 6
 #define AES_OFB_ENC_TEST_VECTORS 1
 #define AES_OFB_DEC_TEST_VECTORS 1
 #define AES_CTR_3686_ENC_TEST_VECTORS 7
@@ -6283,6 +6283,276 @@ static struct cipher_testvec aes_cbc_enc_tv_template[] = {
 			  "\xb2\xeb\x05\xe2\xc3\x9b\xe9\xfc"
 			  "\xda\x6c\x19\x07\x8c\x6a\x9d\x1b",
 		.rlen	= 64,
+	}, { /* 31 blocks: the 8-way path, then a tail */
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x16\x5f\xbc\xe7\x4a\x96\xe1\x46"
+			  "\x8b\x8c\xc5\xad\xca\x57\x34\x5f",
+		.input	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.ilen	= 496,
+		.result	= "\xa2\x50\xc6\x6c\x13\xab\xf6\x34"
+			  "\x7d\xfa\x0b\x43\x5a\x50\x48\x41"
+			  "\x22\x36\x0f\xd2\x69\x3a\x1a\x72"
+			  "\xd3\xe4\x15\xf2\x3f\xff\xcc\x06"
+			  "\x0d\x4c\x82\x17\xed\xbf\x9f\x1f"
+			  "\x62\xb0\x36\x3f\x3f\xf8\x4d\x67"
+			  "\x56\x8b\x62\x80\xce\xf9\xa6\x00"
+			  "\x40\x2e\xe0\x70\xc8\x39\xe0\x6a"
+			  "\xa0\xb6\x46\xd6\xd9\x06\x9a\x51"
+			  "\x7b\x80\x43\x3a\xff\x9c\xd6\xbb"
+			  "\x21\x3b\x01\xcd\xb5\x56\x94\x5d"
+			  "\xdd\xb9\x7c\x41\xcb\xfc\x77\x8d"
+			  "\x42\x47\xe8\xe0\x79\x3e\xd0\xd0"
+			  "\x40\x26\xf1\x84\x59\x45\xc0\xd1"
+			  "\xda\xaf\x12\x32\x8c\x76\x1d\x9c"
+			  "\x27\x2e\xa0\x4a\x72\x1f\xa6\x1e"
+			  "\xf3\x92\xd6\xc8\x75\x22\x7e\xd1"
+			  "\xae\x1f\x98\xb4\x7a\xe7\xb9\xb9"
+			  "\x18\x7d\x37\xf1\xe5\x47\xd1\xf9"
+			  "\x96\x30\xfc\x54\x96\x0c\x89\xf1"
+			  "\x3d\xe7\xc8\xc2\xaf\x42\xa1\x7c"
+			  "\x74\x5a\xbb\x7a\xeb\x68\xf5\xab"
+			  "\xd3\x76\xd8\xa4\xc2\xd1\xc3\xe7"
+			  "\x00\x65\x30\x97\x94\xb8\x55\x07"
+			  "\xcc\x87\xbe\x89\x77\x36\x7c\x7e"
+			  "\x24\x19\xcd\x85\xb8\x6f\x5e\x5f"
+			  "\xfb\xe5\x56\x76\x07\x79\xae\xfe"
+			  "\x9c\xee\xad\x57\x38\x4e\x82\x36"
+			  "\xd8\x76\x89\x40\x6b\xe7\xf0\x22"
+			  "\x68\x4c\x4c\x7f\xfa\x97\xd4\xc4"
+			  "\xff\xa8\xb7\x3d\xc6\x8a\x94\xa7"
+			  "\x36\x52\x35\x8e\x31\x57\x60\x17"
+			  "\xdb\x2d\x18\xe8\x0a\xf1\x7e\xb9"
+			  "\xf0\xb9\x1c\x85\x40\x92\x1b\xf3"
+			  "\xb6\xdc\x90\xb6\xc7\x4c\x4b\x91"
+			  "\xbe\x92\xb1\xa1\xb4\x9e\xcb\xa4"
+			  "\xe1\x07\xa5\xcd\x0c\x4b\x82\x3d"
+			  "\xa8\x47\x18\x1e\x82\x57\x5c\x2a"
+			  "\xcf\x30\x20\x23\x21\x61\x74\xba"
+			  "\xf1\x35\x90\xcf\x0d\xd3\x88\xb1"
+			  "\xd6\xcb\x30\x77\x8c\x38\x1e\x05"
+			  "\x3b\xf0\x8f\x2a\x42\x8b\xb8\x3a"
+			  "\x97\x14\x27\x85\xc6\xa4\xd0\x75"
+			  "\x86\x84\x63\x6d\x5a\x1e\x63\x6f"
+			  "\x9a\xea\xdd\xda\xc0\x24\xb6\x33"
+			  "\xe9\x03\xb9\x32\xcb\x89\x45\x30"
+			  "\x42\x75\x4c\xc3\x44\xec\x90\xcd"
+			  "\x8d\x38\xe9\xf1\x52\x85\x54\x9d"
+			  "\x9f\x48\xe1\x23\x79\x51\xa2\xc3"
+			  "\xbb\x57\x43\x02\xd5\x9f\x3d\x2b"
+			  "\x9c\xe2\x4f\x70\xb7\xd0\x65\xa7"
+			  "\xc5\x6b\x0d\xcd\xe8\xa5\x5e\x41"
+			  "\x97\x2a\x78\x6e\x05\x46\x6e\xdd"
+			  "\x6c\x11\x38\x05\x6e\x12\x2b\x3d"
+			  "\x55\x20\xe6\xcc\x24\x92\xeb\xac"
+			  "\x27\x6f\x60\x0e\x78\xdd\x46\x32"
+			  "\x95\xfe\xd0\x5d\x96\x5f\x68\x96"
+			  "\xbe\xb8\x5b\xc1\xf1\xcd\x90\xb2"
+			  "\x61\x03\xe6\xe7\xaa\xf3\x5d\xb8"
+			  "\xa7\x54\x6a\x3d\x08\x27\x4f\xf7"
+			  "\x81\x70\x8a\xd3\xda\x98\x14\x39"
+			  "\x36\xc3\x4a\xb5\x0d\xab\xc5\x8a",
+		.rlen	= 496,
+	}, {
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x16\x5f\xbc\xe7\x4a\x96\xe1\x46"
+			  "\x8b\x8c\xc5\xad\xca\x57\x34\x5f",
+		.input	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.ilen	= 496,
+		.result	= "\xa2\x50\xc6\x6c\x13\xab\xf6\x34"
+			  "\x7d\xfa\x0b\x43\x5a\x50\x48\x41"
+			  "\x22\x36\x0f\xd2\x69\x3a\x1a\x72"
+			  "\xd3\xe4\x15\xf2\x3f\xff\xcc\x06"
+			  "\x0d\x4c\x82\x17\xed\xbf\x9f\x1f"
+			  "\x62\xb0\x36\x3f\x3f\xf8\x4d\x67"
+			  "\x56\x8b\x62\x80\xce\xf9\xa6\x00"
+			  "\x40\x2e\xe0\x70\xc8\x39\xe0\x6a"
+			  "\xa0\xb6\x46\xd6\xd9\x06\x9a\x51"
+			  "\x7b\x80\x43\x3a\xff\x9c\xd6\xbb"
+			  "\x21\x3b\x01\xcd\xb5\x56\x94\x5d"
+			  "\xdd\xb9\x7c\x41\xcb\xfc\x77\x8d"
+			  "\x42\x47\xe8\xe0\x79\x3e\xd0\xd0"
+			  "\x40\x26\xf1\x84\x59\x45\xc0\xd1"
+			  "\xda\xaf\x12\x32\x8c\x76\x1d\x9c"
+			  "\x27\x2e\xa0\x4a\x72\x1f\xa6\x1e"
+			  "\xf3\x92\xd6\xc8\x75\x22\x7e\xd1"
+			  "\xae\x1f\x98\xb4\x7a\xe7\xb9\xb9"
+			  "\x18\x7d\x37\xf1\xe5\x47\xd1\xf9"
+			  "\x96\x30\xfc\x54\x96\x0c\x89\xf1"
+			  "\x3d\xe7\xc8\xc2\xaf\x42\xa1\x7c"
+			  "\x74\x5a\xbb\x7a\xeb\x68\xf5\xab"
+			  "\xd3\x76\xd8\xa4\xc2\xd1\xc3\xe7"
+			  "\x00\x65\x30\x97\x94\xb8\x55\x07"
+			  "\xcc\x87\xbe\x89\x77\x36\x7c\x7e"
+			  "\x24\x19\xcd\x85\xb8\x6f\x5e\x5f"
+			  "\xfb\xe5\x56\x76\x07\x79\xae\xfe"
+			  "\x9c\xee\xad\x57\x38\x4e\x82\x36"
+			  "\xd8\x76\x89\x40\x6b\xe7\xf0\x22"
+			  "\x68\x4c\x4c\x7f\xfa\x97\xd4\xc4"
+			  "\xff\xa8\xb7\x3d\xc6\x8a\x94\xa7"
+			  "\x36\x52\x35\x8e\x31\x57\x60\x17"
+			  "\xdb\x2d\x18\xe8\x0a\xf1\x7e\xb9"
+			  "\xf0\xb9\x1c\x85\x40\x92\x1b\xf3"
+			  "\xb6\xdc\x90\xb6\xc7\x4c\x4b\x91"
+			  "\xbe\x92\xb1\xa1\xb4\x9e\xcb\xa4"
+			  "\xe1\x07\xa5\xcd\x0c\x4b\x82\x3d"
+			  "\xa8\x47\x18\x1e\x82\x57\x5c\x2a"
+			  "\xcf\x30\x20\x23\x21\x61\x74\xba"
+			  "\xf1\x35\x90\xcf\x0d\xd3\x88\xb1"
+			  "\xd6\xcb\x30\x77\x8c\x38\x1e\x05"
+			  "\x3b\xf0\x8f\x2a\x42\x8b\xb8\x3a"
+			  "\x97\x14\x27\x85\xc6\xa4\xd0\x75"
+			  "\x86\x84\x63\x6d\x5a\x1e\x63\x6f"
+			  "\x9a\xea\xdd\xda\xc0\x24\xb6\x33"
+			  "\xe9\x03\xb9\x32\xcb\x89\x45\x30"
+			  "\x42\x75\x4c\xc3\x44\xec\x90\xcd"
+			  "\x8d\x38\xe9\xf1\x52\x85\x54\x9d"
+			  "\x9f\x48\xe1\x23\x79\x51\xa2\xc3"
+			  "\xbb\x57\x43\x02\xd5\x9f\x3d\x2b"
+			  "\x9c\xe2\x4f\x70\xb7\xd0\x65\xa7"
+			  "\xc5\x6b\x0d\xcd\xe8\xa5\x5e\x41"
+			  "\x97\x2a\x78\x6e\x05\x46\x6e\xdd"
+			  "\x6c\x11\x38\x05\x6e\x12\x2b\x3d"
+			  "\x55\x20\xe6\xcc\x24\x92\xeb\xac"
+			  "\x27\x6f\x60\x0e\x78\xdd\x46\x32"
+			  "\x95\xfe\xd0\x5d\x96\x5f\x68\x96"
+			  "\xbe\xb8\x5b\xc1\xf1\xcd\x90\xb2"
+			  "\x61\x03\xe6\xe7\xaa\xf3\x5d\xb8"
+			  "\xa7\x54\x6a\x3d\x08\x27\x4f\xf7"
+			  "\x81\x70\x8a\xd3\xda\x98\x14\x39"
+			  "\x36\xc3\x4a\xb5\x0d\xab\xc5\x8a",
+		.rlen	= 496,
+		.np	= 3,
+		.tap	= { 496 - 20, 4, 16 },
 	},
 };
 
@@ -6365,6 +6635,276 @@ static struct cipher_testvec aes_cbc_dec_tv_template[] = {
 			  "\xf6\x9f\x24\x45\xdf\x4f\x9b\x17"
 			  "\xad\x2b\x41\x7b\xe6\x6c\x37\x10",
 		.rlen	= 64,
+	}, { /* 31 blocks: the 8-way path, then a tail */
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x16\x5f\xbc\xe7\x4a\x96\xe1\x46"
+			  "\x8b\x8c\xc5\xad\xca\x57\x34\x5f",
+		.input	= "\xa2\x50\xc6\x6c\x13\xab\xf6\x34"
+			  "\x7d\xfa\x0b\x43\x5a\x50\x48\x41"
+			  "\x22\x36\x0f\xd2\x69\x3a\x1a\x72"
+			  "\xd3\xe4\x15\xf2\x3f\xff\xcc\x06"
+			  "\x0d\x4c\x82\x17\xed\xbf\x9f\x1f"
+			  "\x62\xb0\x36\x3f\x3f\xf8\x4d\x67"
+			  "\x56\x8b\x62\x80\xce\xf9\xa6\x00"
+			  "\x40\x2e\xe0\x70\xc8\x39\xe0\x6a"
+			  "\xa0\xb6\x46\xd6\xd9\x06\x9a\x51"
+			  "\x7b\x80\x43\x3a\xff\x9c\xd6\xbb"
+			  "\x21\x3b\x01\xcd\xb5\x56\x94\x5d"
+			  "\xdd\xb9\x7c\x41\xcb\xfc\x77\x8d"
+			  "\x42\x47\xe8\xe0\x79\x3e\xd0\xd0"
+			  "\x40\x26\xf1\x84\x59\x45\xc0\xd1"
+			  "\xda\xaf\x12\x32\x8c\x76\x1d\x9c"
+			  "\x27\x2e\xa0\x4a\x72\x1f\xa6\x1e"
+			  "\xf3\x92\xd6\xc8\x75\x22\x7e\xd1"
+			  "\xae\x1f\x98\xb4\x7a\xe7\xb9\xb9"
+			  "\x18\x7d\x37\xf1\xe5\x47\xd1\xf9"
+			  "\x96\x30\xfc\x54\x96\x0c\x89\xf1"
+			  "\x3d\xe7\xc8\xc2\xaf\x42\xa1\x7c"
+			  "\x74\x5a\xbb\x7a\xeb\x68\xf5\xab"
+			  "\xd3\x76\xd8\xa4\xc2\xd1\xc3\xe7"
+			  "\x00\x65\x30\x97\x94\xb8\x55\x07"
+			  "\xcc\x87\xbe\x89\x77\x36\x7c\x7e"
+			  "\x24\x19\xcd\x85\xb8\x6f\x5e\x5f"
+			  "\xfb\xe5\x56\x76\x07\x79\xae\xfe"
+			  "\x9c\xee\xad\x57\x38\x4e\x82\x36"
+			  "\xd8\x76\x89\x40\x6b\xe7\xf0\x22"
+			  "\x68\x4c\x4c\x7f\xfa\x97\xd4\xc4"
+			  "\xff\xa8\xb7\x3d\xc6\x8a\x94\xa7"
+			  "\x36\x52\x35\x8e\x31\x57\x60\x17"
+			  "\xdb\x2d\x18\xe8\x0a\xf1\x7e\xb9"
+			  "\xf0\xb9\x1c\x85\x40\x92\x1b\xf3"
+			  "\xb6\xdc\x90\xb6\xc7\x4c\x4b\x91"
+			  "\xbe\x92\xb1\xa1\xb4\x9e\xcb\xa4"
+			  "\xe1\x07\xa5\xcd\x0c\x4b\x82\x3d"
+			  "\xa8\x47\x18\x1e\x82\x57\x5c\x2a"
+			  "\xcf\x30\x20\x23\x21\x61\x74\xba"
+			  "\xf1\x35\x90\xcf\x0d\xd3\x88\xb1"
+			  "\xd6\xcb\x30\x77\x8c\x38\x1e\x05"
+			  "\x3b\xf0\x8f\x2a\x42\x8b\xb8\x3a"
+			  "\x97\x14\x27\x85\xc6\xa4\xd0\x75"
+			  "\x86\x84\x63\x6d\x5a\x1e\x63\x6f"
+			  "\x9a\xea\xdd\xda\xc0\x24\xb6\x33"
+			  "\xe9\x03\xb9\x32\xcb\x89\x45\x30"
+			  "\x42\x75\x4c\xc3\x44\xec\x90\xcd"
+			  "\x8d\x38\xe9\xf1\x52\x85\x54\x9d"
+			  "\x9f\x48\xe1\x23\x79\x51\xa2\xc3"
+			  "\xbb\x57\x43\x02\xd5\x9f\x3d\x2b"
+			  "\x9c\xe2\x4f\x70\xb7\xd0\x65\xa7"
+			  "\xc5\x6b\x0d\xcd\xe8\xa5\x5e\x41"
+			  "\x97\x2a\x78\x6e\x05\x46\x6e\xdd"
+			  "\x6c\x11\x38\x05\x6e\x12\x2b\x3d"
+			  "\x55\x20\xe6\xcc\x24\x92\xeb\xac"
+			  "\x27\x6f\x60\x0e\x78\xdd\x46\x32"
+			  "\x95\xfe\xd0\x5d\x96\x5f\x68\x96"
+			  "\xbe\xb8\x5b\xc1\xf1\xcd\x90\xb2"
+			  "\x61\x03\xe6\xe7\xaa\xf3\x5d\xb8"
+			  "\xa7\x54\x6a\x3d\x08\x27\x4f\xf7"
+			  "\x81\x70\x8a\xd3\xda\x98\x14\x39"
+			  "\x36\xc3\x4a\xb5\x0d\xab\xc5\x8a",
+		.ilen	= 496,
+		.result	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.rlen	= 496,
+	}, {
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x16\x5f\xbc\xe7\x4a\x96\xe1\x46"
+			  "\x8b\x8c\xc5\xad\xca\x57\x34\x5f",
+		.input	= "\xa2\x50\xc6\x6c\x13\xab\xf6\x34"
+			  "\x7d\xfa\x0b\x43\x5a\x50\x48\x41"
+			  "\x22\x36\x0f\xd2\x69\x3a\x1a\x72"
+			  "\xd3\xe4\x15\xf2\x3f\xff\xcc\x06"
+			  "\x0d\x4c\x82\x17\xed\xbf\x9f\x1f"
+			  "\x62\xb0\x36\x3f\x3f\xf8\x4d\x67"
+			  "\x56\x8b\x62\x80\xce\xf9\xa6\x00"
+			  "\x40\x2e\xe0\x70\xc8\x39\xe0\x6a"
+			  "\xa0\xb6\x46\xd6\xd9\x06\x9a\x51"
+			  "\x7b\x80\x43\x3a\xff\x9c\xd6\xbb"
+			  "\x21\x3b\x01\xcd\xb5\x56\x94\x5d"
+			  "\xdd\xb9\x7c\x41\xcb\xfc\x77\x8d"
+			  "\x42\x47\xe8\xe0\x79\x3e\xd0\xd0"
+			  "\x40\x26\xf1\x84\x59\x45\xc0\xd1"
+			  "\xda\xaf\x12\x32\x8c\x76\x1d\x9c"
+			  "\x27\x2e\xa0\x4a\x72\x1f\xa6\x1e"
+			  "\xf3\x92\xd6\xc8\x75\x22\x7e\xd1"
+			  "\xae\x1f\x98\xb4\x7a\xe7\xb9\xb9"
+			  "\x18\x7d\x37\xf1\xe5\x47\xd1\xf9"
+			  "\x96\x30\xfc\x54\x96\x0c\x89\xf1"
+			  "\x3d\xe7\xc8\xc2\xaf\x42\xa1\x7c"
+			  "\x74\x5a\xbb\x7a\xeb\x68\xf5\xab"
+			  "\xd3\x76\xd8\xa4\xc2\xd1\xc3\xe7"
+			  "\x00\x65\x30\x97\x94\xb8\x55\x07"
+			  "\xcc\x87\xbe\x89\x77\x36\x7c\x7e"
+			  "\x24\x19\xcd\x85\xb8\x6f\x5e\x5f"
+			  "\xfb\xe5\x56\x76\x07\x79\xae\xfe"
+			  "\x9c\xee\xad\x57\x38\x4e\x82\x36"
+			  "\xd8\x76\x89\x40\x6b\xe7\xf0\x22"
+			  "\x68\x4c\x4c\x7f\xfa\x97\xd4\xc4"
+			  "\xff\xa8\xb7\x3d\xc6\x8a\x94\xa7"
+			  "\x36\x52\x35\x8e\x31\x57\x60\x17"
+			  "\xdb\x2d\x18\xe8\x0a\xf1\x7e\xb9"
+			  "\xf0\xb9\x1c\x85\x40\x92\x1b\xf3"
+			  "\xb6\xdc\x90\xb6\xc7\x4c\x4b\x91"
+			  "\xbe\x92\xb1\xa1\xb4\x9e\xcb\xa4"
+			  "\xe1\x07\xa5\xcd\x0c\x4b\x82\x3d"
+			  "\xa8\x47\x18\x1e\x82\x57\x5c\x2a"
+			  "\xcf\x30\x20\x23\x21\x61\x74\xba"
+			  "\xf1\x35\x90\xcf\x0d\xd3\x88\xb1"
+			  "\xd6\xcb\x30\x77\x8c\x38\x1e\x05"
+			  "\x3b\xf0\x8f\x2a\x42\x8b\xb8\x3a"
+			  "\x97\x14\x27\x85\xc6\xa4\xd0\x75"
+			  "\x86\x84\x63\x6d\x5a\x1e\x63\x6f"
+			  "\x9a\xea\xdd\xda\xc0\x24\xb6\x33"
+			  "\xe9\x03\xb9\x32\xcb\x89\x45\x30"
+			  "\x42\x75\x4c\xc3\x44\xec\x90\xcd"
+			  "\x8d\x38\xe9\xf1\x52\x85\x54\x9d"
+			  "\x9f\x48\xe1\x23\x79\x51\xa2\xc3"
+			  "\xbb\x57\x43\x02\xd5\x9f\x3d\x2b"
+			  "\x9c\xe2\x4f\x70\xb7\xd0\x65\xa7"
+			  "\xc5\x6b\x0d\xcd\xe8\xa5\x5e\x41"
+			  "\x97\x2a\x78\x6e\x05\x46\x6e\xdd"
+			  "\x6c\x11\x38\x05\x6e\x12\x2b\x3d"
+			  "\x55\x20\xe6\xcc\x24\x92\xeb\xac"
+			  "\x27\x6f\x60\x0e\x78\xdd\x46\x32"
+			  "\x95\xfe\xd0\x5d\x96\x5f\x68\x96"
+			  "\xbe\xb8\x5b\xc1\xf1\xcd\x90\xb2"
+			  "\x61\x03\xe6\xe7\xaa\xf3\x5d\xb8"
+			  "\xa7\x54\x6a\x3d\x08\x27\x4f\xf7"
+			  "\x81\x70\x8a\xd3\xda\x98\x14\x39"
+			  "\x36\xc3\x4a\xb5\x0d\xab\xc5\x8a",
+		.ilen	= 496,
+		.result	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.rlen	= 496,
+		.np	= 3,
+		.tap	= { 496 - 20, 4, 16 },
 	},
 };
 
@@ -7629,7 +8169,411 @@ static struct cipher_testvec aes_ctr_enc_tv_template[] = {
 			  "\xdf\xc9\xc5\x8d\xb6\x7a\xad\xa6"
 			  "\x13\xc2\xdd\x08\x45\x79\x41\xa6",
 		.rlen	= 64,
-	}
+	}, { /* 31 blocks: the 8-way path, then a tail */
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x45\xc2\xa6\xd5\x38\x13\xc0\xf6"
+			  "\x8c\x57\x5c\x40\xd6\x07\xe3\x81",
+		.input	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.ilen	= 496,
+		.result	= "\xdc\x45\xf5\xc0\x57\x96\x83\x4f"
+			  "\xdf\xf2\xa2\x74\xbf\x80\x01\xf0"
+			  "\x6c\x22\x65\x8b\xd0\x2e\x39\x8c"
+			  "\x97\x1d\xbc\x10\x9b\x0b\xcd\x84"
+			  "\x11\x87\xbe\xea\x2c\x1d\xb9\x90"
+			  "\x0f\x3f\xd0\xba\x53\x3d\x17\xdd"
+			  "\x73\xc4\x39\x14\xc3\x54\xca\x9b"
+			  "\x6c\xc4\x2f\x5d\x1b\xb7\x54\x5f"
+			  "\x7c\x7b\x99\x44\x9b\x11\x29\x35"
+			  "\x2d\x4e\x03\x25\x19\x9c\xa9\x20"
+			  "\xb3\xdd\x75\x01\xe7\xc3\x83\xff"
+			  "\xb7\x10\xcd\xad\x1f\x82\xbb\xe3"
+			  "\x69\x44\x53\xbe\xe8\xb2\xf0\xb1"
+			  "\x5b\x09\x23\x74\x9a\x9a\x89\x75"
+			  "\xae\x4c\xc3\x6c\xb9\x4f\x53\x60"
+			  "\xef\x81\x4a\xe8\x67\xca\xd9\xb7"
+			  "\x17\x39\xb7\x16\xcb\xa2\xa5\xa8"
+			  "\x7b\xb3\x66\x59\xd9\x62\x47\x03"
+			  "\x1c\x77\xb6\xeb\xf1\x7c\xb1\xcf"
+			  "\x54\x09\xcb\xd0\xaf\xef\xbc\xe7"
+			  "\xae\xe6\xa7\x88\x11\xec\xfe\x07"
+			  "\xfa\x8c\x1c\x16\x01\x5e\x56\xf7"
+			  "\xe5\x3d\xb7\x8b\x4e\x74\xd9\x9d"
+			  "\xa0\xb3\x50\x22\x8e\xde\xc1\x61"
+			  "\x18\x7b\x73\x03\x2f\x20\x23\xca"
+			  "\xe7\x1a\x89\x1d\x95\x2a\x71\x64"
+			  "\xfa\xd8\xfc\x48\xb7\x6e\xff\x23"
+			  "\x62\xba\x84\x87\x46\x8e\x82\xb7"
+			  "\xd1\x4d\x71\x86\xc8\x6c\xb4\xfa"
+			  "\xb6\xec\x77\xa8\x01\xbe\x6c\xfd"
+			  "\x49\x63\xfd\x05\x55\x81\x6b\x60"
+			  "\x29\x5e\xe0\xf4\x5d\xa4\x3f\xb1"
+			  "\x81\x98\x59\xc2\x0e\xfd\x19\x0b"
+			  "\xab\xd6\x67\x12\x44\xf1\x1c\x6d"
+			  "\x2e\x24\x99\xce\x1c\x4e\x32\x49"
+			  "\x12\x2a\x8f\x41\x1e\xb0\x6b\xf4"
+			  "\x01\x98\x81\xc7\x8b\x63\xd7\x7b"
+			  "\xaa\xa0\x1e\x9b\xbb\xba\x91\xe8"
+			  "\x93\x71\xa0\x0c\x97\x6c\x6d\x39"
+			  "\xbe\x68\x85\xb0\x30\x9e\x57\x02"
+			  "\x83\x20\x5b\xc3\x37\x1f\x13\x28"
+			  "\x32\xaa\x97\x75\x6e\xcb\x54\x6b"
+			  "\xa7\xd4\x8d\x2b\x00\xc2\xca\xe4"
+			  "\xf7\xe6\x9b\x51\x73\x62\x68\xa6"
+			  "\x62\x90\x9e\x30\x00\x16\x98\x78"
+			  "\x23\x26\x22\x8f\x69\x88\xd1\x25"
+			  "\x17\x13\xa2\xf5\x8b\x4b\xad\xa4"
+			  "\x8f\x3f\x12\x16\x55\xd4\xb1\xcd"
+			  "\xee\x6c\x25\x3e\x5a\xe2\xfb\x1a"
+			  "\x8a\xd7\x16\xf9\xd2\x5b\x1f\x18"
+			  "\x4a\x09\xa7\x3b\xf1\xaf\x66\x4e"
+			  "\x17\x66\x98\xc6\x58\xc7\xfe\x78"
+			  "\xb9\x76\x1a\xc9\xfc\xa8\x55\x43"
+			  "\xec\x85\xf3\x26\xbd\xee\x38\x1d"
+			  "\x39\x20\xdf\x52\x24\x9c\xfc\xfe"
+			  "\x4b\x3d\x30\x36\x5f\xe5\x8b\x6b"
+			  "\x13\xf8\x5a\x3f\x24\x2a\xdf\x22"
+			  "\x23\x65\x6f\xef\x7e\x06\xaf\x0f"
+			  "\xd3\x79\x0f\xd6\xaf\xca\x59\x52"
+			  "\xad\xc5\x98\x18\x63\xff\x40\x53"
+			  "\x26\xf2\x70\x6c\xcf\x11\xb8\x24"
+			  "\x43\x91\x5a\xe9\xc1\x68\x19\xc8",
+		.rlen	= 496,
+	}, {
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x45\xc2\xa6\xd5\x38\x13\xc0\xf6"
+			  "\x8c\x57\x5c\x40\xd6\x07\xe3\x81",
+		.input	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.ilen	= 496,
+		.result	= "\xdc\x45\xf5\xc0\x57\x96\x83\x4f"
+			  "\xdf\xf2\xa2\x74\xbf\x80\x01\xf0"
+			  "\x6c\x22\x65\x8b\xd0\x2e\x39\x8c"
+			  "\x97\x1d\xbc\x10\x9b\x0b\xcd\x84"
+			  "\x11\x87\xbe\xea\x2c\x1d\xb9\x90"
+			  "\x0f\x3f\xd0\xba\x53\x3d\x17\xdd"
+			  "\x73\xc4\x39\x14\xc3\x54\xca\x9b"
+			  "\x6c\xc4\x2f\x5d\x1b\xb7\x54\x5f"
+			  "\x7c\x7b\x99\x44\x9b\x11\x29\x35"
+			  "\x2d\x4e\x03\x25\x19\x9c\xa9\x20"
+			  "\xb3\xdd\x75\x01\xe7\xc3\x83\xff"
+			  "\xb7\x10\xcd\xad\x1f\x82\xbb\xe3"
+			  "\x69\x44\x53\xbe\xe8\xb2\xf0\xb1"
+			  "\x5b\x09\x23\x74\x9a\x9a\x89\x75"
+			  "\xae\x4c\xc3\x6c\xb9\x4f\x53\x60"
+			  "\xef\x81\x4a\xe8\x67\xca\xd9\xb7"
+			  "\x17\x39\xb7\x16\xcb\xa2\xa5\xa8"
+			  "\x7b\xb3\x66\x59\xd9\x62\x47\x03"
+			  "\x1c\x77\xb6\xeb\xf1\x7c\xb1\xcf"
+			  "\x54\x09\xcb\xd0\xaf\xef\xbc\xe7"
+			  "\xae\xe6\xa7\x88\x11\xec\xfe\x07"
+			  "\xfa\x8c\x1c\x16\x01\x5e\x56\xf7"
+			  "\xe5\x3d\xb7\x8b\x4e\x74\xd9\x9d"
+			  "\xa0\xb3\x50\x22\x8e\xde\xc1\x61"
+			  "\x18\x7b\x73\x03\x2f\x20\x23\xca"
+			  "\xe7\x1a\x89\x1d\x95\x2a\x71\x64"
+			  "\xfa\xd8\xfc\x48\xb7\x6e\xff\x23"
+			  "\x62\xba\x84\x87\x46\x8e\x82\xb7"
+			  "\xd1\x4d\x71\x86\xc8\x6c\xb4\xfa"
+			  "\xb6\xec\x77\xa8\x01\xbe\x6c\xfd"
+			  "\x49\x63\xfd\x05\x55\x81\x6b\x60"
+			  "\x29\x5e\xe0\xf4\x5d\xa4\x3f\xb1"
+			  "\x81\x98\x59\xc2\x0e\xfd\x19\x0b"
+			  "\xab\xd6\x67\x12\x44\xf1\x1c\x6d"
+			  "\x2e\x24\x99\xce\x1c\x4e\x32\x49"
+			  "\x12\x2a\x8f\x41\x1e\xb0\x6b\xf4"
+			  "\x01\x98\x81\xc7\x8b\x63\xd7\x7b"
+			  "\xaa\xa0\x1e\x9b\xbb\xba\x91\xe8"
+			  "\x93\x71\xa0\x0c\x97\x6c\x6d\x39"
+			  "\xbe\x68\x85\xb0\x30\x9e\x57\x02"
+			  "\x83\x20\x5b\xc3\x37\x1f\x13\x28"
+			  "\x32\xaa\x97\x75\x6e\xcb\x54\x6b"
+			  "\xa7\xd4\x8d\x2b\x00\xc2\xca\xe4"
+			  "\xf7\xe6\x9b\x51\x73\x62\x68\xa6"
+			  "\x62\x90\x9e\x30\x00\x16\x98\x78"
+			  "\x23\x26\x22\x8f\x69\x88\xd1\x25"
+			  "\x17\x13\xa2\xf5\x8b\x4b\xad\xa4"
+			  "\x8f\x3f\x12\x16\x55\xd4\xb1\xcd"
+			  "\xee\x6c\x25\x3e\x5a\xe2\xfb\x1a"
+			  "\x8a\xd7\x16\xf9\xd2\x5b\x1f\x18"
+			  "\x4a\x09\xa7\x3b\xf1\xaf\x66\x4e"
+			  "\x17\x66\x98\xc6\x58\xc7\xfe\x78"
+			  "\xb9\x76\x1a\xc9\xfc\xa8\x55\x43"
+			  "\xec\x85\xf3\x26\xbd\xee\x38\x1d"
+			  "\x39\x20\xdf\x52\x24\x9c\xfc\xfe"
+			  "\x4b\x3d\x30\x36\x5f\xe5\x8b\x6b"
+			  "\x13\xf8\x5a\x3f\x24\x2a\xdf\x22"
+			  "\x23\x65\x6f\xef\x7e\x06\xaf\x0f"
+			  "\xd3\x79\x0f\xd6\xaf\xca\x59\x52"
+			  "\xad\xc5\x98\x18\x63\xff\x40\x53"
+			  "\x26\xf2\x70\x6c\xcf\x11\xb8\x24"
+			  "\x43\x91\x5a\xe9\xc1\x68\x19\xc8",
+		.rlen	= 496,
+		.np	= 3,
+		.tap	= { 496 - 20, 4, 16 },
+	}, { /* counter wraps the low 64 bits in the first batch */
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x01\x23\x45\x67\x89\xab\xcd\xef"
+			  "\xff\xff\xff\xff\xff\xff\xff\xfd",
+		.input	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.ilen	= 496,
+		.result	= "\xa9\x7f\xfd\x67\xfe\x48\x5b\x7b"
+			  "\x69\xa4\xa0\x8b\xe2\xeb\x46\x5a"
+			  "\x74\xe4\x2b\x0c\x83\xc1\x89\x1f"
+			  "\xac\xfe\xb0\x15\xaa\x4b\xf8\xcd"
+			  "\x4f\xaf\x7d\x69\x70\xff\x00\x4a"
+			  "\xd0\xe7\xa7\x95\x6e\xfe\x8a\xc5"
+			  "\xcb\xd9\x04\x44\xfa\x0a\x12\xec"
+			  "\x88\xee\x80\x97\x77\xdb\xae\x1c"
+			  "\xec\x80\xee\xf0\xbe\xb8\x33\xec"
+			  "\x47\x83\xc7\xe1\x63\x88\xb1\xea"
+			  "\xa5\x01\x06\x15\xd9\x1e\x80\xb4"
+			  "\x34\x24\x98\x74\x6e\xba\x64\xa0"
+			  "\x8a\x73\xaa\xbe\x18\x1d\xad\x0f"
+			  "\xda\x20\x6d\x02\x59\x58\x27\x28"
+			  "\xe4\x49\x5a\x77\x1c\x8c\xab\xa7"
+			  "\xf3\x4a\x94\x33\x12\x49\xe9\x50"
+			  "\xda\xea\x30\x4f\x80\x53\xa3\xf2"
+			  "\x2b\x41\xe8\xd2\xf2\x46\x5b\xdc"
+			  "\x90\x32\xe3\x7a\x8b\xc8\xea\xec"
+			  "\x88\xc7\x16\x68\xb5\x43\x12\x93"
+			  "\x16\xd0\xd9\xa4\xa6\x98\x5b\x05"
+			  "\xaf\x1d\x57\xbf\x95\x56\xea\x6c"
+			  "\xbd\x36\x74\xe1\xff\x26\x7a\x03"
+			  "\x6c\x85\x4f\x7a\xef\x9f\x4f\xb5"
+			  "\xdf\xde\x86\x81\x44\xdc\xfe\x01"
+			  "\x16\x38\x4e\xc2\x15\x13\x5f\x2a"
+			  "\x32\x39\xe2\xde\x60\x7e\x32\x3c"
+			  "\xab\x1a\xb0\xb2\xe9\xde\x52\xed"
+			  "\xca\xad\x6b\x07\xbc\x21\xbe\x26"
+			  "\xd1\x06\xc9\x03\xbf\xe9\x68\x70"
+			  "\xd4\xb8\x92\x08\xe8\x63\xe8\xb4"
+			  "\x51\xea\x1e\xf1\xa7\x98\x83\x06"
+			  "\xf4\xd3\x8a\xd3\x0a\x92\x1e\x72"
+			  "\xae\x9b\xe4\xc7\x9b\x5e\xf4\x36"
+			  "\x8e\xc3\x6d\x26\x16\xe5\x56\xfe"
+			  "\xa2\xe1\x66\x67\x11\xd0\x3e\xa8"
+			  "\xfc\xd1\x21\xdb\x51\x4f\x14\xb4"
+			  "\x31\x07\xc6\x09\x56\x0b\x23\x1c"
+			  "\x1d\x79\xf6\x9b\x40\x05\x4c\xf1"
+			  "\x71\x1b\x66\xd9\xa9\x34\x4a\x7a"
+			  "\xd3\x83\x55\xde\x32\xec\xcb\xd8"
+			  "\x3c\x77\x0f\x85\xd4\xbb\x51\xba"
+			  "\x68\x1e\x25\x74\xee\x82\xcd\xd8"
+			  "\xa9\x15\xc7\x82\x15\x9d\x0d\xdd"
+			  "\x6d\x52\x8b\x6d\x23\x56\xee\x1b"
+			  "\xd4\xd8\x81\x33\x51\xd9\x67\x6f"
+			  "\xaa\x5a\xf4\x72\xe4\x5d\x65\xde"
+			  "\x7e\x98\x88\x7a\xbe\xb6\x6f\x27"
+			  "\x33\x0a\x79\x72\xf0\x4f\x35\xdd"
+			  "\x2c\x56\xe0\x5e\x4c\x24\x02\x91"
+			  "\x66\x3d\xc2\xf4\xe8\x0d\x4b\xc5"
+			  "\xa9\x82\x02\xb4\x9b\x74\x71\x5a"
+			  "\x38\x42\xbd\xd5\x77\xec\x42\x00"
+			  "\x2c\xd3\x5d\xba\x98\x7b\x31\xe9"
+			  "\xf9\x6c\x08\xcc\xa0\x3d\xe3\x07"
+			  "\xec\xe0\x37\xbf\xc1\x39\x5f\x6b"
+			  "\x5d\x37\x07\x59\x50\xf3\x4a\xb9"
+			  "\x99\x16\x75\x1d\x69\xdd\x8b\x75"
+			  "\x4e\x20\x18\xda\xcd\x7e\x60\x0c"
+			  "\xc1\xee\xdc\x5e\x7f\xf4\x2d\x44"
+			  "\x62\x71\x0e\x7d\xa6\xd4\xed\x0c"
+			  "\xe2\xfd\xd4\xbe\x39\x12\x0f\xeb",
+		.rlen	= 496,
+	},
 };
 
 static struct cipher_testvec aes_ctr_dec_tv_template[] = {
@@ -7708,7 +8652,411 @@ static struct cipher_testvec aes_ctr_dec_tv_template[] = {
 			  "\xf6\x9f\x24\x45\xdf\x4f\x9b\x17"
 			  "\xad\x2b\x41\x7b\xe6\x6c\x37\x10",
 		.rlen	= 64,
-	}
+	}, { /* 31 blocks: the 8-way path, then a tail */
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x45\xc2\xa6\xd5\x38\x13\xc0\xf6"
+			  "\x8c\x57\x5c\x40\xd6\x07\xe3\x81",
+		.input	= "\xdc\x45\xf5\xc0\x57\x96\x83\x4f"
+			  "\xdf\xf2\xa2\x74\xbf\x80\x01\xf0"
+			  "\x6c\x22\x65\x8b\xd0\x2e\x39\x8c"
+			  "\x97\x1d\xbc\x10\x9b\x0b\xcd\x84"
+			  "\x11\x87\xbe\xea\x2c\x1d\xb9\x90"
+			  "\x0f\x3f\xd0\xba\x53\x3d\x17\xdd"
+			  "\x73\xc4\x39\x14\xc3\x54\xca\x9b"
+			  "\x6c\xc4\x2f\x5d\x1b\xb7\x54\x5f"
+			  "\x7c\x7b\x99\x44\x9b\x11\x29\x35"
+			  "\x2d\x4e\x03\x25\x19\x9c\xa9\x20"
+			  "\xb3\xdd\x75\x01\xe7\xc3\x83\xff"
+			  "\xb7\x10\xcd\xad\x1f\x82\xbb\xe3"
+			  "\x69\x44\x53\xbe\xe8\xb2\xf0\xb1"
+			  "\x5b\x09\x23\x74\x9a\x9a\x89\x75"
+			  "\xae\x4c\xc3\x6c\xb9\x4f\x53\x60"
+			  "\xef\x81\x4a\xe8\x67\xca\xd9\xb7"
+			  "\x17\x39\xb7\x16\xcb\xa2\xa5\xa8"
+			  "\x7b\xb3\x66\x59\xd9\x62\x47\x03"
+			  "\x1c\x77\xb6\xeb\xf1\x7c\xb1\xcf"
+			  "\x54\x09\xcb\xd0\xaf\xef\xbc\xe7"
+			  "\xae\xe6\xa7\x88\x11\xec\xfe\x07"
+			  "\xfa\x8c\x1c\x16\x01\x5e\x56\xf7"
+			  "\xe5\x3d\xb7\x8b\x4e\x74\xd9\x9d"
+			  "\xa0\xb3\x50\x22\x8e\xde\xc1\x61"
+			  "\x18\x7b\x73\x03\x2f\x20\x23\xca"
+			  "\xe7\x1a\x89\x1d\x95\x2a\x71\x64"
+			  "\xfa\xd8\xfc\x48\xb7\x6e\xff\x23"
+			  "\x62\xba\x84\x87\x46\x8e\x82\xb7"
+			  "\xd1\x4d\x71\x86\xc8\x6c\xb4\xfa"
+			  "\xb6\xec\x77\xa8\x01\xbe\x6c\xfd"
+			  "\x49\x63\xfd\x05\x55\x81\x6b\x60"
+			  "\x29\x5e\xe0\xf4\x5d\xa4\x3f\xb1"
+			  "\x81\x98\x59\xc2\x0e\xfd\x19\x0b"
+			  "\xab\xd6\x67\x12\x44\xf1\x1c\x6d"
+			  "\x2e\x24\x99\xce\x1c\x4e\x32\x49"
+			  "\x12\x2a\x8f\x41\x1e\xb0\x6b\xf4"
+			  "\x01\x98\x81\xc7\x8b\x63\xd7\x7b"
+			  "\xaa\xa0\x1e\x9b\xbb\xba\x91\xe8"
+			  "\x93\x71\xa0\x0c\x97\x6c\x6d\x39"
+			  "\xbe\x68\x85\xb0\x30\x9e\x57\x02"
+			  "\x83\x20\x5b\xc3\x37\x1f\x13\x28"
+			  "\x32\xaa\x97\x75\x6e\xcb\x54\x6b"
+			  "\xa7\xd4\x8d\x2b\x00\xc2\xca\xe4"
+			  "\xf7\xe6\x9b\x51\x73\x62\x68\xa6"
+			  "\x62\x90\x9e\x30\x00\x16\x98\x78"
+			  "\x23\x26\x22\x8f\x69\x88\xd1\x25"
+			  "\x17\x13\xa2\xf5\x8b\x4b\xad\xa4"
+			  "\x8f\x3f\x12\x16\x55\xd4\xb1\xcd"
+			  "\xee\x6c\x25\x3e\x5a\xe2\xfb\x1a"
+			  "\x8a\xd7\x16\xf9\xd2\x5b\x1f\x18"
+			  "\x4a\x09\xa7\x3b\xf1\xaf\x66\x4e"
+			  "\x17\x66\x98\xc6\x58\xc7\xfe\x78"
+			  "\xb9\x76\x1a\xc9\xfc\xa8\x55\x43"
+			  "\xec\x85\xf3\x26\xbd\xee\x38\x1d"
+			  "\x39\x20\xdf\x52\x24\x9c\xfc\xfe"
+			  "\x4b\x3d\x30\x36\x5f\xe5\x8b\x6b"
+			  "\x13\xf8\x5a\x3f\x24\x2a\xdf\x22"
+			  "\x23\x65\x6f\xef\x7e\x06\xaf\x0f"
+			  "\xd3\x79\x0f\xd6\xaf\xca\x59\x52"
+			  "\xad\xc5\x98\x18\x63\xff\x40\x53"
+			  "\x26\xf2\x70\x6c\xcf\x11\xb8\x24"
+			  "\x43\x91\x5a\xe9\xc1\x68\x19\xc8",
+		.ilen	= 496,
+		.result	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.rlen	= 496,
+	}, {
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x45\xc2\xa6\xd5\x38\x13\xc0\xf6"
+			  "\x8c\x57\x5c\x40\xd6\x07\xe3\x81",
+		.input	= "\xdc\x45\xf5\xc0\x57\x96\x83\x4f"
+			  "\xdf\xf2\xa2\x74\xbf\x80\x01\xf0"
+			  "\x6c\x22\x65\x8b\xd0\x2e\x39\x8c"
+			  "\x97\x1d\xbc\x10\x9b\x0b\xcd\x84"
+			  "\x11\x87\xbe\xea\x2c\x1d\xb9\x90"
+			  "\x0f\x3f\xd0\xba\x53\x3d\x17\xdd"
+			  "\x73\xc4\x39\x14\xc3\x54\xca\x9b"
+			  "\x6c\xc4\x2f\x5d\x1b\xb7\x54\x5f"
+			  "\x7c\x7b\x99\x44\x9b\x11\x29\x35"
+			  "\x2d\x4e\x03\x25\x19\x9c\xa9\x20"
+			  "\xb3\xdd\x75\x01\xe7\xc3\x83\xff"
+			  "\xb7\x10\xcd\xad\x1f\x82\xbb\xe3"
+			  "\x69\x44\x53\xbe\xe8\xb2\xf0\xb1"
+			  "\x5b\x09\x23\x74\x9a\x9a\x89\x75"
+			  "\xae\x4c\xc3\x6c\xb9\x4f\x53\x60"
+			  "\xef\x81\x4a\xe8\x67\xca\xd9\xb7"
+			  "\x17\x39\xb7\x16\xcb\xa2\xa5\xa8"
+			  "\x7b\xb3\x66\x59\xd9\x62\x47\x03"
+			  "\x1c\x77\xb6\xeb\xf1\x7c\xb1\xcf"
+			  "\x54\x09\xcb\xd0\xaf\xef\xbc\xe7"
+			  "\xae\xe6\xa7\x88\x11\xec\xfe\x07"
+			  "\xfa\x8c\x1c\x16\x01\x5e\x56\xf7"
+			  "\xe5\x3d\xb7\x8b\x4e\x74\xd9\x9d"
+			  "\xa0\xb3\x50\x22\x8e\xde\xc1\x61"
+			  "\x18\x7b\x73\x03\x2f\x20\x23\xca"
+			  "\xe7\x1a\x89\x1d\x95\x2a\x71\x64"
+			  "\xfa\xd8\xfc\x48\xb7\x6e\xff\x23"
+			  "\x62\xba\x84\x87\x46\x8e\x82\xb7"
+			  "\xd1\x4d\x71\x86\xc8\x6c\xb4\xfa"
+			  "\xb6\xec\x77\xa8\x01\xbe\x6c\xfd"
+			  "\x49\x63\xfd\x05\x55\x81\x6b\x60"
+			  "\x29\x5e\xe0\xf4\x5d\xa4\x3f\xb1"
+			  "\x81\x98\x59\xc2\x0e\xfd\x19\x0b"
+			  "\xab\xd6\x67\x12\x44\xf1\x1c\x6d"
+			  "\x2e\x24\x99\xce\x1c\x4e\x32\x49"
+			  "\x12\x2a\x8f\x41\x1e\xb0\x6b\xf4"
+			  "\x01\x98\x81\xc7\x8b\x63\xd7\x7b"
+			  "\xaa\xa0\x1e\x9b\xbb\xba\x91\xe8"
+			  "\x93\x71\xa0\x0c\x97\x6c\x6d\x39"
+			  "\xbe\x68\x85\xb0\x30\x9e\x57\x02"
+			  "\x83\x20\x5b\xc3\x37\x1f\x13\x28"
+			  "\x32\xaa\x97\x75\x6e\xcb\x54\x6b"
+			  "\xa7\xd4\x8d\x2b\x00\xc2\xca\xe4"
+			  "\xf7\xe6\x9b\x51\x73\x62\x68\xa6"
+			  "\x62\x90\x9e\x30\x00\x16\x98\x78"
+			  "\x23\x26\x22\x8f\x69\x88\xd1\x25"
+			  "\x17\x13\xa2\xf5\x8b\x4b\xad\xa4"
+			  "\x8f\x3f\x12\x16\x55\xd4\xb1\xcd"
+			  "\xee\x6c\x25\x3e\x5a\xe2\xfb\x1a"
+			  "\x8a\xd7\x16\xf9\xd2\x5b\x1f\x18"
+			  "\x4a\x09\xa7\x3b\xf1\xaf\x66\x4e"
+			  "\x17\x66\x98\xc6\x58\xc7\xfe\x78"
+			  "\xb9\x76\x1a\xc9\xfc\xa8\x55\x43"
+			  "\xec\x85\xf3\x26\xbd\xee\x38\x1d"
+			  "\x39\x20\xdf\x52\x24\x9c\xfc\xfe"
+			  "\x4b\x3d\x30\x36\x5f\xe5\x8b\x6b"
+			  "\x13\xf8\x5a\x3f\x24\x2a\xdf\x22"
+			  "\x23\x65\x6f\xef\x7e\x06\xaf\x0f"
+			  "\xd3\x79\x0f\xd6\xaf\xca\x59\x52"
+			  "\xad\xc5\x98\x18\x63\xff\x40\x53"
+			  "\x26\xf2\x70\x6c\xcf\x11\xb8\x24"
+			  "\x43\x91\x5a\xe9\xc1\x68\x19\xc8",
+		.ilen	= 496,
+		.result	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.rlen	= 496,
+		.np	= 3,
+		.tap	= { 496 - 20, 4, 16 },
+	}, { /* counter wraps the low 64 bits in the first batch */
+		.key	= "\xdc\x1f\x67\xf2\xbd\x83\x92\xce"
+			  "\x9b\x65\x63\x4c\x8c\x20\x11\xa4"
+			  "\x92\xb4\x93\x0d\x16\x0e\x88\xd5"
+			  "\x3d\xa7\x5d\x42\x0f\x1a\xf9\x44",
+		.klen	= 32,
+		.iv	= "\x01\x23\x45\x67\x89\xab\xcd\xef"
+			  "\xff\xff\xff\xff\xff\xff\xff\xfd",
+		.input	= "\xa9\x7f\xfd\x67\xfe\x48\x5b\x7b"
+			  "\x69\xa4\xa0\x8b\xe2\xeb\x46\x5a"
+			  "\x74\xe4\x2b\x0c\x83\xc1\x89\x1f"
+			  "\xac\xfe\xb0\x15\xaa\x4b\xf8\xcd"
+			  "\x4f\xaf\x7d\x69\x70\xff\x00\x4a"
+			  "\xd0\xe7\xa7\x95\x6e\xfe\x8a\xc5"
+			  "\xcb\xd9\x04\x44\xfa\x0a\x12\xec"
+			  "\x88\xee\x80\x97\x77\xdb\xae\x1c"
+			  "\xec\x80\xee\xf0\xbe\xb8\x33\xec"
+			  "\x47\x83\xc7\xe1\x63\x88\xb1\xea"
+			  "\xa5\x01\x06\x15\xd9\x1e\x80\xb4"
+			  "\x34\x24\x98\x74\x6e\xba\x64\xa0"
+			  "\x8a\x73\xaa\xbe\x18\x1d\xad\x0f"
+			  "\xda\x20\x6d\x02\x59\x58\x27\x28"
+			  "\xe4\x49\x5a\x77\x1c\x8c\xab\xa7"
+			  "\xf3\x4a\x94\x33\x12\x49\xe9\x50"
+			  "\xda\xea\x30\x4f\x80\x53\xa3\xf2"
+			  "\x2b\x41\xe8\xd2\xf2\x46\x5b\xdc"
+			  "\x90\x32\xe3\x7a\x8b\xc8\xea\xec"
+			  "\x88\xc7\x16\x68\xb5\x43\x12\x93"
+			  "\x16\xd0\xd9\xa4\xa6\x98\x5b\x05"
+			  "\xaf\x1d\x57\xbf\x95\x56\xea\x6c"
+			  "\xbd\x36\x74\xe1\xff\x26\x7a\x03"
+			  "\x6c\x85\x4f\x7a\xef\x9f\x4f\xb5"
+			  "\xdf\xde\x86\x81\x44\xdc\xfe\x01"
+			  "\x16\x38\x4e\xc2\x15\x13\x5f\x2a"
+			  "\x32\x39\xe2\xde\x60\x7e\x32\x3c"
+			  "\xab\x1a\xb0\xb2\xe9\xde\x52\xed"
+			  "\xca\xad\x6b\x07\xbc\x21\xbe\x26"
+			  "\xd1\x06\xc9\x03\xbf\xe9\x68\x70"
+			  "\xd4\xb8\x92\x08\xe8\x63\xe8\xb4"
+			  "\x51\xea\x1e\xf1\xa7\x98\x83\x06"
+			  "\xf4\xd3\x8a\xd3\x0a\x92\x1e\x72"
+			  "\xae\x9b\xe4\xc7\x9b\x5e\xf4\x36"
+			  "\x8e\xc3\x6d\x26\x16\xe5\x56\xfe"
+			  "\xa2\xe1\x66\x67\x11\xd0\x3e\xa8"
+			  "\xfc\xd1\x21\xdb\x51\x4f\x14\xb4"
+			  "\x31\x07\xc6\x09\x56\x0b\x23\x1c"
+			  "\x1d\x79\xf6\x9b\x40\x05\x4c\xf1"
+			  "\x71\x1b\x66\xd9\xa9\x34\x4a\x7a"
+			  "\xd3\x83\x55\xde\x32\xec\xcb\xd8"
+			  "\x3c\x77\x0f\x85\xd4\xbb\x51\xba"
+			  "\x68\x1e\x25\x74\xee\x82\xcd\xd8"
+			  "\xa9\x15\xc7\x82\x15\x9d\x0d\xdd"
+			  "\x6d\x52\x8b\x6d\x23\x56\xee\x1b"
+			  "\xd4\xd8\x81\x33\x51\xd9\x67\x6f"
+			  "\xaa\x5a\xf4\x72\xe4\x5d\x65\xde"
+			  "\x7e\x98\x88\x7a\xbe\xb6\x6f\x27"
+			  "\x33\x0a\x79\x72\xf0\x4f\x35\xdd"
+			  "\x2c\x56\xe0\x5e\x4c\x24\x02\x91"
+			  "\x66\x3d\xc2\xf4\xe8\x0d\x4b\xc5"
+			  "\xa9\x82\x02\xb4\x9b\x74\x71\x5a"
+			  "\x38\x42\xbd\xd5\x77\xec\x42\x00"
+			  "\x2c\xd3\x5d\xba\x98\x7b\x31\xe9"
+			  "\xf9\x6c\x08\xcc\xa0\x3d\xe3\x07"
+			  "\xec\xe0\x37\xbf\xc1\x39\x5f\x6b"
+			  "\x5d\x37\x07\x59\x50\xf3\x4a\xb9"
+			  "\x99\x16\x75\x1d\x69\xdd\x8b\x75"
+			  "\x4e\x20\x18\xda\xcd\x7e\x60\x0c"
+			  "\xc1\xee\xdc\x5e\x7f\xf4\x2d\x44"
+			  "\x62\x71\x0e\x7d\xa6\xd4\xed\x0c"
+			  "\xe2\xfd\xd4\xbe\x39\x12\x0f\xeb",
+		.ilen	= 496,
+		.result	= "\x2a\xf5\x30\x74\x5f\x0a\x34\x09"
+			  "\xc6\x0d\x0d\x1b\x40\xb3\x2b\xbb"
+			  "\x55\x4e\xb4\xaf\xa5\x9d\x7a\xf0"
+			  "\xf8\x90\xc7\xa8\xc7\xfe\x1b\x4a"
+			  "\xd3\x80\x7e\xbd\x5c\x7f\x29\x0e"
+			  "\x3e\xe7\x6e\x99\xe4\x6e\x75\xc1"
+			  "\x61\xbc\xf4\xa3\x35\xcd\x12\x56"
+			  "\xdd\xbc\xc2\xbe\xeb\x71\xfe\x5f"
+			  "\x4a\x89\x82\xd7\xde\xbb\xc7\xd9"
+			  "\x54\x93\x15\xc0\xc8\xfd\x1c\xa8"
+			  "\x8b\x8c\x0a\xb1\x95\xce\x67\xbb"
+			  "\xde\xa9\xc1\x32\x3c\x2b\x0f\x90"
+			  "\xd1\x07\x56\x79\xda\x52\xef\xf2"
+			  "\x50\x8e\xc3\x82\x6d\x36\x98\x6c"
+			  "\xae\x10\x1a\x1b\x47\x8a\xc3\x43"
+			  "\x7f\xda\xf4\xea\x6e\x0f\x02\x7a"
+			  "\x4d\x0d\xd7\xfb\x88\x62\x65\x1f"
+			  "\x75\x39\x96\x97\xb9\xfa\xf0\x58"
+			  "\xcc\xdc\x86\xd0\xc0\x53\xd5\x58"
+			  "\xf3\xca\x59\xde\x5f\x4e\xe4\xc8"
+			  "\x34\xde\x7d\x98\x5d\x31\x24\x2e"
+			  "\xa6\xfd\x61\xff\xba\x5e\xec\x5d"
+			  "\x22\x81\x15\xee\xe8\x28\xd7\x9c"
+			  "\x37\xc0\xdb\xee\xe0\x47\xba\x32"
+			  "\xc4\xdd\x02\x17\x2f\xad\xb5\x7d"
+			  "\x3f\xaf\x02\xd0\x52\x86\x88\xe8"
+			  "\x24\x40\xa8\x76\x28\x37\x65\x86"
+			  "\x46\x9c\xc7\xce\xd0\x33\x99\xeb"
+			  "\x8d\xda\x6e\x35\x4e\xce\x97\x9e"
+			  "\xf9\x83\x90\x06\x67\x63\x95\x7a"
+			  "\x4f\x84\xc1\x65\x21\xe5\xfd\x36"
+			  "\x64\x75\xd6\xf4\xa0\xc9\xde\x05"
+			  "\xdc\x4e\x5c\x0d\xd1\x79\x55\xb4"
+			  "\x73\x9a\x42\x4c\x1b\x52\xb6\x87"
+			  "\xea\x2c\x89\x6e\x04\xe6\x91\xb8"
+			  "\x1a\xaf\x6b\x8e\x4c\xbd\x8a\x5e"
+			  "\x2f\xb6\xab\x45\x97\x8e\xcf\xd1"
+			  "\x71\xb8\xcd\x8a\x87\x58\x7f\xf9"
+			  "\x26\xbf\x94\x32\x60\x89\x6b\xe7"
+			  "\xc3\xff\x0c\xbd\x02\xc0\x07\xa8"
+			  "\xd5\x14\xfa\x21\x10\x2d\xfc\x16"
+			  "\xf9\x53\xda\x9d\x17\x12\x52\x07"
+			  "\xb5\xd9\xef\xcb\xa4\xf3\x82\x20"
+			  "\xa6\xa8\x8c\xd1\x5f\x9f\xec\x8c"
+			  "\x6f\xb8\x6a\x7c\xbe\x01\x47\x48"
+			  "\xfd\x81\xd7\x85\xfb\x57\x01\xb7"
+			  "\x25\xc2\x25\x8e\x29\xed\x3d\x85"
+			  "\xaa\xde\x29\xf2\x3c\xac\x3c\x0c"
+			  "\x24\x83\xbd\xa8\x9b\x13\x9f\x2a"
+			  "\x0b\xec\xdb\xc6\x1e\x69\xdf\x60"
+			  "\xb3\xff\xac\xbd\xcc\x9f\xf7\x0a"
+			  "\x51\x74\xab\xb0\x5c\x24\x78\x6a"
+			  "\x57\xb5\x55\x19\x78\xc8\xc4\xc2"
+			  "\x22\x0e\xe6\x33\x30\x4f\x4f\x8c"
+			  "\x0a\x34\x24\xd7\x73\xfe\xa6\x2f"
+			  "\xfc\x59\x62\x38\xc6\xa9\xcb\x6d"
+			  "\x24\xeb\x5f\xdc\xaf\xd6\x58\xa7"
+			  "\x51\x24\x8f\x30\x78\xec\xd4\x20"
+			  "\x35\x38\xbe\x93\x14\x79\xa6\x18"
+			  "\xa4\x7c\x84\xbd\x40\x87\x2c\xe2"
+			  "\x18\x36\x4c\xaf\x42\x16\x7c\x20"
+			  "\x81\xf7\xc7\xee\x21\xfb\xbb\x80",
+		.rlen	= 496,
+	},
 };
 
 static struct cipher_testvec aes_ctr_rfc3686_enc_tv_template[] = {
@@ -0,0 +1,385 @@
+/* Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Self-test for the diag HDLC encoder and decoder.  Random packets, rich
+ * in 0x7E/0x7D, are encoded into randomly sized destination fragments and
+ * checked against a straightforward byte-at-a-time reference framing,
+ * then decoded again from random sized source chunks.  Throughput for
+ * plain payload is printed at the end.
+ *
+ * The memory device ring is exercised too: random sized records go
+ * through a private ring drained by a simulated reader, and a record of
+ * half the ring must fit into an emptied ring wherever head was left.
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/random.h>
+#include <linux/ktime.h>
+#include <linux/crc-ccitt.h>
+#include <linux/mutex.h>
+#include <linux/diagchar.h>
+#include "diagchar.h"
+#include "diagchar_hdlc.h"
+#include "diag_ring.h"
+
+#define HDLC_TEST_ITERATIONS	2000
+#define HDLC_TEST_MAX_PKT	2048
+#define HDLC_TEST_PERF_LEN	(64 * 1024)
+#define HDLC_TEST_PERF_LOOPS	64
+#define RING_TEST_SIZE		4096
+#define RING_TEST_RECS		20000
+#define RING_TEST_MAX_LEN	(RING_TEST_SIZE / 2 - \
+				 sizeof(struct diag_ring_rec))
+
+static unsigned int seed = 1;
+module_param(seed, uint, 0);
+
+static unsigned int hdlc_test_rand(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/* reference framing: escape every special byte, then CRC and 0x7E */
+static unsigned int hdlc_ref_encode(const uint8_t *src, unsigned int len,
+				    uint8_t *dest)
+{
+	unsigned int i, out = 0;
+	uint16_t crc = crc_ccitt(0xFFFF, src, len);
+	uint8_t tail[2];
+
+	crc = ~crc;
+	tail[0] = crc & 0xFF;
+	tail[1] = crc >> 8;
+
+	for (i = 0; i < len + 2; i++) {
+		uint8_t c = i < len ? src[i] : tail[i - len];
+
+		if (c == CONTROL_CHAR || c == ESC_CHAR) {
+			dest[out++] = ESC_CHAR;
+			dest[out++] = c ^ ESC_MASK;
+		} else {
+			dest[out++] = c;
+		}
+	}
+	dest[out++] = CONTROL_CHAR;
+	return out;
+}
+
+static void hdlc_test_fill(uint8_t *buf, unsigned int len)
+{
+	unsigned int i;
+
+	for (i = 0; i < len; i++) {
+		switch (hdlc_test_rand() & 7) {
+		case 0:
+			buf[i] = CONTROL_CHAR;
+			break;
+		case 1:
+			buf[i] = ESC_CHAR;
+			break;
+		default:
+			buf[i] = hdlc_test_rand();
+		}
+	}
+}
+
+/* encode @len bytes into fragments of random size, return encoded size */
+static int hdlc_test_encode(const uint8_t *src, unsigned int len,
+			    uint8_t *dest, unsigned int dest_size)
+{
+	struct diag_send_desc_type send = { NULL, NULL, DIAG_STATE_START, 0 };
+	struct diag_hdlc_dest_type enc = { NULL, NULL, 0 };
+	uint8_t *out = dest;
+
+	send.pkt = src;
+	send.last = src + len - 1;
+	send.terminate = 1;
+
+	while (send.state != DIAG_STATE_COMPLETE) {
+		unsigned int room = dest + dest_size - out;
+		unsigned int frag = 1 + hdlc_test_rand() % 64;
+
+		if (!room)
+			return -EOVERFLOW;
+		frag = min(frag, room);
+		enc.dest = out;
+		enc.dest_last = out + frag - 1;
+		diag_hdlc_encode(&send, &enc);
+		out = enc.dest;
+	}
+	return out - dest;
+}
+
+static int hdlc_test_one(uint8_t *pkt, uint8_t *ref, uint8_t *enc,
+			 uint8_t *dec, unsigned int len)
+{
+	struct diag_hdlc_decode_type hdlc;
+	unsigned int ref_len, dec_len = 0;
+	int enc_len, pkt_bnd = 0;
+
+	hdlc_test_fill(pkt, len);
+	ref_len = hdlc_ref_encode(pkt, len, ref);
+	enc_len = hdlc_test_encode(pkt, len, enc, 2 * len + 8);
+	if (enc_len < 0 || enc_len != ref_len || memcmp(enc, ref, ref_len)) {
+		pr_err("diag: hdlc test: encode of %u bytes: %d vs %u\n",
+		       len, enc_len, ref_len);
+		return -EINVAL;
+	}
+
+	memset(&hdlc, 0, sizeof(hdlc));
+	hdlc.src_ptr = enc;
+	hdlc.dest_ptr = dec;
+	hdlc.dest_size = len + 3;
+	while (!pkt_bnd && hdlc.src_idx < enc_len) {
+		hdlc.src_size = min_t(unsigned int, enc_len,
+				hdlc.src_idx + 1 + hdlc_test_rand() % 64);
+		pkt_bnd = diag_hdlc_decode(&hdlc);
+	}
+	dec_len = hdlc.dest_idx;
+
+	/* payload, CRC, terminating 0x7E; CRC residue checks the lot */
+	if (!pkt_bnd || dec_len != len + 3 || memcmp(dec, pkt, len) ||
+	    crc_ccitt(0xFFFF, dec, len + 2) != 0xF0B8) {
+		pr_err("diag: hdlc test: decode of %u bytes: got %u, bnd %d\n",
+		       len, dec_len, pkt_bnd);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static void hdlc_test_perf(uint8_t *pkt, uint8_t *enc)
+{
+	struct diag_send_desc_type send;
+	struct diag_hdlc_dest_type dst;
+	struct diag_hdlc_decode_type hdlc;
+	unsigned int i;
+	ktime_t start;
+	s64 enc_ns, dec_ns;
+
+	/* typical log payload: escapes are rare */
+	for (i = 0; i < HDLC_TEST_PERF_LEN; i++) {
+		pkt[i] = hdlc_test_rand();
+		if (pkt[i] == CONTROL_CHAR || pkt[i] == ESC_CHAR)
+			pkt[i] = 0;
+	}
+
+	start = ktime_get();
+	for (i = 0; i < HDLC_TEST_PERF_LOOPS; i++) {
+		send.pkt = pkt;
+		send.last = pkt + HDLC_TEST_PERF_LEN - 1;
+		send.state = DIAG_STATE_START;
+		send.terminate = 1;
+		dst.dest = enc;
+		dst.dest_last = enc + 2 * HDLC_TEST_PERF_LEN + 7;
+		diag_hdlc_encode(&send, &dst);
+	}
+	enc_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	start = ktime_get();
+	for (i = 0; i < HDLC_TEST_PERF_LOOPS; i++) {
+		memset(&hdlc, 0, sizeof(hdlc));
+		hdlc.src_ptr = enc;
+		hdlc.src_size = HDLC_TEST_PERF_LEN + 3;
+		hdlc.dest_ptr = pkt;
+		hdlc.dest_size = HDLC_TEST_PERF_LEN + 3;
+		diag_hdlc_decode(&hdlc);
+	}
+	dec_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	pr_info("diag: hdlc test: encode %lld ns, decode %lld ns per %d bytes\n",
+		enc_ns / HDLC_TEST_PERF_LOOPS, dec_ns / HDLC_TEST_PERF_LOOPS,
+		HDLC_TEST_PERF_LEN);
+}
+
+static uint32_t ring_test_rec_size(uint32_t len)
+{
+	return sizeof(struct diag_ring_rec) + ALIGN(len, DIAG_RING_ALIGN);
+}
+
+static void ring_test_fill(uint8_t *buf, uint32_t len, uint32_t seq)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		buf[i] = seq + i;
+}
+
+/*
+ * Consume up to @max records the way the reader does, checking that they
+ * come out in order and intact.
+ */
+static int ring_test_drain(struct diag_ring *r, uint32_t *seq, int max)
+{
+	uint32_t tail = r->hdr->tail;
+	struct diag_ring_rec *rec;
+	uint8_t *p;
+	uint32_t i;
+
+	while (max && tail != r->hdr->head) {
+		if (r->size - tail < sizeof(*rec)) {
+			tail = 0;
+			continue;
+		}
+		rec = r->data + tail;
+		if (rec->proc == DIAG_RING_PAD) {
+			tail = 0;
+			continue;
+		}
+		if (rec->proc != *seq || rec->len > RING_TEST_MAX_LEN) {
+			pr_err("diag: ring test: record %u at %u: proc %u len %u\n",
+			       *seq, tail, rec->proc, rec->len);
+			return -EINVAL;
+		}
+		p = (uint8_t *)(rec + 1);
+		for (i = 0; i < rec->len; i++)
+			if (p[i] != (uint8_t)(*seq + i)) {
+				pr_err("diag: ring test: record %u corrupt\n",
+				       *seq);
+				return -EINVAL;
+			}
+		tail += ring_test_rec_size(rec->len);
+		if (tail == r->size)
+			tail = 0;
+		(*seq)++;
+		max--;
+	}
+	r->hdr->tail = tail;
+	return 0;
+}
+
+static int ring_test_put(struct diag_ring *r, uint32_t len, uint32_t seq)
+{
+	void *dst;
+	int ret;
+
+	ret = diag_ring_reserve(r, len, &dst);
+	if (!ret) {
+		ring_test_fill(dst, len, seq);
+		diag_ring_commit(r, seq, len);
+	}
+	return ret;
+}
+
+static int ring_test(void)
+{
+	struct diag_ring r;
+	uint32_t wr_seq = 0, rd_seq = 0, len;
+	int i, ret;
+
+	memset(&r, 0, sizeof(r));
+	r.hdr = kzalloc(sizeof(*r.hdr), GFP_KERNEL);
+	r.data = kmalloc(RING_TEST_SIZE, GFP_KERNEL);
+	if (!r.hdr || !r.data) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	r.size = RING_TEST_SIZE;
+
+	ret = -EINVAL;
+	if (ring_test_put(&r, RING_TEST_MAX_LEN + 1, 0) != -EMSGSIZE) {
+		pr_err("diag: ring test: oversized record accepted\n");
+		goto out;
+	}
+
+	/* an emptied ring must take the largest record at any head */
+	for (i = 0; i < RING_TEST_SIZE / DIAG_RING_ALIGN; i++) {
+		if (ring_test_put(&r, RING_TEST_MAX_LEN, wr_seq) ||
+		    ring_test_drain(&r, &rd_seq, -1)) {
+			pr_err("diag: ring test: max record stuck at %u\n",
+			       r.head);
+			goto out;
+		}
+		wr_seq++;
+		/* then move head on a little */
+		if (ring_test_put(&r, (i % 2) * DIAG_RING_ALIGN, wr_seq++) ||
+		    ring_test_drain(&r, &rd_seq, -1))
+			goto out;
+	}
+
+	for (i = 0; i < RING_TEST_RECS; i++) {
+		len = hdlc_test_rand() % (RING_TEST_MAX_LEN + 1);
+		ret = ring_test_put(&r, len, wr_seq);
+		if (ret == -EAGAIN) {
+			/* a full drain must always make room */
+			ret = ring_test_drain(&r, &rd_seq, -1);
+			if (!ret)
+				ret = ring_test_put(&r, len, wr_seq);
+		}
+		if (ret) {
+			pr_err("diag: ring test: %u bytes at %u: %d\n",
+			       len, r.head, ret);
+			goto out;
+		}
+		wr_seq++;
+		if (!(hdlc_test_rand() % 4)) {
+			ret = ring_test_drain(&r, &rd_seq,
+					      hdlc_test_rand() % 8);
+			if (ret)
+				goto out;
+		}
+	}
+	ret = ring_test_drain(&r, &rd_seq, -1);
+	if (!ret && rd_seq != wr_seq) {
+		pr_err("diag: ring test: wrote %u records, read %u\n",
+		       wr_seq, rd_seq);
+		ret = -EINVAL;
+	}
+	if (!ret)
+		pr_info("diag: ring test: %u records passed\n", wr_seq);
+out:
+	kfree(r.data);
+	kfree(r.hdr);
+	return ret;
+}
+
+static int __init diag_hdlc_test_init(void)
+{
+	uint8_t *pkt, *ref, *enc, *dec;
+	int i, ret = 0;
+
+	pkt = kmalloc(HDLC_TEST_PERF_LEN + 3, GFP_KERNEL);
+	ref = kmalloc(2 * HDLC_TEST_MAX_PKT + 8, GFP_KERNEL);
+	enc = kmalloc(2 * HDLC_TEST_PERF_LEN + 8, GFP_KERNEL);
+	dec = kmalloc(HDLC_TEST_MAX_PKT + 3, GFP_KERNEL);
+	if (!pkt || !ref || !enc || !dec) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (i = 0; i < HDLC_TEST_ITERATIONS && !ret; i++)
+		ret = hdlc_test_one(pkt, ref, enc, dec,
+				    1 + hdlc_test_rand() % HDLC_TEST_MAX_PKT);
+	if (!ret) {
+		pr_info("diag: hdlc test: %d packets passed\n",
+			HDLC_TEST_ITERATIONS);
+		hdlc_test_perf(pkt, enc);
+		ret = ring_test();
+	}
+out:
+	kfree(dec);
+	kfree(enc);
+	kfree(ref);
+	kfree(pkt);
+	return ret;
+}
+
+static void __exit diag_hdlc_test_exit(void)
+{
+}
+
+module_init(diag_hdlc_test_init);
+module_exit(diag_hdlc_test_exit);
+MODULE_DESCRIPTION("Diag HDLC encoder/decoder and ring self-test");
+MODULE_LICENSE("GPL v2");
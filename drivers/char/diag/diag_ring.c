@@ -0,0 +1,261 @@
+/* Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Memory device ring: in memory device mode the logging process may map
+ * a ring into its address space instead of read()ing one buffer per
+ * peripheral per syscall.  SMD packets are read straight into the ring,
+ * apps packets are copied in once, and the reader is woken with a single
+ * doorbell for however many records arrived.  See struct diag_ring_hdr
+ * in <linux/diagchar.h> for the layout.
+ */
+
+#include <linux/slab.h>
+#include <linux/module.h>
+#include <linux/fs.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/mutex.h>
+#include <linux/diagchar.h>
+#include <mach/msm_smd.h>
+#include "diagchar.h"
+#include "diag_ring.h"
+
+/* upper bound on the mapping, header page included */
+static unsigned int ring_max_size = 4 * 1024 * 1024;
+module_param(ring_max_size, uint, 0);
+
+static struct diag_ring ring = {
+	.lock = __MUTEX_INITIALIZER(ring.lock),
+};
+
+static uint32_t diag_ring_rec_size(uint32_t len)
+{
+	return sizeof(struct diag_ring_rec) + ALIGN(len, DIAG_RING_ALIGN);
+}
+
+int diag_ring_mmap(struct file *file, struct vm_area_struct *vma, int pid)
+{
+	unsigned long len = vma->vm_end - vma->vm_start;
+	void *mem;
+	int ret = 0;
+
+	/* any SMD packet must fit in half the data area, see below */
+	if (vma->vm_pgoff || len > ring_max_size ||
+			len < PAGE_SIZE + 2 * diag_ring_rec_size(IN_BUF_SIZE))
+		return -EINVAL;
+
+	mutex_lock(&ring.lock);
+	if (ring.hdr) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	mem = vmalloc_user(len);
+	if (!mem) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	ret = remap_vmalloc_range(vma, mem, 0);
+	if (ret) {
+		vfree(mem);
+		goto out;
+	}
+
+	ring.hdr = mem;
+	ring.data = mem + PAGE_SIZE;
+	ring.size = len - PAGE_SIZE;
+	ring.head = 0;
+	ring.file = file;
+	ring.pid = pid;
+	ring.pending = 0;
+	ring.hdr->size = ring.size;
+	pr_debug("diag: ring of %u bytes mapped by %d\n", ring.size, pid);
+out:
+	mutex_unlock(&ring.lock);
+	return ret;
+}
+
+/*
+ * Called from release() of every /dev/diag file.  The owner may hold
+ * other diag fds, so only the file that was mapped frees the ring; each
+ * mapping pins that file, so by now nothing can still see the pages.
+ */
+void diag_ring_release(struct file *file)
+{
+	mutex_lock(&ring.lock);
+	if (ring.hdr && ring.file == file) {
+		vfree(ring.hdr);
+		ring.hdr = NULL;
+		ring.data = NULL;
+		ring.file = NULL;
+		ring.pid = 0;
+	}
+	mutex_unlock(&ring.lock);
+}
+
+int diag_ring_active(void)
+{
+	return ring.hdr && driver->logging_mode == MEMORY_DEVICE_MODE &&
+		ring.pid == driver->logging_process_id;
+}
+
+/*
+ * Reserve room in @r for a record of @len payload bytes and point @dst at
+ * where the payload goes.  head == tail means empty, so the ring is never
+ * filled to the last byte.
+ *
+ * A record of at most half the data area always fits once the reader has
+ * emptied the ring, wherever head was left.  Anything bigger could wait
+ * for room that never comes, so it is refused outright.
+ *
+ * @returns 0 - reserved, commit with diag_ring_commit()
+ *          -EAGAIN - not enough room until the reader moves tail
+ *          -EMSGSIZE - the record can never fit
+ */
+int diag_ring_reserve(struct diag_ring *r, uint32_t len, void **dst)
+{
+	uint32_t need = diag_ring_rec_size(len);
+	uint32_t head = r->head;
+	uint32_t tail = ACCESS_ONCE(r->hdr->tail);
+	struct diag_ring_rec *rec;
+
+	if (need > r->size / 2)
+		return -EMSGSIZE;
+	/* a reader scribbling on tail only loses its own data */
+	if (tail >= r->size || tail % DIAG_RING_ALIGN)
+		return -EAGAIN;
+	/* don't write over anything before seeing the reader is done */
+	smp_mb();
+
+	if (head >= tail) {
+		if (r->size - head > need ||
+				(r->size - head == need && tail))
+			goto fits;
+		if (need >= tail)
+			return -EAGAIN;
+		if (r->size - head >= sizeof(*rec)) {
+			rec = r->data + head;
+			rec->len = 0;
+			rec->proc = DIAG_RING_PAD;
+		}
+		head = 0;
+	} else if (tail - head <= need) {
+		return -EAGAIN;
+	}
+fits:
+	r->resv = head;
+	rec = r->data + head;
+	*dst = rec + 1;
+	return 0;
+}
+EXPORT_SYMBOL(diag_ring_reserve);
+
+void diag_ring_commit(struct diag_ring *r, int proc, uint32_t len)
+{
+	struct diag_ring_rec *rec = r->data + r->resv;
+	uint32_t head = r->resv + diag_ring_rec_size(len);
+
+	rec->len = len;
+	rec->proc = proc;
+	if (head == r->size)
+		head = 0;
+	r->head = head;
+	/* payload before the head that publishes it */
+	smp_wmb();
+	r->hdr->head = head;
+	r->pending = 1;
+}
+EXPORT_SYMBOL(diag_ring_commit);
+
+static void diag_ring_notify(void)
+{
+	int i;
+
+	if (!ring.pending)
+		return;
+	ring.pending = 0;
+	for (i = 0; i < driver->num_clients; i++)
+		if (driver->client_map[i].pid == ring.pid) {
+			driver->data_ready[i] |= USER_SPACE_RING_TYPE;
+			wake_up_interruptible(&driver->wait_q);
+			break;
+		}
+}
+
+int diag_ring_write(int proc, const void *buf, int len)
+{
+	void *dst;
+	int ret;
+
+	mutex_lock(&ring.lock);
+	if (!ring.hdr) {
+		ret = -ENODEV;
+		goto out;
+	}
+	ret = diag_ring_reserve(&ring, len, &dst);
+	if (!ret) {
+		memcpy(dst, buf, len);
+		diag_ring_commit(&ring, proc, len);
+	} else {
+		ring.hdr->dropped++;
+		/* wake the reader anyway so it drains what's there */
+		ring.pending = 1;
+	}
+	diag_ring_notify();
+out:
+	mutex_unlock(&ring.lock);
+	return ret;
+}
+
+/*
+ * Move every packet pending on @ch into the ring without a bounce buffer.
+ * If the ring fills up the rest stays in SMD until the reader's next
+ * read() kicks the channel again.
+ */
+void diag_ring_smd_read(smd_channel_t *ch, int proc)
+{
+	void *dst;
+	int r, ret;
+
+	mutex_lock(&ring.lock);
+	while (ring.hdr && (r = smd_read_avail(ch)) > 0) {
+		ret = diag_ring_reserve(&ring, r, &dst);
+		if (ret == -EMSGSIZE) {
+			/* can never fit: drop it rather than stall */
+			smd_read(ch, NULL, r);
+			ring.hdr->dropped++;
+			continue;
+		}
+		if (ret) {
+			ring.pending = 1;
+			break;
+		}
+		smd_read(ch, dst, r);
+		diag_ring_commit(&ring, proc, r);
+	}
+	diag_ring_notify();
+	mutex_unlock(&ring.lock);
+}
+
+/* the reader made room: pull whatever the peripherals have queued */
+void diag_ring_kick(void)
+{
+	if (driver->ch)
+		queue_work(driver->diag_wq, &(driver->diag_read_smd_work));
+	if (driver->chqdsp)
+		queue_work(driver->diag_wq,
+				 &(driver->diag_read_smd_qdsp_work));
+	if (driver->ch_wcnss)
+		queue_work(driver->diag_wq,
+				 &(driver->diag_read_smd_wcnss_work));
+}
@@ -0,0 +1,35 @@
+/* Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+#ifndef DIAG_RING_H
+#define DIAG_RING_H
+
+struct diag_ring {
+	struct mutex lock;
+	struct diag_ring_hdr *hdr;	/* shared with the reader */
+	void *data;
+	uint32_t size;
+	uint32_t head;			/* private copy, never read back */
+	uint32_t resv;			/* offset of the reserved record */
+	struct file *file;		/* open file the ring was mapped from */
+	int pid;			/* process that mapped the ring */
+	int pending;			/* records since the last doorbell */
+};
+
+int diag_ring_reserve(struct diag_ring *r, uint32_t len, void **dst);
+void diag_ring_commit(struct diag_ring *r, int proc, uint32_t len);
+int diag_ring_mmap(struct file *file, struct vm_area_struct *vma, int pid);
+void diag_ring_release(struct file *file);
+int diag_ring_active(void);
+int diag_ring_write(int proc, const void *buf, int len);
+void diag_ring_smd_read(smd_channel_t *ch, int proc);
+void diag_ring_kick(void);
+#endif
@@ -32,6 +32,7 @@
 #endif
 #include "diagfwd_cntl.h"
 #include "diag_dci.h"
+#include "diag_ring.h"
 #ifdef CONFIG_DIAG_SDIO_PIPE
 #include "diagfwd_sdio.h"
 #endif
@@ -256,6 +257,7 @@ static int diagchar_close(struct inode *inode, struct file *file)
 		diagmem_exit(driver, POOL_TYPE_COPY);
 		diagmem_exit(driver, POOL_TYPE_HDLC);
 		diagmem_exit(driver, POOL_TYPE_WRITE_STRUCT);
+		diag_ring_release(file);
 		for (i = 0; i < driver->num_clients; i++) {
 			if (NULL != diagpriv_data && diagpriv_data->pid ==
 				 driver->client_map[i].pid) {
@@ -690,6 +692,17 @@ static int diagchar_read(struct file *file, char __user *buf, size_t count,
 				  driver->data_ready[index]);
 	mutex_lock(&driver->diagchar_mutex);
 
+	if (driver->data_ready[index] & USER_SPACE_RING_TYPE) {
+		/* records are already in the mapped ring, this is only
+		 * the doorbell; pull in whatever waited for room
+		 */
+		data_type = USER_SPACE_RING_TYPE;
+		COPY_USER_SPACE_OR_EXIT(buf, data_type, 4);
+		driver->data_ready[index] ^= USER_SPACE_RING_TYPE;
+		diag_ring_kick();
+		goto exit;
+	}
+
 	if ((driver->data_ready[index] & USER_SPACE_LOG_TYPE) && (driver->
 					logging_mode == MEMORY_DEVICE_MODE)) {
 		pr_debug("diag: process woken up\n");
@@ -1238,10 +1251,20 @@ int mask_request_validate(unsigned char mask_buf[])
 	return 0;
 }
 
+static int diagchar_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct diagchar_priv *diagpriv_data = file->private_data;
+
+	if (!diagpriv_data)
+		return -EINVAL;
+	return diag_ring_mmap(file, vma, diagpriv_data->pid);
+}
+
 static const struct file_operations diagcharfops = {
 	.owner = THIS_MODULE,
 	.read = diagchar_read,
 	.write = diagchar_write,
+	.mmap = diagchar_mmap,
 	.unlocked_ioctl = diagchar_ioctl,
 	.open = diagchar_open,
 	.release = diagchar_close
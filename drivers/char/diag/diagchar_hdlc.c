@@ -29,6 +29,50 @@ MODULE_LICENSE("GPL v2");
 #define CRC_16_L_STEP(xx_crc, xx_c) \
 	crc_ccitt_byte(xx_crc, xx_c)
 
+/*
+ * Nearly all diag payload bytes go through HDLC unchanged, so both
+ * directions look for the next byte that needs work a word at a time
+ * and move everything before it with memcpy() and the table driven
+ * crc_ccitt().
+ */
+#define HDLC_ONES		(~0UL / 0xFF)
+#define HDLC_HIGHS		(HDLC_ONES * 0x80)
+
+static inline unsigned long hdlc_has_byte(unsigned long word, uint8_t c)
+{
+	word ^= HDLC_ONES * c;
+	return (word - HDLC_ONES) & ~word & HDLC_HIGHS;
+}
+
+static inline int hdlc_special(uint8_t c)
+{
+	return c == CONTROL_CHAR || c == ESC_CHAR;
+}
+
+/* Number of leading bytes of @src, at most @len, that need no escaping */
+static unsigned int hdlc_plain_len(const uint8_t *src, unsigned int len)
+{
+	const uint8_t *p = src;
+	const uint8_t *end = src + len;
+
+	while (p < end && ((unsigned long)p & (sizeof(long) - 1))) {
+		if (hdlc_special(*p))
+			return p - src;
+		p++;
+	}
+	while (end - p >= sizeof(long)) {
+		unsigned long word = *(const unsigned long *)p;
+
+		if (hdlc_has_byte(word, CONTROL_CHAR) |
+		    hdlc_has_byte(word, ESC_CHAR))
+			break;
+		p += sizeof(long);
+	}
+	while (p < end && !hdlc_special(*p))
+		p++;
+	return p - src;
+}
+
 void diag_hdlc_encode(struct diag_send_desc_type *src_desc,
 		      struct diag_hdlc_dest_type *enc)
 {
@@ -64,34 +108,35 @@ void diag_hdlc_encode(struct diag_send_desc_type *src_desc,
 			/* This condition needs to include the possibility
 			   of 2 dest bytes for an escaped byte */
 			while (src <= src_last && dest <= dest_last) {
+				unsigned int n;
+
+				/* Copy the run up to the next special byte */
+				n = hdlc_plain_len(src, min(src_last - src,
+							dest_last - dest) + 1);
+				if (n) {
+					memcpy(dest, src, n);
+					crc = crc_ccitt(crc, src, n);
+					src += n;
+					dest += n;
+					used += n;
+					continue;
+				}
 
-				src_byte = *src++;
-
-				if ((src_byte == CONTROL_CHAR) ||
-				    (src_byte == ESC_CHAR)) {
-
-					/* If the escape character is not the
-					   last byte */
-					if (dest != dest_last) {
-						crc = CRC_16_L_STEP(crc,
-								    src_byte);
-
-						*dest++ = ESC_CHAR;
-						used++;
+				src_byte = *src;
 
-						*dest++ = src_byte
-							  ^ ESC_MASK;
-						used++;
-					} else {
+				/* If the escape character is not the
+				   last byte */
+				if (dest != dest_last) {
+					crc = CRC_16_L_STEP(crc, src_byte);
+					src++;
 
-						src--;
-						break;
-					}
+					*dest++ = ESC_CHAR;
+					used++;
 
-				} else {
-					crc = CRC_16_L_STEP(crc, src_byte);
-					*dest++ = src_byte;
+					*dest++ = src_byte ^ ESC_MASK;
 					used++;
+				} else {
+					break;
 				}
 			}
 
@@ -160,6 +205,7 @@ void diag_hdlc_encode(struct diag_send_desc_type *src_desc,
 
 	return;
 }
+EXPORT_SYMBOL(diag_hdlc_encode);
 
 
 int diag_hdlc_decode(struct diag_hdlc_decode_type *hdlc)
@@ -185,21 +231,25 @@ int diag_hdlc_decode(struct diag_hdlc_decode_type *hdlc)
 		dest_ptr = &dest_ptr[hdlc->dest_idx];
 		dest_length = hdlc->dest_size - hdlc->dest_idx;
 
-		for (i = 0; i < src_length; i++) {
+		i = 0;
+		while (i < src_length) {
+			unsigned int n;
 
 			src_byte = src_ptr[i];
 
 			if (hdlc->escaping) {
 				dest_ptr[len++] = src_byte ^ ESC_MASK;
 				hdlc->escaping = 0;
+				i++;
 			} else if (src_byte == ESC_CHAR) {
 				if (i == (src_length - 1)) {
 					hdlc->escaping = 1;
 					i++;
 					break;
 				} else {
-					dest_ptr[len++] = src_ptr[++i]
+					dest_ptr[len++] = src_ptr[i + 1]
 							  ^ ESC_MASK;
+					i += 2;
 				}
 			} else if (src_byte == CONTROL_CHAR) {
 				dest_ptr[len++] = src_byte;
@@ -207,13 +257,17 @@ int diag_hdlc_decode(struct diag_hdlc_decode_type *hdlc)
 				i++;
 				break;
 			} else {
-				dest_ptr[len++] = src_byte;
+				/* Copy the run up to the next special byte */
+				n = hdlc_plain_len(&src_ptr[i],
+						   min(src_length - i,
+						       dest_length - len));
+				memcpy(&dest_ptr[len], &src_ptr[i], n);
+				len += n;
+				i += n;
 			}
 
-			if (len >= dest_length) {
-				i++;
+			if (len >= dest_length)
 				break;
-			}
 		}
 
 		hdlc->src_idx += i;
@@ -222,3 +276,4 @@ int diag_hdlc_decode(struct diag_hdlc_decode_type *hdlc)
 
 	return pkt_bnd;
 }
+EXPORT_SYMBOL(diag_hdlc_decode);
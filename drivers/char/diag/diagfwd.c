@@ -38,6 +38,7 @@
 #include "diagfwd_sdio.h"
 #endif
 #include "diag_dci.h"
+#include "diag_ring.h"
 
 
 #ifdef CONFIG_HUAWEI_FEATURE_PHUDIAG
@@ -249,6 +250,12 @@ void __diag_smd_send_req(void)
 	int *in_busy_ptr = NULL;
 	struct diag_request *write_ptr_modem = NULL;
 
+	/* memory device ring: read straight from SMD, no bounce buffer */
+	if (driver->ch && diag_ring_active()) {
+		diag_ring_smd_read(driver->ch, MODEM_DATA);
+		return;
+	}
+
 	if (!driver->in_busy_1) {
 		buf = driver->buf_in_1;
 		write_ptr_modem = driver->write_ptr_1;
@@ -330,6 +337,12 @@ int diag_device_write(void *buf, int proc_num, struct diag_request *write_ptr)
 	int i, err = 0;
 
 	if (driver->logging_mode == MEMORY_DEVICE_MODE) {
+		if (proc_num == APPS_DATA && diag_ring_active()) {
+			/* copied (or counted as dropped), buffer is done */
+			diag_ring_write(APPS_DATA, buf, driver->used);
+			diagmem_free(driver, buf, POOL_TYPE_HDLC);
+			return 0;
+		}
 		if (proc_num == APPS_DATA) {
 			for (i = 0; i < driver->poolsize_write_struct; i++)
 				if (driver->buf_tbl[i].length == 0) {
@@ -457,6 +470,12 @@ void __diag_smd_wcnss_send_req(void)
 	int *in_busy_wcnss_ptr = NULL;
 	struct diag_request *write_ptr_wcnss = NULL;
 
+	/* memory device ring: read straight from SMD, no bounce buffer */
+	if (driver->ch_wcnss && diag_ring_active()) {
+		diag_ring_smd_read(driver->ch_wcnss, WCNSS_DATA);
+		return;
+	}
+
 	if (!driver->in_busy_wcnss_1) {
 		buf = driver->buf_in_wcnss_1;
 		write_ptr_wcnss = driver->write_ptr_wcnss_1;
@@ -503,6 +522,12 @@ void __diag_smd_qdsp_send_req(void)
 	int *in_busy_qdsp_ptr = NULL;
 	struct diag_request *write_ptr_qdsp = NULL;
 
+	/* memory device ring: read straight from SMD, no bounce buffer */
+	if (driver->chqdsp && diag_ring_active()) {
+		diag_ring_smd_read(driver->chqdsp, QDSP_DATA);
+		return;
+	}
+
 	if (!driver->in_busy_qdsp_1) {
 		buf = driver->buf_in_qdsp_1;
 		write_ptr_qdsp = driver->write_ptr_qdsp_1;
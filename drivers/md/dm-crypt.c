@@ -20,6 +20,8 @@
 #include <linux/backing-dev.h>
 #include <linux/atomic.h>
 #include <linux/scatterlist.h>
+#include <linux/percpu.h>
+#include <linux/cpumask.h>
 #include <asm/page.h>
 #include <asm/unaligned.h>
 #include <crypto/hash.h>
@@ -44,6 +46,8 @@ struct convert_context {
 	sector_t sector;
 	atomic_t cc_pending;
 	struct ablkcipher_request *req;
+	int parallel_cpu;
+	unsigned int parallel_left;
 };
 
 /*
@@ -64,6 +68,7 @@ struct dm_crypt_io {
 
 struct dm_crypt_request {
 	struct convert_context *ctx;
+	struct list_head list;
 	struct scatterlist sg_in;
 	struct scatterlist sg_out;
 	sector_t iv_sector;
@@ -102,7 +107,24 @@ struct iv_lmk_private {
  * Crypt: maps a linear range of a block device
  * and encrypts / decrypts at the same time.
  */
-enum flags { DM_CRYPT_SUSPENDED, DM_CRYPT_KEY_VALID };
+enum flags { DM_CRYPT_SUSPENDED, DM_CRYPT_KEY_VALID, DM_CRYPT_SAME_CPU };
+
+/*
+ * Per-CPU list of sector requests handed out by kcryptd, so that a single
+ * large bio is encrypted on all CPUs.
+ */
+struct crypt_cpu_queue {
+	struct crypt_config *cc;
+	spinlock_t lock;
+	struct list_head list;
+	struct work_struct work;
+};
+
+/*
+ * Number of consecutive sectors sent to the same CPU; one page keeps the
+ * per-request overhead small while still spreading a bio across CPUs.
+ */
+#define DM_CRYPT_PARALLEL_SECTORS	(PAGE_SIZE >> SECTOR_SHIFT)
 
 /*
  * The fields in here must be read only after initialization,
@@ -123,6 +145,14 @@ struct crypt_config {
 	struct workqueue_struct *io_queue;
 	struct workqueue_struct *crypt_queue;
 
+	/*
+	 * Set up on SMP unless same_cpu_crypt is given.
+	 * parallel_cpu is just a round-robin hint and is updated racily.
+	 */
+	struct workqueue_struct *parallel_queue;
+	struct crypt_cpu_queue __percpu *cpu_queue;
+	int parallel_cpu;
+
 	char *cipher;
 	char *cipher_string;
 
@@ -638,6 +668,7 @@ static void crypt_convert_init(struct crypt_config *cc,
 	ctx->idx_in = bio_in ? bio_in->bi_idx : 0;
 	ctx->idx_out = bio_out ? bio_out->bi_idx : 0;
 	ctx->sector = sector + cc->iv_offset;
+	ctx->parallel_left = 0;
 	init_completion(&ctx->restart);
 }
 
@@ -660,6 +691,119 @@ static u8 *iv_of_dmreq(struct crypt_config *cc,
 		crypto_ablkcipher_alignmask(any_tfm(cc)) + 1);
 }
 
+/*
+ * Generate the IV and start the cipher on a prepared sector request.
+ * The IV post hook is left to the caller (or to kcryptd_async_done).
+ */
+static int crypt_convert_block_start(struct crypt_config *cc,
+				     struct dm_crypt_request *dmreq)
+{
+	struct ablkcipher_request *req = req_of_dmreq(cc, dmreq);
+	u8 *iv = iv_of_dmreq(cc, dmreq);
+	int r;
+
+	if (cc->iv_gen_ops) {
+		r = cc->iv_gen_ops->generator(cc, iv, dmreq);
+		if (r < 0)
+			return r;
+	}
+
+	ablkcipher_request_set_crypt(req, &dmreq->sg_in, &dmreq->sg_out,
+				     1 << SECTOR_SHIFT, iv);
+
+	if (bio_data_dir(dmreq->ctx->bio_in) == WRITE)
+		r = crypto_ablkcipher_encrypt(req);
+	else
+		r = crypto_ablkcipher_decrypt(req);
+
+	return r;
+}
+
+static void kcryptd_async_done(struct crypto_async_request *async_req,
+			       int error);
+
+static int crypt_parallel_next_cpu(struct crypt_config *cc)
+{
+	int cpu = cpumask_next(ACCESS_ONCE(cc->parallel_cpu), cpu_online_mask);
+
+	if (cpu >= nr_cpu_ids)
+		cpu = cpumask_first(cpu_online_mask);
+	cc->parallel_cpu = cpu;
+
+	return cpu;
+}
+
+/*
+ * Hand a sector request to one of the per-CPU workers.  Consecutive
+ * sectors go to the same CPU in runs of DM_CRYPT_PARALLEL_SECTORS and
+ * complete through kcryptd_async_done exactly like an asynchronous
+ * cipher would, so the bio is only finished once every sector is done.
+ */
+static void kcryptd_parallel_queue(struct crypt_config *cc,
+				   struct convert_context *ctx,
+				   struct dm_crypt_request *dmreq)
+{
+	struct crypt_cpu_queue *q;
+	int was_empty;
+
+	if (!ctx->parallel_left) {
+		ctx->parallel_cpu = crypt_parallel_next_cpu(cc);
+		ctx->parallel_left = DM_CRYPT_PARALLEL_SECTORS;
+	}
+	ctx->parallel_left--;
+
+	q = per_cpu_ptr(cc->cpu_queue, ctx->parallel_cpu);
+
+	spin_lock(&q->lock);
+	was_empty = list_empty(&q->list);
+	list_add_tail(&dmreq->list, &q->list);
+	spin_unlock(&q->lock);
+
+	/*
+	 * A non-empty list means the worker has been queued and has not
+	 * taken the list yet, so it will pick this request up as well.
+	 */
+	if (was_empty)
+		queue_work_on(ctx->parallel_cpu, cc->parallel_queue, &q->work);
+}
+
+static void kcryptd_parallel_crypt(struct work_struct *work)
+{
+	struct crypt_cpu_queue *q = container_of(work, struct crypt_cpu_queue,
+						 work);
+	struct crypt_config *cc = q->cc;
+	struct dm_crypt_request *dmreq, *tmp;
+	LIST_HEAD(list);
+	int r;
+
+	spin_lock(&q->lock);
+	list_splice_init(&q->list, &list);
+	spin_unlock(&q->lock);
+
+	list_for_each_entry_safe(dmreq, tmp, &list, list) {
+		r = crypt_convert_block_start(cc, dmreq);
+		switch (r) {
+		/*
+		 * The cipher went asynchronous for this request (a cryptd
+		 * wrapper called from atomic context, or a hardware engine)
+		 * and calls kcryptd_async_done itself.  A backlogged request
+		 * first reports -EINPROGRESS through the callback; only the
+		 * parallel workers wait on ctx->restart, so counting the
+		 * completions is enough to pair them.
+		 */
+		case -EBUSY:
+			wait_for_completion(&dmreq->ctx->restart);
+			/* fall through */
+		case -EINPROGRESS:
+			break;
+		/* done synchronously, or failed */
+		default:
+			kcryptd_async_done(&req_of_dmreq(cc, dmreq)->base, r);
+		}
+		cond_resched();
+	}
+}
+
 static int crypt_convert_block(struct crypt_config *cc,
 			       struct convert_context *ctx,
 			       struct ablkcipher_request *req)
@@ -667,11 +811,9 @@ static int crypt_convert_block(struct crypt_config *cc,
 	struct bio_vec *bv_in = bio_iovec_idx(ctx->bio_in, ctx->idx_in);
 	struct bio_vec *bv_out = bio_iovec_idx(ctx->bio_out, ctx->idx_out);
 	struct dm_crypt_request *dmreq;
-	u8 *iv;
-	int r = 0;
+	int r;
 
 	dmreq = dmreq_of_req(cc, req);
-	iv = iv_of_dmreq(cc, dmreq);
 
 	dmreq->iv_sector = ctx->sector;
 	dmreq->ctx = ctx;
@@ -695,29 +837,19 @@ static int crypt_convert_block(struct crypt_config *cc,
 		ctx->idx_out++;
 	}
 
-	if (cc->iv_gen_ops) {
-		r = cc->iv_gen_ops->generator(cc, iv, dmreq);
-		if (r < 0)
-			return r;
+	if (cc->parallel_queue) {
+		kcryptd_parallel_queue(cc, ctx, dmreq);
+		return -EINPROGRESS;
 	}
 
-	ablkcipher_request_set_crypt(req, &dmreq->sg_in, &dmreq->sg_out,
-				     1 << SECTOR_SHIFT, iv);
-
-	if (bio_data_dir(ctx->bio_in) == WRITE)
-		r = crypto_ablkcipher_encrypt(req);
-	else
-		r = crypto_ablkcipher_decrypt(req);
+	r = crypt_convert_block_start(cc, dmreq);
 
 	if (!r && cc->iv_gen_ops && cc->iv_gen_ops->post)
-		r = cc->iv_gen_ops->post(cc, iv, dmreq);
+		r = cc->iv_gen_ops->post(cc, iv_of_dmreq(cc, dmreq), dmreq);
 
 	return r;
 }
 
-static void kcryptd_async_done(struct crypto_async_request *async_req,
-			       int error);
-
 static void crypt_alloc_req(struct crypt_config *cc,
 			    struct convert_context *ctx)
 {
@@ -1350,6 +1482,10 @@ static void crypt_dtr(struct dm_target *ti)
 		destroy_workqueue(cc->io_queue);
 	if (cc->crypt_queue)
 		destroy_workqueue(cc->crypt_queue);
+	if (cc->parallel_queue)
+		destroy_workqueue(cc->parallel_queue);
+	if (cc->cpu_queue)
+		free_percpu(cc->cpu_queue);
 
 	crypt_free_tfms(cc);
 
@@ -1537,13 +1673,13 @@ static int crypt_ctr(struct dm_target *ti, unsigned int argc, char **argv)
 	struct crypt_config *cc;
 	unsigned int key_size, opt_params;
 	unsigned long long tmpll;
-	int ret;
+	int ret, cpu;
 	struct dm_arg_set as;
 	const char *opt_string;
 	char dummy;
 
 	static struct dm_arg _args[] = {
-		{0, 1, "Invalid number of feature args"},
+		{0, 2, "Invalid number of feature args"},
 	};
 
 	if (argc < 5) {
@@ -1627,15 +1763,23 @@ static int crypt_ctr(struct dm_target *ti, unsigned int argc, char **argv)
 		if (ret)
 			goto bad;
 
-		opt_string = dm_shift_arg(&as);
+		while (opt_params--) {
+			opt_string = dm_shift_arg(&as);
+			if (!opt_string) {
+				ret = -EINVAL;
+				ti->error = "Not enough feature arguments";
+				goto bad;
+			}
 
-		if (opt_params == 1 && opt_string &&
-		    !strcasecmp(opt_string, "allow_discards"))
-			ti->num_discard_requests = 1;
-		else if (opt_params) {
-			ret = -EINVAL;
-			ti->error = "Invalid feature arguments";
-			goto bad;
+			if (!strcasecmp(opt_string, "allow_discards"))
+				ti->num_discard_requests = 1;
+			else if (!strcasecmp(opt_string, "same_cpu_crypt"))
+				set_bit(DM_CRYPT_SAME_CPU, &cc->flags);
+			else {
+				ret = -EINVAL;
+				ti->error = "Invalid feature arguments";
+				goto bad;
+			}
 		}
 	}
 
@@ -1659,6 +1803,41 @@ static int crypt_ctr(struct dm_target *ti, unsigned int argc, char **argv)
 		goto bad;
 	}
 
+	/*
+	 * Spread requests whatever the cipher's CRYPTO_ALG_ASYNC flag says:
+	 * SIMD drivers such as the NEON AES ones are flagged asynchronous
+	 * only because of their cryptd fallback, and complete synchronously
+	 * when called from a worker.  The workers tell the two cases apart
+	 * per request.
+	 */
+	if (!test_bit(DM_CRYPT_SAME_CPU, &cc->flags) &&
+	    num_possible_cpus() > 1) {
+		cc->cpu_queue = alloc_percpu(struct crypt_cpu_queue);
+		if (!cc->cpu_queue) {
+			ti->error = "Cannot allocate per-CPU crypt queues";
+			goto bad;
+		}
+
+		for_each_possible_cpu(cpu) {
+			struct crypt_cpu_queue *q = per_cpu_ptr(cc->cpu_queue,
+								 cpu);
+
+			q->cc = cc;
+			spin_lock_init(&q->lock);
+			INIT_LIST_HEAD(&q->list);
+			INIT_WORK(&q->work, kcryptd_parallel_crypt);
+		}
+
+		cc->parallel_queue = alloc_workqueue("kcryptd_par",
+						     WQ_CPU_INTENSIVE|
+						     WQ_MEM_RECLAIM,
+						     1);
+		if (!cc->parallel_queue) {
+			ti->error = "Couldn't create kcryptd parallel queue";
+			goto bad;
+		}
+	}
+
 	ti->num_flush_requests = 1;
 	ti->discard_zeroes_data_unsupported = 1;
 
@@ -1704,6 +1883,7 @@ static int crypt_status(struct dm_target *ti, status_type_t type,
 {
 	struct crypt_config *cc = ti->private;
 	unsigned int sz = 0;
+	unsigned int num_feature_args;
 
 	switch (type) {
 	case STATUSTYPE_INFO:
@@ -1728,8 +1908,15 @@ static int crypt_status(struct dm_target *ti, status_type_t type,
 		DMEMIT(" %llu %s %llu", (unsigned long long)cc->iv_offset,
 				cc->dev->name, (unsigned long long)cc->start);
 
-		if (ti->num_discard_requests)
-			DMEMIT(" 1 allow_discards");
+		num_feature_args = !!ti->num_discard_requests +
+				   test_bit(DM_CRYPT_SAME_CPU, &cc->flags);
+		if (num_feature_args) {
+			DMEMIT(" %u", num_feature_args);
+			if (ti->num_discard_requests)
+				DMEMIT(" allow_discards");
+			if (test_bit(DM_CRYPT_SAME_CPU, &cc->flags))
+				DMEMIT(" same_cpu_crypt");
+		}
 
 		break;
 	}
@@ -1827,7 +2014,7 @@ static int crypt_iterate_devices(struct dm_target *ti,
 
 static struct target_type crypt_target = {
 	.name   = "crypt",
-	.version = {1, 11, 0},
+	.version = {1, 12, 0},
 	.module = THIS_MODULE,
 	.ctr    = crypt_ctr,
 	.dtr    = crypt_dtr,
@@ -12,18 +12,38 @@
  * hash device. Setting this greatly improves performance when data and hash
  * are on the same disk on different partitions on devices with poor random
  * access behavior.
+ *
+ * With the optional "check_at_most_once" table argument, each data and hash
+ * block is hashed only the first time it is read; later reads of a block
+ * already found valid skip the hash.  This trusts the device not to change
+ * data behind our back after it has been verified once, so it is meant for
+ * read-only system images.  The first corruption found turns it off.
+ *
+ * The blocks of a large bio are split into parts of at least
+ * DM_VERITY_MIN_PART_BLOCKS blocks, up to one per online CPU, which are
+ * verified in parallel; the bio completes when the last part does.  Each
+ * CPU has its own preallocated hash descriptor.  The status line reports
+ * the number of data blocks verified, the number skipped because they
+ * were already verified, and the nanoseconds spent hashing.
  */
 
 #include "dm-bufio.h"
 
 #include <linux/module.h>
 #include <linux/device-mapper.h>
+#include <linux/vmalloc.h>
+#include <linux/percpu.h>
+#include <linux/sched.h>
+#include <linux/mutex.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include <crypto/hash.h>
 
 #define DM_MSG_PREFIX			"verity"
 
 #define DM_VERITY_IO_VEC_INLINE		16
 #define DM_VERITY_MEMPOOL_SIZE		4
+#define DM_VERITY_MIN_PART_BLOCKS	8
 #define DM_VERITY_DEFAULT_PREFETCH_SIZE	262144
 
 #define DM_VERITY_MAX_LEVELS		63
@@ -32,6 +52,17 @@ static unsigned dm_verity_prefetch_cluster = DM_VERITY_DEFAULT_PREFETCH_SIZE;
 
 module_param_named(prefetch_cluster, dm_verity_prefetch_cluster, uint, S_IRUGO | S_IWUSR);
 
+/*
+ * Per-CPU counters, summed over all CPUs in debugfs "dm-verity/stats".
+ * Updates are not atomic against a concurrent reader, so the sums are
+ * approximate on 32-bit machines.
+ */
+struct dm_verity_stats {
+	u64 verified_blocks;	/* data blocks hashed and found valid */
+	u64 skipped_blocks;	/* data blocks skipped by check_at_most_once */
+	u64 hash_ns;		/* time spent hashing data and hash blocks */
+};
+
 struct dm_verity {
 	struct dm_dev *data_dev;
 	struct dm_dev *hash_dev;
@@ -52,18 +83,60 @@ struct dm_verity {
 	unsigned char levels;	/* the number of tree levels */
 	unsigned char version;
 	unsigned digest_size;	/* digest size for the current hash algorithm */
-	unsigned shash_descsize;/* the size of temporary space for crypto */
+	unsigned shash_descsize;/* the size of struct shash_desc with context */
 	int hash_failed;	/* set to 1 if hash of any block failed */
 
+	/*
+	 * check_at_most_once: one bit per data block and per hash block
+	 * (indexed from hash_start) that has been verified.  Only trusted
+	 * while hash_failed is clear.
+	 */
+	unsigned long *validated_blocks;
+	unsigned long *validated_hash_blocks;
+
 	mempool_t *io_mempool;	/* mempool of struct dm_verity_io */
+	mempool_t *part_mempool;/* mempool of struct dm_verity_part */
 	mempool_t *vec_mempool;	/* mempool of bio vector */
 
+	/* per-CPU struct shash_desc followed by a digest buffer */
+	void __percpu *hash_desc;
+	struct dm_verity_stats __percpu *stats;
+	struct list_head stats_list;	/* on dm_verity_stats_targets */
+
 	struct workqueue_struct *verify_wq;
 
 	/* starting blocks for each tree level. 0 is the lowest level. */
 	sector_t hash_level_block[DM_VERITY_MAX_LEVELS];
 };
 
+static LIST_HEAD(dm_verity_stats_targets);
+static DEFINE_MUTEX(dm_verity_stats_lock);
+static struct dentry *dm_verity_debugfs;
+
+struct dm_verity_io;
+
+/*
+ * A run of consecutive blocks of an io, verified by one work item.
+ */
+struct dm_verity_part {
+	struct dm_verity_io *io;
+	sector_t block;
+	unsigned n_blocks;
+
+	/* position of the first block in io->io_vec */
+	unsigned vector;
+	unsigned offset;
+
+	struct work_struct work;
+
+	/*
+	 * The digest expected at the current tree level.  It follows the
+	 * struct dm_verity_io for the embedded part and the struct
+	 * dm_verity_part for parts allocated from part_mempool.
+	 */
+	u8 *want_digest;
+};
+
 struct dm_verity_io {
 	struct dm_verity *v;
 	struct bio *bio;
@@ -79,37 +152,21 @@ struct dm_verity_io {
 	struct bio_vec *io_vec;
 	unsigned io_vec_size;
 
-	struct work_struct work;
+	/* parts not yet verified, and the error of a failed one */
+	atomic_t parts_pending;
+	int error;
+
+	struct dm_verity_part part;
 
 	/* A space for short vectors; longer vectors are allocated separately. */
 	struct bio_vec io_vec_inline[DM_VERITY_IO_VEC_INLINE];
 
 	/*
-	 * Three variably-size fields follow this struct:
-	 *
-	 * u8 hash_desc[v->shash_descsize];
-	 * u8 real_digest[v->digest_size];
-	 * u8 want_digest[v->digest_size];
-	 *
-	 * To access them use: io_hash_desc(), io_real_digest() and io_want_digest().
+	 * u8 want_digest[v->digest_size] of the embedded part follows
+	 * this struct.
 	 */
 };
 
-static struct shash_desc *io_hash_desc(struct dm_verity *v, struct dm_verity_io *io)
-{
-	return (struct shash_desc *)(io + 1);
-}
-
-static u8 *io_real_digest(struct dm_verity *v, struct dm_verity_io *io)
-{
-	return (u8 *)(io + 1) + v->shash_descsize;
-}
-
-static u8 *io_want_digest(struct dm_verity *v, struct dm_verity_io *io)
-{
-	return (u8 *)(io + 1) + v->shash_descsize + v->digest_size;
-}
-
 /*
  * Auxiliary structure appended to each dm-bufio buffer. If the value
  * hash_verified is nonzero, hash of the block has been verified.
@@ -136,6 +193,18 @@ static void dm_bufio_alloc_callback(struct dm_buffer *buf)
 	aux->hash_verified = 0;
 }
 
+static bool verity_is_validated(struct dm_verity *v, unsigned long *bitmap,
+				sector_t block)
+{
+	return bitmap && likely(!v->hash_failed) && test_bit(block, bitmap);
+}
+
+static void verity_set_validated(unsigned long *bitmap, sector_t block)
+{
+	if (bitmap)
+		set_bit(block, bitmap);
+}
+
 /*
  * Translate input sector number to the sector number on the target device.
  */
@@ -174,21 +243,167 @@ static void verity_hash_at_level(struct dm_verity *v, sector_t block, int level,
 		*offset = idx << (v->hash_dev_block_bits - v->hash_per_block_bits);
 }
 
+/*
+ * The hash functions below run on this CPU's preallocated descriptor
+ * (v->hash_desc: struct shash_desc, its context and a digest buffer).
+ * The caller keeps preemption disabled from verity_hash_init() to
+ * verity_hash_final(), so the hash must not sleep.
+ */
+static int verity_hash_init(struct dm_verity *v, struct shash_desc *desc)
+{
+	int r;
+
+	desc->tfm = v->tfm;
+	desc->flags = 0;
+	r = crypto_shash_init(desc);
+	if (r < 0) {
+		DMERR("crypto_shash_init failed: %d", r);
+		return r;
+	}
+
+	if (likely(v->version >= 1)) {
+		r = crypto_shash_update(desc, v->salt, v->salt_size);
+		if (r < 0) {
+			DMERR("crypto_shash_update failed: %d", r);
+			return r;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Returns 0 if the digest matches want_digest, 1 if it doesn't, or a
+ * negative error code.
+ */
+static int verity_hash_final(struct dm_verity *v, struct shash_desc *desc,
+			     const u8 *want_digest)
+{
+	u8 *result = (u8 *)desc + v->shash_descsize;
+	int r;
+
+	if (!v->version) {
+		r = crypto_shash_update(desc, v->salt, v->salt_size);
+		if (r < 0) {
+			DMERR("crypto_shash_update failed: %d", r);
+			return r;
+		}
+	}
+
+	r = crypto_shash_final(desc, result);
+	if (r < 0) {
+		DMERR("crypto_shash_final failed: %d", r);
+		return r;
+	}
+
+	return memcmp(result, want_digest, v->digest_size) ? 1 : 0;
+}
+
+/*
+ * Hash a metadata block and compare it against want_digest.
+ */
+static int verity_hash_buffer(struct dm_verity *v, const u8 *data,
+			      const u8 *want_digest)
+{
+	struct shash_desc *desc;
+	u64 start;
+	int r;
+
+	preempt_disable();
+	desc = this_cpu_ptr(v->hash_desc);
+	start = local_clock();
+
+	r = verity_hash_init(v, desc);
+	if (r < 0)
+		goto out;
+
+	r = crypto_shash_update(desc, data, 1 << v->hash_dev_block_bits);
+	if (r < 0) {
+		DMERR("crypto_shash_update failed: %d", r);
+		goto out;
+	}
+
+	r = verity_hash_final(v, desc, want_digest);
+out:
+	__this_cpu_add(v->stats->hash_ns, local_clock() - start);
+	preempt_enable();
+
+	return r;
+}
+
+/*
+ * Hash the data block at *vector, *offset of the saved bio vector,
+ * compare it against want_digest and step past it.
+ */
+static int verity_hash_data_block(struct dm_verity_io *io, unsigned *vector,
+				  unsigned *offset, const u8 *want_digest)
+{
+	struct dm_verity *v = io->v;
+	struct shash_desc *desc;
+	unsigned todo;
+	u64 start;
+	int r;
+
+	preempt_disable();
+	desc = this_cpu_ptr(v->hash_desc);
+	start = local_clock();
+
+	r = verity_hash_init(v, desc);
+	if (r < 0)
+		goto out;
+
+	todo = 1 << v->data_dev_block_bits;
+	do {
+		struct bio_vec *bv;
+		u8 *page;
+		unsigned len;
+
+		BUG_ON(*vector >= io->io_vec_size);
+		bv = &io->io_vec[*vector];
+		page = kmap_atomic(bv->bv_page);
+		len = bv->bv_len - *offset;
+		if (likely(len >= todo))
+			len = todo;
+		r = crypto_shash_update(desc,
+				page + bv->bv_offset + *offset, len);
+		kunmap_atomic(page);
+		if (r < 0) {
+			DMERR("crypto_shash_update failed: %d", r);
+			goto out;
+		}
+		*offset += len;
+		if (likely(*offset == bv->bv_len)) {
+			*offset = 0;
+			(*vector)++;
+		}
+		todo -= len;
+	} while (todo);
+
+	r = verity_hash_final(v, desc, want_digest);
+	if (!r)
+		__this_cpu_inc(v->stats->verified_blocks);
+out:
+	__this_cpu_add(v->stats->hash_ns, local_clock() - start);
+	preempt_enable();
+
+	return r;
+}
+
 /*
  * Verify hash of a metadata block pertaining to the specified data block
  * ("block" argument) at a specified level ("level" argument).
  *
- * On successful return, io_want_digest(v, io) contains the hash value for
+ * On successful return, p->want_digest contains the hash value for
  * a lower tree level or for the data block (if we're at the lowest leve).
  *
  * If "skip_unverified" is true, unverified buffer is skipped and 1 is returned.
  * If "skip_unverified" is false, unverified buffer is hashed and verified
- * against current value of io_want_digest(v, io).
+ * against current value of p->want_digest.
  */
-static int verity_verify_level(struct dm_verity_io *io, sector_t block,
+static int verity_verify_level(struct dm_verity_part *p, sector_t block,
 			       int level, bool skip_unverified)
 {
-	struct dm_verity *v = io->v;
+	struct dm_verity *v = p->io->v;
 	struct dm_buffer *buf;
 	struct buffer_aux *aux;
 	u8 *data;
@@ -204,65 +419,36 @@ static int verity_verify_level(struct dm_verity_io *io, sector_t block,
 
 	aux = dm_bufio_get_aux_data(buf);
 
-	if (!aux->hash_verified) {
-		struct shash_desc *desc;
-		u8 *result;
+	if (!aux->hash_verified &&
+	    verity_is_validated(v, v->validated_hash_blocks,
+				hash_block - v->hash_start))
+		aux->hash_verified = 1;
 
+	if (!aux->hash_verified) {
 		if (skip_unverified) {
 			r = 1;
 			goto release_ret_r;
 		}
 
-		desc = io_hash_desc(v, io);
-		desc->tfm = v->tfm;
-		desc->flags = CRYPTO_TFM_REQ_MAY_SLEEP;
-		r = crypto_shash_init(desc);
-		if (r < 0) {
-			DMERR("crypto_shash_init failed: %d", r);
+		r = verity_hash_buffer(v, data, p->want_digest);
+		if (r < 0)
 			goto release_ret_r;
-		}
-
-		if (likely(v->version >= 1)) {
-			r = crypto_shash_update(desc, v->salt, v->salt_size);
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
-				goto release_ret_r;
-			}
-		}
-
-		r = crypto_shash_update(desc, data, 1 << v->hash_dev_block_bits);
-		if (r < 0) {
-			DMERR("crypto_shash_update failed: %d", r);
-			goto release_ret_r;
-		}
-
-		if (!v->version) {
-			r = crypto_shash_update(desc, v->salt, v->salt_size);
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
-				goto release_ret_r;
-			}
-		}
-
-		result = io_real_digest(v, io);
-		r = crypto_shash_final(desc, result);
-		if (r < 0) {
-			DMERR("crypto_shash_final failed: %d", r);
-			goto release_ret_r;
-		}
-		if (unlikely(memcmp(result, io_want_digest(v, io), v->digest_size))) {
+		if (unlikely(r)) {
 			DMERR_LIMIT("metadata block %llu is corrupted",
 				(unsigned long long)hash_block);
 			v->hash_failed = 1;
 			r = -EIO;
 			goto release_ret_r;
-		} else
+		} else {
 			aux->hash_verified = 1;
+			verity_set_validated(v->validated_hash_blocks,
+					     hash_block - v->hash_start);
+		}
 	}
 
 	data += offset;
 
-	memcpy(io_want_digest(v, io), data, v->digest_size);
+	memcpy(p->want_digest, data, v->digest_size);
 
 	dm_bufio_release(buf);
 	return 0;
@@ -274,20 +460,49 @@ release_ret_r:
 }
 
 /*
- * Verify one "dm_verity_io" structure.
+ * Step over one data block in the saved bio vector without hashing it.
  */
-static int verity_verify_io(struct dm_verity_io *io)
+static void verity_skip_block(struct dm_verity_io *io, unsigned *vector,
+			      unsigned *offset)
 {
+	unsigned todo = 1 << io->v->data_dev_block_bits;
+
+	do {
+		struct bio_vec *bv;
+		unsigned len;
+
+		BUG_ON(*vector >= io->io_vec_size);
+		bv = &io->io_vec[*vector];
+		len = min(bv->bv_len - *offset, todo);
+		*offset += len;
+		if (likely(*offset == bv->bv_len)) {
+			*offset = 0;
+			(*vector)++;
+		}
+		todo -= len;
+	} while (todo);
+}
+
+/*
+ * Verify the blocks of one "dm_verity_part" structure.
+ */
+static int verity_verify_part(struct dm_verity_part *p)
+{
+	struct dm_verity_io *io = p->io;
 	struct dm_verity *v = io->v;
 	unsigned b;
 	int i;
-	unsigned vector = 0, offset = 0;
+	unsigned vector = p->vector, offset = p->offset;
 
-	for (b = 0; b < io->n_blocks; b++) {
-		struct shash_desc *desc;
-		u8 *result;
+	for (b = 0; b < p->n_blocks; b++) {
 		int r;
-		unsigned todo;
+
+		if (verity_is_validated(v, v->validated_blocks,
+					p->block + b)) {
+			verity_skip_block(io, &vector, &offset);
+			this_cpu_inc(v->stats->skipped_blocks);
+			continue;
+		}
 
 		if (likely(v->levels)) {
 			/*
@@ -297,89 +512,39 @@ static int verity_verify_io(struct dm_verity_io *io)
 			 * function returns 0 and we fall back to whole
 			 * chain verification.
 			 */
-			int r = verity_verify_level(io, io->block + b, 0, true);
+			int r = verity_verify_level(p, p->block + b, 0, true);
 			if (likely(!r))
 				goto test_block_hash;
 			if (r < 0)
 				return r;
 		}
 
-		memcpy(io_want_digest(v, io), v->root_digest, v->digest_size);
+		memcpy(p->want_digest, v->root_digest, v->digest_size);
 
 		for (i = v->levels - 1; i >= 0; i--) {
-			int r = verity_verify_level(io, io->block + b, i, false);
+			int r = verity_verify_level(p, p->block + b, i, false);
 			if (unlikely(r))
 				return r;
 		}
 
 test_block_hash:
-		desc = io_hash_desc(v, io);
-		desc->tfm = v->tfm;
-		desc->flags = CRYPTO_TFM_REQ_MAY_SLEEP;
-		r = crypto_shash_init(desc);
-		if (r < 0) {
-			DMERR("crypto_shash_init failed: %d", r);
-			return r;
-		}
-
-		if (likely(v->version >= 1)) {
-			r = crypto_shash_update(desc, v->salt, v->salt_size);
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
-				return r;
-			}
-		}
-
-		todo = 1 << v->data_dev_block_bits;
-		do {
-			struct bio_vec *bv;
-			u8 *page;
-			unsigned len;
-
-			BUG_ON(vector >= io->io_vec_size);
-			bv = &io->io_vec[vector];
-			page = kmap_atomic(bv->bv_page);
-			len = bv->bv_len - offset;
-			if (likely(len >= todo))
-				len = todo;
-			r = crypto_shash_update(desc,
-					page + bv->bv_offset + offset, len);
-			kunmap_atomic(page);
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
-				return r;
-			}
-			offset += len;
-			if (likely(offset == bv->bv_len)) {
-				offset = 0;
-				vector++;
-			}
-			todo -= len;
-		} while (todo);
-
-		if (!v->version) {
-			r = crypto_shash_update(desc, v->salt, v->salt_size);
-			if (r < 0) {
-				DMERR("crypto_shash_update failed: %d", r);
-				return r;
-			}
-		}
-
-		result = io_real_digest(v, io);
-		r = crypto_shash_final(desc, result);
-		if (r < 0) {
-			DMERR("crypto_shash_final failed: %d", r);
+		r = verity_hash_data_block(io, &vector, &offset,
+					   p->want_digest);
+		if (r < 0)
 			return r;
-		}
-		if (unlikely(memcmp(result, io_want_digest(v, io), v->digest_size))) {
+		if (unlikely(r)) {
 			DMERR_LIMIT("data block %llu is corrupted",
-				(unsigned long long)(io->block + b));
+				(unsigned long long)(p->block + b));
 			v->hash_failed = 1;
 			return -EIO;
 		}
+
+		verity_set_validated(v->validated_blocks, p->block + b);
+	}
+	if (p->block + p->n_blocks == io->block + io->n_blocks) {
+		BUG_ON(vector != io->io_vec_size);
+		BUG_ON(offset);
 	}
-	BUG_ON(vector != io->io_vec_size);
-	BUG_ON(offset);
 
 	return 0;
 }
@@ -405,9 +570,79 @@ static void verity_finish_io(struct dm_verity_io *io, int error)
 
 static void verity_work(struct work_struct *w)
 {
-	struct dm_verity_io *io = container_of(w, struct dm_verity_io, work);
+	struct dm_verity_part *p = container_of(w, struct dm_verity_part, work);
+	struct dm_verity_io *io = p->io;
+	int r;
+
+	r = verity_verify_part(p);
+	if (unlikely(r))
+		io->error = r;
+
+	if (p != &io->part)
+		mempool_free(p, io->v->part_mempool);
+
+	if (atomic_dec_and_test(&io->parts_pending))
+		verity_finish_io(io, io->error);
+}
+
+static void verity_queue_part(struct dm_verity_part *p)
+{
+	INIT_WORK(&p->work, verity_work);
+	queue_work(p->io->v->verify_wq, &p->work);
+}
+
+/*
+ * Split the blocks of an io into up to one part per online CPU, each at
+ * least DM_VERITY_MIN_PART_BLOCKS long, and queue the parts on the
+ * unbound workqueue so that they are hashed in parallel.  This runs on
+ * bio completion, so extra parts are allocated without waiting; if that
+ * fails, the remaining blocks simply stay in the last part.
+ */
+static void verity_queue_parts(struct dm_verity_io *io)
+{
+	struct dm_verity *v = io->v;
+	struct dm_verity_part *p = &io->part, *next;
+	unsigned n_parts, per_part, b, i;
+	unsigned vector = 0, offset = 0;
+
+	n_parts = min_t(unsigned, num_online_cpus(),
+			DIV_ROUND_UP(io->n_blocks, DM_VERITY_MIN_PART_BLOCKS));
+	per_part = n_parts > 1 ? DIV_ROUND_UP(io->n_blocks, n_parts) :
+				 io->n_blocks;
+
+	io->error = 0;
+	atomic_set(&io->parts_pending, 1);
+
+	p->io = io;
+	p->block = io->block;
+	p->n_blocks = io->n_blocks;
+	p->vector = 0;
+	p->offset = 0;
+	p->want_digest = (u8 *)(io + 1);
+
+	for (b = per_part; b < io->n_blocks; b += per_part) {
+		next = mempool_alloc(v->part_mempool, GFP_NOWAIT);
+		if (!next)
+			break;
+
+		for (i = 0; i < per_part; i++)
+			verity_skip_block(io, &vector, &offset);
+
+		next->io = io;
+		next->block = io->block + b;
+		next->n_blocks = io->n_blocks - b;
+		next->vector = vector;
+		next->offset = offset;
+		next->want_digest = (u8 *)(next + 1);
+
+		/* count "next" before the previous part can finish the io */
+		p->n_blocks = per_part;
+		atomic_inc(&io->parts_pending);
+		verity_queue_part(p);
+		p = next;
+	}
 
-	verity_finish_io(io, verity_verify_io(io));
+	verity_queue_part(p);
 }
 
 static void verity_end_io(struct bio *bio, int error)
@@ -419,8 +654,7 @@ static void verity_end_io(struct bio *bio, int error)
 		return;
 	}
 
-	INIT_WORK(&io->work, verity_work);
-	queue_work(io->v->verify_wq, &io->work);
+	verity_queue_parts(io);
 }
 
 /*
@@ -544,6 +778,8 @@ static int verity_status(struct dm_target *ti, status_type_t type,
 		else
 			for (x = 0; x < v->salt_size; x++)
 				DMEMIT("%02x", v->salt[x]);
+		if (v->validated_blocks)
+			DMEMIT(" 1 check_at_most_once");
 		break;
 	}
 
@@ -600,22 +836,84 @@ static void verity_io_hints(struct dm_target *ti, struct queue_limits *limits)
 	blk_limits_io_min(limits, limits->logical_block_size);
 }
 
+/*
+ * debugfs "dm-verity/stats": one line per verity target, giving the
+ * device, the target start sector, V or C as in the status line, and
+ * the number of data blocks verified, skipped and the nanoseconds
+ * spent hashing.
+ */
+static int verity_stats_show(struct seq_file *m, void *unused)
+{
+	struct dm_verity *v;
+	int cpu;
+
+	mutex_lock(&dm_verity_stats_lock);
+	list_for_each_entry(v, &dm_verity_stats_targets, stats_list) {
+		u64 verified = 0, skipped = 0, hash_ns = 0;
+
+		for_each_possible_cpu(cpu) {
+			struct dm_verity_stats *st = per_cpu_ptr(v->stats, cpu);
+
+			verified += st->verified_blocks;
+			skipped += st->skipped_blocks;
+			hash_ns += st->hash_ns;
+		}
+		seq_printf(m, "%s %llu %c %llu %llu %llu\n",
+			   dm_device_name(dm_table_get_md(v->ti->table)),
+			   (unsigned long long)v->ti->begin,
+			   v->hash_failed ? 'C' : 'V',
+			   (unsigned long long)verified,
+			   (unsigned long long)skipped,
+			   (unsigned long long)hash_ns);
+	}
+	mutex_unlock(&dm_verity_stats_lock);
+
+	return 0;
+}
+
+static int verity_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, verity_stats_show, NULL);
+}
+
+static const struct file_operations verity_stats_fops = {
+	.open		= verity_stats_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
 static void verity_dtr(struct dm_target *ti)
 {
 	struct dm_verity *v = ti->private;
 
+	if (!list_empty(&v->stats_list)) {
+		mutex_lock(&dm_verity_stats_lock);
+		list_del(&v->stats_list);
+		mutex_unlock(&dm_verity_stats_lock);
+	}
+
 	if (v->verify_wq)
 		destroy_workqueue(v->verify_wq);
 
 	if (v->vec_mempool)
 		mempool_destroy(v->vec_mempool);
 
+	if (v->part_mempool)
+		mempool_destroy(v->part_mempool);
+
 	if (v->io_mempool)
 		mempool_destroy(v->io_mempool);
 
+	free_percpu(v->stats);
+	free_percpu(v->hash_desc);
+
 	if (v->bufio)
 		dm_bufio_client_destroy(v->bufio);
 
+	vfree(v->validated_blocks);
+	vfree(v->validated_hash_blocks);
+
 	kfree(v->salt);
 	kfree(v->root_digest);
 
@@ -633,6 +931,37 @@ static void verity_dtr(struct dm_target *ti)
 	kfree(v);
 }
 
+/*
+ * Allocate the check_at_most_once bitmaps.  The bitops take unsigned
+ * long indexes, so devices with more blocks than that are refused.
+ */
+static int verity_alloc_validated(struct dm_verity *v)
+{
+	sector_t hash_blocks = v->hash_blocks - v->hash_start;
+
+	if (v->validated_blocks)
+		return 0;
+
+	if (v->data_blocks != (unsigned long)v->data_blocks ||
+	    hash_blocks != (unsigned long)hash_blocks)
+		return -E2BIG;
+
+	v->validated_blocks = vzalloc(BITS_TO_LONGS(v->data_blocks) *
+				      sizeof(unsigned long));
+	if (!v->validated_blocks)
+		return -ENOMEM;
+
+	/* a single data block has no hash blocks, only the root digest */
+	if (hash_blocks) {
+		v->validated_hash_blocks = vzalloc(BITS_TO_LONGS(hash_blocks) *
+						   sizeof(unsigned long));
+		if (!v->validated_hash_blocks)
+			return -ENOMEM;
+	}
+
+	return 0;
+}
+
 /*
  * Target parameters:
  *	<version>	The current format is version 1.
@@ -646,6 +975,11 @@ static void verity_dtr(struct dm_target *ti)
  *	<algorithm>
  *	<digest>
  *	<salt>		Hex string or "-" if no salt.
+ *
+ * Optional parameters:
+ *	<#opt_params>	The number of optional parameters that follow.
+ *	check_at_most_once
+ *			Hash each data and hash block only on its first read.
  */
 static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 {
@@ -656,6 +990,13 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 	int i;
 	sector_t hash_position;
 	char dummy;
+	struct dm_arg_set as;
+	const char *opt_string;
+	unsigned opt_params;
+
+	static struct dm_arg _args[] = {
+		{0, 1, "Invalid number of feature args"},
+	};
 
 	v = kzalloc(sizeof(struct dm_verity), GFP_KERNEL);
 	if (!v) {
@@ -664,6 +1005,7 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 	}
 	ti->private = v;
 	v->ti = ti;
+	INIT_LIST_HEAD(&v->stats_list);
 
 	if ((dm_table_get_mode(ti->table) & ~FMODE_READ)) {
 		ti->error = "Device must be readonly";
@@ -671,8 +1013,8 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 		goto bad;
 	}
 
-	if (argc != 10) {
-		ti->error = "Invalid argument count: exactly 10 arguments required";
+	if (argc < 10) {
+		ti->error = "Invalid argument count: at least 10 arguments required";
 		r = -EINVAL;
 		goto bad;
 	}
@@ -841,14 +1183,81 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 		goto bad;
 	}
 
+	argv += 10;
+	argc -= 10;
+
+	/* Optional parameters */
+	if (argc) {
+		as.argc = argc;
+		as.argv = argv;
+
+		r = dm_read_arg_group(_args, &as, &opt_params, &ti->error);
+		if (r)
+			goto bad;
+
+		while (opt_params--) {
+			opt_string = dm_shift_arg(&as);
+			if (!opt_string) {
+				ti->error = "Not enough feature arguments";
+				r = -EINVAL;
+				goto bad;
+			}
+
+			if (!strcasecmp(opt_string, "check_at_most_once")) {
+				r = verity_alloc_validated(v);
+				if (r == -E2BIG) {
+					ti->error = "Too many blocks for check_at_most_once";
+					goto bad;
+				}
+				if (r) {
+					ti->error = "Cannot allocate verified block bitmap";
+					goto bad;
+				}
+			} else {
+				ti->error = "Invalid feature arguments";
+				r = -EINVAL;
+				goto bad;
+			}
+		}
+
+		if (as.argc) {
+			ti->error = "Unexpected arguments after feature arguments";
+			r = -EINVAL;
+			goto bad;
+		}
+	}
+
+	v->hash_desc = __alloc_percpu(v->shash_descsize + v->digest_size,
+				      CRYPTO_MINALIGN);
+	if (!v->hash_desc) {
+		ti->error = "Cannot allocate hash descriptors";
+		r = -ENOMEM;
+		goto bad;
+	}
+
+	v->stats = alloc_percpu(struct dm_verity_stats);
+	if (!v->stats) {
+		ti->error = "Cannot allocate statistics";
+		r = -ENOMEM;
+		goto bad;
+	}
+
 	v->io_mempool = mempool_create_kmalloc_pool(DM_VERITY_MEMPOOL_SIZE,
-	  sizeof(struct dm_verity_io) + v->shash_descsize + v->digest_size * 2);
+	  sizeof(struct dm_verity_io) + v->digest_size);
 	if (!v->io_mempool) {
 		ti->error = "Cannot allocate io mempool";
 		r = -ENOMEM;
 		goto bad;
 	}
 
+	v->part_mempool = mempool_create_kmalloc_pool(DM_VERITY_MEMPOOL_SIZE,
+	  sizeof(struct dm_verity_part) + v->digest_size);
+	if (!v->part_mempool) {
+		ti->error = "Cannot allocate part mempool";
+		r = -ENOMEM;
+		goto bad;
+	}
+
 	v->vec_mempool = mempool_create_kmalloc_pool(DM_VERITY_MEMPOOL_SIZE,
 					BIO_MAX_PAGES * sizeof(struct bio_vec));
 	if (!v->vec_mempool) {
@@ -865,6 +1274,10 @@ static int verity_ctr(struct dm_target *ti, unsigned argc, char **argv)
 		goto bad;
 	}
 
+	mutex_lock(&dm_verity_stats_lock);
+	list_add_tail(&v->stats_list, &dm_verity_stats_targets);
+	mutex_unlock(&dm_verity_stats_lock);
+
 	return 0;
 
 bad:
@@ -875,7 +1288,7 @@ bad:
 
 static struct target_type verity_target = {
 	.name		= "verity",
-	.version	= {1, 0, 0},
+	.version	= {1, 2, 0},
 	.module		= THIS_MODULE,
 	.ctr		= verity_ctr,
 	.dtr		= verity_dtr,
@@ -892,14 +1305,23 @@ static int __init dm_verity_init(void)
 	int r;
 
 	r = dm_register_target(&verity_target);
-	if (r < 0)
+	if (r < 0) {
 		DMERR("register failed %d", r);
+		return r;
+	}
 
-	return r;
+	/* statistics are optional, so debugfs errors are ignored */
+	dm_verity_debugfs = debugfs_create_dir("dm-verity", NULL);
+	if (!IS_ERR_OR_NULL(dm_verity_debugfs))
+		debugfs_create_file("stats", S_IRUSR, dm_verity_debugfs, NULL,
+				    &verity_stats_fops);
+
+	return 0;
 }
 
 static void __exit dm_verity_exit(void)
 {
+	debugfs_remove_recursive(dm_verity_debugfs);
 	dm_unregister_target(&verity_target);
 }
 
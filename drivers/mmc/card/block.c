@@ -34,6 +34,7 @@
 #include <linux/delay.h>
 #include <linux/capability.h>
 #include <linux/compat.h>
+#include <linux/ktime.h>
 
 #include <linux/mmc/ioctl.h>
 #include <linux/mmc/card.h>
@@ -67,10 +68,12 @@ MODULE_ALIAS("mmc:block");
 			(req->cmd_flags & REQ_META)) && \
 			(rq_data_dir(req) == WRITE))
 #define PACKED_CMD_VER		0x01
+#define PACKED_CMD_RD		0x01
 #define PACKED_CMD_WR		0x02
+#define PACKED_RD_HDR_TIMEOUT	500 /* msec */
 #define MMC_BLK_UPDATE_STOP_REASON(stats, reason)			\
 	do {								\
-		if (stats->enabled)					\
+		if (stats && stats->enabled)				\
 			stats->pack_stop_reason[reason]++;		\
 	} while (0)
 
@@ -125,6 +128,7 @@ struct mmc_blk_data {
 	struct device_attribute power_ro_lock;
 	int	area_type;
 	struct device_attribute num_wr_reqs_to_start_packing;
+	struct device_attribute wr_pack_max_latency;
 };
 
 static DEFINE_MUTEX(open_lock);
@@ -357,6 +361,36 @@ num_wr_reqs_to_start_packing_store(struct device *dev,
 	return count;
 }
 
+static ssize_t
+wr_pack_max_latency_show(struct device *dev,
+			 struct device_attribute *attr, char *buf)
+{
+	struct mmc_blk_data *md = mmc_blk_get(dev_to_disk(dev));
+	int ret;
+
+	ret = snprintf(buf, PAGE_SIZE, "%u\n",
+		       md->queue.wr_pack_max_latency_us);
+
+	mmc_blk_put(md);
+	return ret;
+}
+
+static ssize_t
+wr_pack_max_latency_store(struct device *dev,
+			  struct device_attribute *attr,
+			  const char *buf, size_t count)
+{
+	unsigned int value;
+	struct mmc_blk_data *md = mmc_blk_get(dev_to_disk(dev));
+
+	/* 0 disables the bound */
+	if (sscanf(buf, "%u", &value) == 1)
+		md->queue.wr_pack_max_latency_us = value;
+
+	mmc_blk_put(md);
+	return count;
+}
+
 static int mmc_blk_open(struct block_device *bdev, fmode_t mode)
 {
 	struct mmc_blk_data *md = mmc_blk_get(bdev->bd_disk);
@@ -531,6 +565,9 @@ static int mmc_blk_ioctl_cmd(struct block_device *bdev,
 
 	mmc_claim_host(card->host);
 
+	/* Arbitrary commands may leave data in the card's cache */
+	card->cache_clean = false;
+
 	if (idata->ic.is_acmd) {
 		err = mmc_app_cmd(card->host, card);
 		if (err)
@@ -1063,9 +1100,24 @@ static int mmc_blk_issue_flush(struct mmc_queue *mq, struct request *req)
 	struct mmc_card *card = md->queue.card;
 	int ret = 0;
 
+	/*
+	 * Nothing was written to the card since the last successful
+	 * flush, so there is nothing for this one to make durable.  This
+	 * collapses the back to back flushes of fsync() storms, such as a
+	 * post-flush immediately followed by the next pre-flush.
+	 */
+	if (card->cache_clean) {
+		card->flush_stats.coalesced++;
+		blk_end_request_all(req, 0);
+		return 1;
+	}
+
 	ret = mmc_flush_cache(card);
+	card->flush_stats.issued++;
 	if (ret)
 		ret = -EIO;
+	else
+		card->cache_clean = true;
 
 	blk_end_request_all(req, ret);
 
@@ -1556,6 +1608,10 @@ void print_mmc_packing_stats(struct mmc_card *card)
 		pr_info("%s: %d times: Threshold\n",
 			mmc_hostname(card->host),
 			card->wr_pack_stats.pack_stop_reason[THRESHOLD]);
+	if (card->wr_pack_stats.pack_stop_reason[LATENCY_BOUND])
+		pr_info("%s: %d times: read latency bound\n",
+			mmc_hostname(card->host),
+			card->wr_pack_stats.pack_stop_reason[LATENCY_BOUND]);
 
 	spin_unlock(&card->wr_pack_stats.lock);
 }
@@ -1570,10 +1626,11 @@ static u8 mmc_blk_prep_packed_list(struct mmc_queue *mq, struct request *req)
 	bool en_rel_wr = card->ext_csd.rel_param & EXT_CSD_WR_REL_PARAM_EN;
 	unsigned int req_sectors = 0, phys_segments = 0;
 	unsigned int max_blk_count, max_phys_segs;
+	unsigned int max_lat_sectors = UINT_MAX;
 	u8 put_back = 0;
 	u8 max_packed_rw = 0;
 	u8 reqs = 0;
-	struct mmc_wr_pack_stats *stats = &card->wr_pack_stats;
+	struct mmc_wr_pack_stats *stats = NULL;
 
 	mmc_blk_clear_packed(mq->mqrq_cur);
 
@@ -1581,16 +1638,32 @@ static u8 mmc_blk_prep_packed_list(struct mmc_queue *mq, struct request *req)
 			!card->ext_csd.packed_event_en)
 		goto no_packed;
 
-	if (!mq->wr_packing_enabled)
-		goto no_packed;
-
-	if ((rq_data_dir(cur) == WRITE) &&
-			(card->host->caps2 & MMC_CAP2_PACKED_WR))
+	/*
+	 * Reads are packed whenever more of them are queued; the write
+	 * packing control only decides whether writes are worth packing.
+	 * Packing statistics cover writes only.
+	 */
+	if (rq_data_dir(cur) == READ) {
+		if (card->host->caps2 & MMC_CAP2_PACKED_RD)
+			max_packed_rw = card->ext_csd.max_packed_reads;
+	} else if (mq->wr_packing_enabled &&
+			(card->host->caps2 & MMC_CAP2_PACKED_WR)) {
 		max_packed_rw = card->ext_csd.max_packed_writes;
+		stats = &card->wr_pack_stats;
+	}
 
 	if (max_packed_rw == 0)
 		goto no_packed;
 
+	/*
+	 * Keep a packed write short enough that a read queued behind it
+	 * is not held off for longer than wr_pack_max_latency_us.
+	 */
+	if (stats && mq->wr_pack_max_latency_us && mq->wr_pack_ns_per_sector)
+		max_lat_sectors = div_u64((u64)mq->wr_pack_max_latency_us *
+					  NSEC_PER_USEC,
+					  mq->wr_pack_ns_per_sector);
+
 	if (mmc_req_rel_wr(cur) &&
 			(md->flags & MMC_BLK_REL_WR) &&
 			!en_rel_wr) {
@@ -1611,7 +1684,7 @@ static u8 mmc_blk_prep_packed_list(struct mmc_queue *mq, struct request *req)
 		phys_segments++;
 	}
 
-	spin_lock(&stats->lock);
+	spin_lock(&card->wr_pack_stats.lock);
 
 	while (reqs < max_packed_rw - 1) {
 		spin_lock_irq(q->queue_lock);
@@ -1645,8 +1718,13 @@ static u8 mmc_blk_prep_packed_list(struct mmc_queue *mq, struct request *req)
 
 		req_sectors += blk_rq_sectors(next);
 		if (req_sectors > max_blk_count) {
-			if (stats->enabled)
-				stats->pack_stop_reason[EXCEEDS_SECTORS]++;
+			MMC_BLK_UPDATE_STOP_REASON(stats, EXCEEDS_SECTORS);
+			put_back = 1;
+			break;
+		}
+
+		if (req_sectors > max_lat_sectors) {
+			MMC_BLK_UPDATE_STOP_REASON(stats, LATENCY_BOUND);
 			put_back = 1;
 			break;
 		}
@@ -1671,14 +1749,14 @@ static u8 mmc_blk_prep_packed_list(struct mmc_queue *mq, struct request *req)
 		spin_unlock_irq(q->queue_lock);
 	}
 
-	if (stats->enabled) {
+	if (stats && stats->enabled) {
 		if (reqs + 1 <= card->ext_csd.max_packed_writes)
 			stats->packing_events[reqs + 1]++;
 		if (reqs + 1 == max_packed_rw)
 			MMC_BLK_UPDATE_STOP_REASON(stats, THRESHOLD);
 	}
 
-	spin_unlock(&stats->lock);
+	spin_unlock(&card->wr_pack_stats.lock);
 
 	if (reqs > 0) {
 		list_add(&req->queuelist, &mq->mqrq_cur->packed_list);
@@ -1706,6 +1784,7 @@ static void mmc_blk_packed_hdr_wrq_prep(struct mmc_queue_req *mqrq,
 	mqrq->packed_cmd = MMC_PACKED_WRITE;
 	mqrq->packed_blocks = 0;
 	mqrq->packed_fail_idx = MMC_PACKED_N_IDX;
+	mqrq->packed_start = ktime_get();
 
 	memset(packed_cmd_hdr, 0, sizeof(mqrq->packed_cmd_hdr));
 	packed_cmd_hdr[0] = (mqrq->packed_num << 16) |
@@ -1791,6 +1870,194 @@ static void mmc_blk_packed_hdr_wrq_prep(struct mmc_queue_req *mqrq,
 	mmc_queue_bounce_pre(mqrq);
 }
 
+/*
+ * Put back all packed entries except the first one, which stays in
+ * mqrq->req so that the caller can issue it as a normal request.
+ */
+static void mmc_blk_requeue_packed(struct mmc_queue *mq,
+				   struct mmc_queue_req *mqrq)
+{
+	struct request *prq;
+
+	while (!list_empty(&mqrq->packed_list)) {
+		prq = list_entry_rq(mqrq->packed_list.prev);
+		if (prq->queuelist.prev != &mqrq->packed_list) {
+			list_del_init(&prq->queuelist);
+			spin_lock_irq(mq->queue->queue_lock);
+			blk_requeue_request(mq->queue, prq);
+			spin_unlock_irq(mq->queue->queue_lock);
+		} else {
+			list_del_init(&prq->queuelist);
+		}
+	}
+	mmc_blk_clear_packed(mqrq);
+}
+
+/*
+ * A packed read is done in two phases: the packed command header is
+ * written to the card with CMD25, then the data of all entries is read
+ * with a single CMD18.  The header is written synchronously here, so the
+ * card must not be busy with another request.  Returns 0 if the data
+ * phase was prepared; otherwise the packed entries have been put back
+ * and the caller should issue mqrq->req on its own.
+ */
+static int mmc_blk_packed_hdr_rrq_prep(struct mmc_queue_req *mqrq,
+				       struct mmc_card *card,
+				       struct mmc_queue *mq)
+{
+	struct mmc_blk_request *brq = &mqrq->brq;
+	struct request *req = mqrq->req;
+	struct request *prq;
+	struct mmc_request mrq = {NULL};
+	struct mmc_command sbc = {0};
+	struct mmc_command cmd = {0};
+	struct mmc_command stop = {0};
+	struct mmc_data data = {0};
+	struct scatterlist sg;
+	u32 *packed_cmd_hdr = mqrq->packed_cmd_hdr;
+	unsigned long timeout;
+	u32 status;
+	int err;
+	u8 i = 1;
+
+	mqrq->packed_cmd = MMC_PACKED_READ;
+	mqrq->packed_blocks = 0;
+	mqrq->packed_fail_idx = MMC_PACKED_N_IDX;
+
+	memset(packed_cmd_hdr, 0, sizeof(mqrq->packed_cmd_hdr));
+	packed_cmd_hdr[0] = (mqrq->packed_num << 16) |
+		(PACKED_CMD_RD << 8) | PACKED_CMD_VER;
+
+	list_for_each_entry(prq, &mqrq->packed_list, queuelist) {
+		/* Argument of CMD23 */
+		packed_cmd_hdr[(i * 2)] = blk_rq_sectors(prq);
+		/* Argument of CMD18 */
+		packed_cmd_hdr[((i * 2)) + 1] =
+			mmc_card_blockaddr(card) ?
+			blk_rq_pos(prq) : blk_rq_pos(prq) << 9;
+		mqrq->packed_blocks += blk_rq_sectors(prq);
+		i++;
+	}
+
+	mrq.sbc = &sbc;
+	mrq.cmd = &cmd;
+	mrq.data = &data;
+	mrq.stop = &stop;
+
+	sbc.opcode = MMC_SET_BLOCK_COUNT;
+	sbc.arg = MMC_CMD23_ARG_PACKED | 1;
+	sbc.flags = MMC_RSP_R1 | MMC_CMD_AC;
+
+	cmd.opcode = MMC_WRITE_MULTIPLE_BLOCK;
+	cmd.arg = packed_cmd_hdr[3];
+	cmd.flags = MMC_RSP_SPI_R1 | MMC_RSP_R1 | MMC_CMD_ADTC;
+
+	data.blksz = 512;
+	data.blocks = 1;
+	data.flags = MMC_DATA_WRITE;
+	data.sg = &sg;
+	data.sg_len = 1;
+	sg_init_one(&sg, packed_cmd_hdr, sizeof(mqrq->packed_cmd_hdr));
+	mmc_set_data_timeout(&data, card);
+
+	stop.opcode = MMC_STOP_TRANSMISSION;
+	stop.arg = 0;
+	stop.flags = MMC_RSP_SPI_R1B | MMC_RSP_R1B | MMC_CMD_AC;
+
+	mmc_wait_for_req(card->host, &mrq);
+	if (sbc.error || cmd.error || data.error || stop.error) {
+		err = -EIO;
+		goto no_packed;
+	}
+
+	timeout = jiffies + msecs_to_jiffies(PACKED_RD_HDR_TIMEOUT);
+	do {
+		err = get_card_status(card, &status, 5);
+		if (err)
+			goto no_packed;
+		if (status & (R1_EXP_EVENT | CMD_ERRORS)) {
+			err = -EIO;
+			goto no_packed;
+		}
+		if ((status & R1_READY_FOR_DATA) &&
+		    (R1_CURRENT_STATE(status) != R1_STATE_PRG))
+			break;
+		if (time_after(jiffies, timeout)) {
+			err = -ETIMEDOUT;
+			goto no_packed;
+		}
+	} while (1);
+
+	memset(brq, 0, sizeof(struct mmc_blk_request));
+	brq->mrq.cmd = &brq->cmd;
+	brq->mrq.data = &brq->data;
+	brq->mrq.sbc = &brq->sbc;
+	brq->mrq.stop = &brq->stop;
+
+	brq->sbc.opcode = MMC_SET_BLOCK_COUNT;
+	brq->sbc.arg = MMC_CMD23_ARG_PACKED | mqrq->packed_blocks;
+	brq->sbc.flags = MMC_RSP_R1 | MMC_CMD_AC;
+
+	brq->cmd.opcode = MMC_READ_MULTIPLE_BLOCK;
+	brq->cmd.arg = blk_rq_pos(req);
+	if (!mmc_card_blockaddr(card))
+		brq->cmd.arg <<= 9;
+	brq->cmd.flags = MMC_RSP_SPI_R1 | MMC_RSP_R1 | MMC_CMD_ADTC;
+
+	brq->data.blksz = 512;
+	brq->data.blocks = mqrq->packed_blocks;
+	brq->data.flags |= MMC_DATA_READ;
+
+	brq->stop.opcode = MMC_STOP_TRANSMISSION;
+	brq->stop.arg = 0;
+	brq->stop.flags = MMC_RSP_SPI_R1B | MMC_RSP_R1B | MMC_CMD_AC;
+
+	mmc_set_data_timeout(&brq->data, card);
+
+	brq->data.sg = mqrq->sg;
+	brq->data.sg_len = mmc_queue_map_sg(mq, mqrq);
+
+	mqrq->mmc_active.mrq = &brq->mrq;
+	mqrq->mmc_active.err_check = mmc_blk_packed_err_check;
+
+	mmc_queue_bounce_pre(mqrq);
+	return 0;
+
+no_packed:
+	pr_warning("%s: packed read header failed (%d), issuing unpacked\n",
+		   req->rq_disk->disk_name, err);
+	mmc_blk_requeue_packed(mq, mqrq);
+	return err;
+}
+
+/*
+ * Keep a running estimate of the card's packed write cost per sector.
+ * With requests pipelined, a packed write starts occupying the card when
+ * it is prepared or when the previous request completes, whichever is
+ * later.
+ */
+static void mmc_blk_update_wr_pack_cost(struct mmc_queue *mq,
+					struct mmc_queue_req *mqrq,
+					ktime_t now)
+{
+	ktime_t start = mqrq->packed_start;
+	u64 ns;
+
+	if (ktime_to_ns(mq->last_done) > ktime_to_ns(start))
+		start = mq->last_done;
+
+	ns = div_u64(ktime_to_ns(ktime_sub(now, start)),
+		     mqrq->packed_blocks + 1);
+	if (ns > UINT_MAX)
+		ns = UINT_MAX;
+
+	if (!mq->wr_pack_ns_per_sector)
+		mq->wr_pack_ns_per_sector = ns;
+	else
+		mq->wr_pack_ns_per_sector =
+			((u64)mq->wr_pack_ns_per_sector * 7 + ns) >> 3;
+}
+
 static int mmc_blk_cmd_err(struct mmc_blk_data *md, struct mmc_card *card,
 			   struct mmc_blk_request *brq, struct request *req,
 			   int ret)
@@ -1863,20 +2130,35 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 	struct mmc_async_req *areq;
 	const u8 packed_num = 2;
 	u8 reqs = 0;
+	ktime_t now;
 
 	if (!rqc && !mq->mqrq_prev->req)
 		return 0;
 
-	if (rqc)
+	if (rqc) {
 		reqs = mmc_blk_prep_packed_list(mq, rqc);
+		/*
+		 * The header of a packed read is written synchronously,
+		 * so complete the ongoing async transfer first.
+		 */
+		if (reqs >= packed_num && rq_data_dir(rqc) == READ &&
+				card->host->areq)
+			mmc_blk_issue_rw_rq(mq, NULL);
+	}
 
 	do {
 		if (rqc) {
-			if (reqs >= packed_num)
+			if (reqs >= packed_num && rq_data_dir(rqc) == READ) {
+				if (mmc_blk_packed_hdr_rrq_prep(mq->mqrq_cur,
+							card, mq))
+					mmc_blk_rw_rq_prep(mq->mqrq_cur,
+							card, 0, mq);
+			} else if (reqs >= packed_num) {
 				mmc_blk_packed_hdr_wrq_prep(mq->mqrq_cur,
 						card, mq);
-			else
+			} else {
 				mmc_blk_rw_rq_prep(mq->mqrq_cur, card, 0, mq);
+			}
 			areq = &mq->mqrq_cur->mmc_active;
 		} else
 			areq = NULL;
@@ -1890,6 +2172,12 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 		type = rq_data_dir(req) == READ ? MMC_BLK_READ : MMC_BLK_WRITE;
 		mmc_queue_bounce_post(mq_rq);
 
+		now = ktime_get();
+		if (status == MMC_BLK_SUCCESS &&
+				mq_rq->packed_cmd == MMC_PACKED_WRITE)
+			mmc_blk_update_wr_pack_cost(mq, mq_rq, now);
+		mq->last_done = now;
+
 		/*
 		 * Check BKOPS urgency from each R1 response
 		 */
@@ -1982,6 +2270,19 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 						disable_multi, mq);
 				mmc_start_req(card->host,
 						&mq_rq->mmc_active, NULL);
+			} else if (mq_rq->packed_cmd == MMC_PACKED_READ) {
+				/*
+				 * The next request may already be in flight,
+				 * so the packed header cannot be written
+				 * synchronously here.  Put the remaining
+				 * entries back and retry the failed one
+				 * unpacked.
+				 */
+				mmc_blk_requeue_packed(mq, mq_rq);
+				mmc_blk_rw_rq_prep(mq_rq, card,
+						disable_multi, mq);
+				mmc_start_req(card->host,
+						&mq_rq->mmc_active, NULL);
 			} else {
 				mmc_blk_packed_hdr_wrq_prep(mq_rq, card, mq);
 				mmc_start_req(card->host,
@@ -2013,22 +2314,8 @@ static int mmc_blk_issue_rw_rq(struct mmc_queue *mq, struct request *rqc)
 		/*
 		 * If current request is packed, it needs to put back.
 		 */
-		if (mq->mqrq_cur->packed_cmd != MMC_PACKED_NONE) {
-			while (!list_empty(&mq->mqrq_cur->packed_list)) {
-				prq = list_entry_rq(
-					mq->mqrq_cur->packed_list.prev);
-				if (prq->queuelist.prev !=
-						&mq->mqrq_cur->packed_list) {
-					list_del_init(&prq->queuelist);
-					spin_lock_irq(mq->queue->queue_lock);
-					blk_requeue_request(mq->queue, prq);
-					spin_unlock_irq(mq->queue->queue_lock);
-				} else {
-					list_del_init(&prq->queuelist);
-				}
-			}
-			mmc_blk_clear_packed(mq->mqrq_cur);
-		}
+		if (mq->mqrq_cur->packed_cmd != MMC_PACKED_NONE)
+			mmc_blk_requeue_packed(mq, mq->mqrq_cur);
 		mmc_blk_rw_rq_prep(mq->mqrq_cur, card, 0, mq);
 		mmc_start_req(card->host, &mq->mqrq_cur->mmc_active, NULL);
 	}
@@ -2064,6 +2351,9 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 
 	mmc_blk_write_packing_control(mq, req);
 
+	if (req && rq_data_dir(req) == WRITE && !(req->cmd_flags & REQ_FLUSH))
+		card->cache_clean = false;
+
 	if (req && req->cmd_flags & REQ_SANITIZE) {
 		/* complete ongoing async transfer before issuing sanitize */
 		if (card->host && card->host->areq)
@@ -2108,6 +2398,7 @@ static struct mmc_blk_data *mmc_blk_alloc_req(struct mmc_card *card,
 {
 	struct mmc_blk_data *md;
 	int devidx, ret;
+	bool has_cache;
 
 	devidx = find_first_zero_bit(dev_use, max_devices);
 	if (devidx >= max_devices)
@@ -2197,9 +2488,24 @@ static struct mmc_blk_data *mmc_blk_alloc_req(struct mmc_card *card,
 	    ((card->ext_csd.rel_param & EXT_CSD_WR_REL_PARAM_EN) ||
 	     card->ext_csd.rel_sectors)) {
 		md->flags |= MMC_BLK_REL_WR;
-		blk_queue_flush(md->queue.queue, REQ_FLUSH | REQ_FUA);
 	}
 
+	/*
+	 * REQ_FUA is served with a reliable write.  In legacy reliable
+	 * write mode that splits the transfer into rel_sectors sized
+	 * chunks, which costs more than letting the block layer follow
+	 * the write with a cache flush, so only advertise FUA when the
+	 * card has no cache or supports enhanced reliable write.
+	 */
+	has_cache = mmc_card_mmc(card) && card->ext_csd.cache_size > 0 &&
+		(card->host->caps2 & MMC_CAP2_CACHE_CTRL);
+	if ((md->flags & MMC_BLK_REL_WR) &&
+	    ((card->ext_csd.rel_param & EXT_CSD_WR_REL_PARAM_EN) ||
+	     !has_cache))
+		blk_queue_flush(md->queue.queue, REQ_FLUSH | REQ_FUA);
+	else if ((md->flags & MMC_BLK_REL_WR) || has_cache)
+		blk_queue_flush(md->queue.queue, REQ_FLUSH);
+
 	return md;
 
  err_putdisk:
@@ -2297,6 +2603,8 @@ static void mmc_blk_remove_req(struct mmc_blk_data *md)
 		card = md->queue.card;
 		device_remove_file(disk_to_dev(md->disk),
 				   &md->num_wr_reqs_to_start_packing);
+		device_remove_file(disk_to_dev(md->disk),
+				   &md->wr_pack_max_latency);
 		if (md->disk->flags & GENHD_FL_UP) {
 			device_remove_file(disk_to_dev(md->disk), &md->force_ro);
 			if ((md->area_type & MMC_BLK_DATA_AREA_BOOT) &&
@@ -2377,8 +2685,21 @@ static int mmc_add_disk(struct mmc_blk_data *md)
 	if (ret)
 		goto power_ro_lock_fail;
 
+	md->wr_pack_max_latency.show = wr_pack_max_latency_show;
+	md->wr_pack_max_latency.store = wr_pack_max_latency_store;
+	sysfs_attr_init(&md->wr_pack_max_latency.attr);
+	md->wr_pack_max_latency.attr.name = "wr_pack_max_latency_us";
+	md->wr_pack_max_latency.attr.mode = S_IRUGO | S_IWUSR;
+	ret = device_create_file(disk_to_dev(md->disk),
+				 &md->wr_pack_max_latency);
+	if (ret)
+		goto wr_pack_max_latency_fail;
+
 	return ret;
 
+wr_pack_max_latency_fail:
+	device_remove_file(disk_to_dev(md->disk),
+			   &md->num_wr_reqs_to_start_packing);
 power_ro_lock_fail:
 		device_remove_file(disk_to_dev(md->disk), &md->force_ro);
 force_ro_fail:
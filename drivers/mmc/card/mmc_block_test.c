@@ -113,6 +113,11 @@ struct mmc_block_test_data {
 	unsigned int random_test_seed;
 	/* A retry counter used in err_check tests */
 	int err_check_counter;
+	/*
+	 * The packed write latency bound of the queue, disabled while a test
+	 * runs so that it does not change the expected stop reasons
+	 */
+	unsigned int saved_wr_pack_max_latency_us;
 	/* Can be one of the values of enum test_group */
 	enum mmc_block_test_group test_group;
 	/*
@@ -953,6 +958,9 @@ static int prepare_test(struct test_data *td)
 	if (mbtd->test_group == TEST_ERR_CHECK_GROUP)
 		mq->err_check_fn = test_err_check;
 
+	mbtd->saved_wr_pack_max_latency_us = mq->wr_pack_max_latency_us;
+	mq->wr_pack_max_latency_us = 0;
+
 	switch (td->test_info.testcase) {
 	case TEST_STOP_DUE_TO_FLUSH:
 	case TEST_STOP_DUE_TO_READ:
@@ -1027,6 +1035,7 @@ static int post_test(struct test_data *td)
 
 	mq->packed_test_fn = NULL;
 	mq->err_check_fn = NULL;
+	mq->wr_pack_max_latency_us = mbtd->saved_wr_pack_max_latency_us;
 
 	return 0;
 }
@@ -30,6 +30,7 @@
  * manage to keep the high write throughput.
  */
 #define DEFAULT_NUM_REQS_TO_START_PACK 17
+#define DEFAULT_WR_PACK_MAX_LATENCY_US 10000
 
 /*
  * Prepare a MMC request. This just filters out odd stuff.
@@ -201,6 +202,7 @@ int mmc_init_queue(struct mmc_queue *mq, struct mmc_card *card,
 	mq->mqrq_prev = mqrq_prev;
 	mq->queue->queuedata = mq;
 	mq->num_wr_reqs_to_start_packing = DEFAULT_NUM_REQS_TO_START_PACK;
+	mq->wr_pack_max_latency_us = DEFAULT_WR_PACK_MAX_LATENCY_US;
 
 	blk_queue_prep_rq(mq->queue, mmc_prep_request);
 	queue_flag_set_unlocked(QUEUE_FLAG_NONROT, mq->queue);
@@ -26,6 +26,7 @@ enum mmc_blk_status {
 enum mmc_packed_cmd {
 	MMC_PACKED_NONE = 0,
 	MMC_PACKED_WRITE,
+	MMC_PACKED_READ,
 };
 
 struct mmc_queue_req {
@@ -42,6 +43,7 @@ struct mmc_queue_req {
 	enum mmc_packed_cmd	packed_cmd;
 	int		packed_fail_idx;
 	u8		packed_num;
+	ktime_t		packed_start;
 };
 
 struct mmc_queue {
@@ -58,6 +60,15 @@ struct mmc_queue {
 	bool			wr_packing_enabled;
 	int			num_of_potential_packed_wr_reqs;
 	int			num_wr_reqs_to_start_packing;
+	/*
+	 * Upper bound on the time a packed write may occupy the card, so
+	 * that a read arriving behind it is not delayed by more than this.
+	 * wr_pack_ns_per_sector is a running estimate of the card's packed
+	 * write cost, used to turn the bound into a sector budget.
+	 */
+	unsigned int		wr_pack_max_latency_us;
+	u32			wr_pack_ns_per_sector;
+	ktime_t			last_done;
 	int (*err_check_fn) (struct mmc_card *, struct mmc_async_req *);
 	void (*packed_test_fn) (struct request_queue *, struct mmc_queue_req *);
 };
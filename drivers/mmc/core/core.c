@@ -39,6 +39,9 @@
 #include "host.h"
 #include "sdio_bus.h"
 
+#define CREATE_TRACE_POINTS
+#include <trace/events/mmc.h>
+
 #include "mmc_ops.h"
 #include "sd_ops.h"
 #include "sdio_ops.h"
@@ -140,6 +143,47 @@ static inline void mmc_should_fail_request(struct mmc_host *host,
 
 #endif /* CONFIG_FAIL_MMC_REQUEST */
 
+#ifdef CONFIG_MMC_LATENCY_HIST
+
+static void mmc_lat_hist_record(struct mmc_host *host,
+				struct mmc_request *mrq)
+{
+	struct mmc_lat_hist *hist = host->lat_hist;
+	unsigned int size = 0, bucket;
+	s64 us;
+
+	if (!hist)
+		return;
+
+	if (mrq->data) {
+		unsigned int bytes = mrq->data->blksz * mrq->data->blocks;
+
+		if (bytes <= 4096)
+			size = 1;
+		else if (bytes <= 65536)
+			size = 2;
+		else
+			size = 3;
+	}
+
+	us = ktime_us_delta(ktime_get(), mrq->io_start);
+	if (us < 0)
+		us = 0;
+	bucket = min_t(unsigned int, fls(min_t(s64, us, UINT_MAX)),
+		       MMC_LAT_HIST_BUCKETS - 1);
+
+	hist->count[mrq->cmd->opcode % MMC_LAT_HIST_OPCODES][size][bucket]++;
+}
+
+#else
+
+static inline void mmc_lat_hist_record(struct mmc_host *host,
+				       struct mmc_request *mrq)
+{
+}
+
+#endif /* CONFIG_MMC_LATENCY_HIST */
+
 /**
  *	mmc_request_done - finish processing an MMC request
  *	@host: MMC host which completed request
@@ -173,6 +217,9 @@ void mmc_request_done(struct mmc_host *host, struct mmc_request *mrq)
 
 		led_trigger_event(host->led, LED_OFF);
 
+		trace_mmc_request_done(host, mrq);
+		mmc_lat_hist_record(host, mrq);
+
 		pr_debug("%s: req done (CMD%u): %d: %08x %08x %08x %08x\n",
 			mmc_hostname(host), cmd->opcode, err,
 			cmd->resp[0], cmd->resp[1],
@@ -284,6 +331,10 @@ mmc_start_request(struct mmc_host *host, struct mmc_request *mrq)
 	}
 	mmc_host_clk_hold(host);
 	led_trigger_event(host->led, LED_FULL);
+	trace_mmc_request_start(host, mrq);
+#ifdef CONFIG_MMC_LATENCY_HIST
+	mrq->io_start = ktime_get();
+#endif
 	host->ops->request(host, mrq);
 }
 
@@ -186,6 +186,72 @@ static int mmc_clock_opt_set(void *data, u64 val)
 DEFINE_SIMPLE_ATTRIBUTE(mmc_clock_fops, mmc_clock_opt_get, mmc_clock_opt_set,
 	"%llu\n");
 
+#ifdef CONFIG_MMC_LATENCY_HIST
+static const char *mmc_lat_hist_size_str[MMC_LAT_HIST_SIZES] = {
+	"nodata", "<=4K", "<=64K", ">64K",
+};
+
+static int mmc_lat_hist_show(struct seq_file *s, void *data)
+{
+	struct mmc_host *host = s->private;
+	struct mmc_lat_hist *hist = host->lat_hist;
+	int op, size, i;
+	u32 total;
+
+	seq_printf(s, "dma:\t%u\npio:\t%u\n", hist->dma, hist->pio);
+
+	seq_printf(s, "%-14s", "usecs <");
+	for (i = 0; i < MMC_LAT_HIST_BUCKETS - 1; i++)
+		seq_printf(s, " %7u", 1U << i);
+	seq_printf(s, " %7s\n", "more");
+
+	for (op = 0; op < MMC_LAT_HIST_OPCODES; op++) {
+		for (size = 0; size < MMC_LAT_HIST_SIZES; size++) {
+			total = 0;
+			for (i = 0; i < MMC_LAT_HIST_BUCKETS; i++)
+				total += hist->count[op][size][i];
+			if (!total)
+				continue;
+
+			seq_printf(s, "CMD%-2d %-8s", op,
+				   mmc_lat_hist_size_str[size]);
+			for (i = 0; i < MMC_LAT_HIST_BUCKETS; i++)
+				seq_printf(s, " %7u", hist->count[op][size][i]);
+			seq_printf(s, "\n");
+		}
+	}
+
+	return 0;
+}
+
+static int mmc_lat_hist_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mmc_lat_hist_show, inode->i_private);
+}
+
+static ssize_t mmc_lat_hist_write(struct file *filp, const char __user *ubuf,
+				  size_t cnt, loff_t *ppos)
+{
+	struct seq_file *s = filp->private_data;
+	struct mmc_host *host = s->private;
+
+	/* Any write clears the histograms */
+	mmc_claim_host(host);
+	memset(host->lat_hist, 0, sizeof(*host->lat_hist));
+	mmc_release_host(host);
+
+	return cnt;
+}
+
+static const struct file_operations mmc_lat_hist_fops = {
+	.open		= mmc_lat_hist_open,
+	.read		= seq_read,
+	.write		= mmc_lat_hist_write,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+#endif
+
 void mmc_add_host_debugfs(struct mmc_host *host)
 {
 	struct dentry *root;
@@ -213,6 +279,12 @@ void mmc_add_host_debugfs(struct mmc_host *host)
 				root, &host->clk_delay))
 		goto err_node;
 #endif
+#ifdef CONFIG_MMC_LATENCY_HIST
+	if (host->lat_hist &&
+	    !debugfs_create_file("latency_hist", S_IRUSR | S_IWUSR, root,
+				 host, &mmc_lat_hist_fops))
+		goto err_node;
+#endif
 #ifdef CONFIG_FAIL_MMC_REQUEST
 	if (fail_request)
 		setup_fault_attr(&fail_default_attr, fail_request);
@@ -432,6 +504,13 @@ static ssize_t mmc_wr_pack_stats_read(struct file *filp, char __user *ubuf,
 			pack_stats->pack_stop_reason[THRESHOLD]);
 		strlcat(ubuf, temp_buf, cnt);
 	}
+	if (pack_stats->pack_stop_reason[LATENCY_BOUND]) {
+		snprintf(temp_buf, TEMP_BUF_SIZE,
+			 "%s: %d times: read latency bound\n",
+			 mmc_hostname(card->host),
+			 pack_stats->pack_stop_reason[LATENCY_BOUND]);
+		strlcat(ubuf, temp_buf, cnt);
+	}
 
 	spin_unlock(&pack_stats->lock);
 
@@ -476,6 +555,44 @@ static const struct file_operations mmc_dbg_wr_pack_stats_fops = {
 	.write		= mmc_wr_pack_stats_write,
 };
 
+static int mmc_flush_stats_show(struct seq_file *s, void *data)
+{
+	struct mmc_card *card = s->private;
+
+	seq_printf(s, "issued:\t\t%u\n", card->flush_stats.issued);
+	seq_printf(s, "coalesced:\t%u\n", card->flush_stats.coalesced);
+
+	return 0;
+}
+
+static int mmc_flush_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mmc_flush_stats_show, inode->i_private);
+}
+
+static ssize_t mmc_flush_stats_write(struct file *filp,
+				     const char __user *ubuf, size_t cnt,
+				     loff_t *ppos)
+{
+	struct seq_file *s = filp->private_data;
+	struct mmc_card *card = s->private;
+
+	/* Any write resets the counters */
+	mmc_claim_host(card->host);
+	memset(&card->flush_stats, 0, sizeof(card->flush_stats));
+	mmc_release_host(card->host);
+
+	return cnt;
+}
+
+static const struct file_operations mmc_dbg_flush_stats_fops = {
+	.open		= mmc_flush_stats_open,
+	.read		= seq_read,
+	.write		= mmc_flush_stats_write,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
 void mmc_add_card_debugfs(struct mmc_card *card)
 {
 	struct mmc_host	*host = card->host;
@@ -514,6 +631,11 @@ void mmc_add_card_debugfs(struct mmc_card *card)
 					 &mmc_dbg_wr_pack_stats_fops))
 			goto err;
 
+	if (mmc_card_mmc(card) && card->ext_csd.cache_size > 0)
+		if (!debugfs_create_file("flush_stats", S_IRUSR | S_IWUSR,
+					 root, card, &mmc_dbg_flush_stats_fops))
+			goto err;
+
 	return;
 
 err:
@@ -333,6 +333,9 @@ struct mmc_host *mmc_alloc_host(int extra, struct device *dev)
 
 	spin_lock_init(&host->lock);
 	init_waitqueue_head(&host->wq);
+#ifdef CONFIG_MMC_LATENCY_HIST
+	host->lat_hist = kzalloc(sizeof(*host->lat_hist), GFP_KERNEL);
+#endif
 	wake_lock_init(&host->detect_wake_lock, WAKE_LOCK_SUSPEND,
 		kasprintf(GFP_KERNEL, "%s_detect", mmc_hostname(host)));
 	INIT_DELAYED_WORK(&host->detect, mmc_rescan);
@@ -502,6 +505,10 @@ void mmc_free_host(struct mmc_host *host)
 	idr_remove(&mmc_host_idr, host->index);
 	spin_unlock(&mmc_host_lock);
 	wake_lock_destroy(&host->detect_wake_lock);
+#ifdef CONFIG_MMC_LATENCY_HIST
+	kfree(host->lat_hist);
+	host->lat_hist = NULL;
+#endif
 
 	put_device(&host->class_dev);
 }
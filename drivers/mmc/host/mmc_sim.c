@@ -0,0 +1,1286 @@
+/*
+ *  linux/drivers/mmc/host/mmc_sim.c - Software-emulated eMMC host
+ *
+ * Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * The driver registers a host controller with a single non-removable
+ * eMMC 4.5 card behind it.  The card lives in RAM: its user area is a
+ * sparse array of pages, and EXT_CSD, packed commands, the volatile
+ * cache, erase/trim/discard and sanitize are emulated at command level,
+ * so the whole mmc core and block driver run unmodified on top of it.
+ *
+ * Every request is executed from a workqueue and completed from an
+ * hrtimer once the modelled service time has elapsed:
+ *
+ *   - each command (CMD23, the r/w command, CMD12, ...) costs cmd_lat_us;
+ *   - reads cost read_lat_us plus the payload at read_kbps;
+ *   - writes with the cache off, or reliable writes, cost write_lat_us
+ *     plus the payload at write_kbps;
+ *   - writes with the cache on only cost the payload at read_kbps (bus
+ *     speed), until the cache overflows; the overflow is programmed at
+ *     write_kbps;
+ *   - a cache flush costs flush_lat_us plus the dirty bytes at write_kbps;
+ *   - erase/trim/discard cost erase_lat_us, sanitize additionally
+ *     reprograms all discarded data at write_kbps.
+ *
+ * All model parameters are module parameters writable at runtime under
+ * /sys/module/mmc_sim/parameters.  Per-host counters are exported in
+ * debugfs as <host>/sim_stats, and <host>/sim_fail_packed_idx injects an
+ * indexed failure into the next packed command.
+ */
+
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/platform_device.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/highmem.h>
+#include <linux/scatterlist.h>
+#include <linux/workqueue.h>
+#include <linux/hrtimer.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#include <linux/mmc/host.h>
+#include <linux/mmc/card.h>
+#include <linux/mmc/mmc.h>
+
+#define DRIVER_NAME "mmc_sim"
+
+#define MMC_SIM_SECTOR_SIZE	512
+#define MMC_SIM_OCR		(MMC_CARD_SECTOR_ADDR | MMC_VDD_32_33 | \
+				 MMC_VDD_33_34 | MMC_VDD_165_195)
+#define MMC_SIM_RCA_NONE	0
+
+/* Packed command header, see JESD84-B45 6.6.29 */
+#define MMC_SIM_PACKED_VER	0x01
+#define MMC_SIM_PACKED_RD	0x01
+#define MMC_SIM_PACKED_WR	0x02
+#define MMC_SIM_MAX_PACKED	63	/* 128 header words, 2 per entry */
+
+static unsigned int nr_hosts = 1;
+module_param(nr_hosts, uint, 0444);
+MODULE_PARM_DESC(nr_hosts, "Number of emulated hosts (one card each)");
+
+static unsigned int capacity_mb = 256;
+module_param(capacity_mb, uint, 0444);
+MODULE_PARM_DESC(capacity_mb, "User area size of each card in MiB");
+
+static unsigned int cache_kb = 512;
+module_param(cache_kb, uint, 0444);
+MODULE_PARM_DESC(cache_kb, "Volatile cache size in KiB, 0 for no cache");
+
+static unsigned int max_packed_wr = 8;
+module_param(max_packed_wr, uint, 0444);
+MODULE_PARM_DESC(max_packed_wr, "EXT_CSD MAX_PACKED_WRITES, 0 disables");
+
+static unsigned int max_packed_rd = 8;
+module_param(max_packed_rd, uint, 0444);
+MODULE_PARM_DESC(max_packed_rd, "EXT_CSD MAX_PACKED_READS, 0 disables");
+
+static unsigned int cmd_lat_us = 20;
+module_param(cmd_lat_us, uint, 0644);
+MODULE_PARM_DESC(cmd_lat_us, "Per-command overhead in usec");
+
+static unsigned int read_lat_us = 100;
+module_param(read_lat_us, uint, 0644);
+MODULE_PARM_DESC(read_lat_us, "Read access latency in usec");
+
+static unsigned int write_lat_us = 400;
+module_param(write_lat_us, uint, 0644);
+MODULE_PARM_DESC(write_lat_us, "Program latency of an uncached write in usec");
+
+static unsigned int flush_lat_us = 2000;
+module_param(flush_lat_us, uint, 0644);
+MODULE_PARM_DESC(flush_lat_us, "Fixed cost of a cache flush in usec");
+
+static unsigned int erase_lat_us = 1000;
+module_param(erase_lat_us, uint, 0644);
+MODULE_PARM_DESC(erase_lat_us, "Cost of an erase/trim/discard in usec");
+
+static unsigned int read_kbps = 80 * 1024;
+module_param(read_kbps, uint, 0644);
+MODULE_PARM_DESC(read_kbps, "Read (and bus) bandwidth in KiB/s, 0 unlimited");
+
+static unsigned int write_kbps = 20 * 1024;
+module_param(write_kbps, uint, 0644);
+MODULE_PARM_DESC(write_kbps, "Flash program bandwidth in KiB/s, 0 unlimited");
+
+struct mmc_sim_packed_entry {
+	u32			blocks;
+	u32			addr;
+	bool			rel_wr;
+};
+
+struct mmc_sim_stats {
+	u64			cmds[64];
+	u64			read_cmds;
+	u64			read_bytes;
+	u64			write_cmds;
+	u64			write_bytes;
+	u64			rel_writes;
+	u64			packed_wr;
+	u64			packed_wr_entries;
+	u64			packed_rd;
+	u64			packed_rd_entries;
+	u64			packed_errors;
+	u64			flushes;
+	u64			flushed_bytes;
+	u64			cache_overflow_bytes;
+	u64			erases;
+	u64			trims;
+	u64			discards;
+	u64			sanitizes;
+	u64			switch_errors;
+	u64			busy_ns;
+};
+
+struct mmc_sim_host {
+	struct mmc_host		*mmc;
+	spinlock_t		lock;
+	struct mmc_request	*mrq;
+	ktime_t			mrq_start;
+	struct work_struct	work;
+	struct hrtimer		timer;
+
+	/* card */
+	struct page		**pages;
+	unsigned long		nr_pages;
+	u32			sectors;
+	unsigned int		rca;
+	unsigned int		state;
+	u32			status;		/* clear-on-read R1 bits */
+	u8			ext_csd[512];
+	u32			cid[4];
+	u32			csd[4];
+
+	/* state carried between commands */
+	u32			blocks;		/* last CMD23 block count */
+	bool			rel_wr;
+	bool			packed;
+	u32			erase_start;
+	u32			erase_end;
+	u64			cache_dirty;	/* bytes */
+	u64			discarded;	/* bytes awaiting sanitize */
+	unsigned int		packed_rd_num;
+	struct mmc_sim_packed_entry packed_rd[MMC_SIM_MAX_PACKED];
+	u32			packed_hdr[MMC_SIM_SECTOR_SIZE / 4];
+
+	u32			fail_packed_idx;
+	struct mmc_sim_stats	stats;
+	struct dentry		*debugfs_stats;
+	struct dentry		*debugfs_fail;
+};
+
+struct mmc_sim_cursor {
+	struct sg_mapping_iter	miter;
+	size_t			avail;
+	size_t			moved;
+};
+
+static struct workqueue_struct *mmc_sim_wq;
+static struct platform_device **mmc_sim_pdevs;
+
+static u64 mmc_sim_xfer_ns(u64 bytes, unsigned int kbps)
+{
+	if (!kbps)
+		return 0;
+	return div_u64(bytes * NSEC_PER_SEC, kbps * 1024ULL);
+}
+
+static inline u64 mmc_sim_us(unsigned int us)
+{
+	return (u64)us * NSEC_PER_USEC;
+}
+
+static void mmc_sim_stuff_bits(u32 *resp, int start, int size, u32 val)
+{
+	int i;
+
+	for (i = 0; i < size; i++, start++) {
+		u32 *word = &resp[3 - start / 32];
+
+		if (val & (1U << i))
+			*word |= 1U << (start & 31);
+		else
+			*word &= ~(1U << (start & 31));
+	}
+}
+
+/*
+ * Copy up to @len bytes between @buf and the request scatterlist,
+ * continuing where the previous call stopped.
+ */
+static size_t mmc_sim_sg_copy(struct mmc_sim_cursor *cur, void *buf,
+			      size_t len, bool to_sg)
+{
+	size_t moved = 0;
+
+	while (len) {
+		size_t chunk;
+		void *p;
+
+		if (!cur->avail) {
+			if (!sg_miter_next(&cur->miter))
+				break;
+			cur->avail = cur->miter.length;
+			cur->miter.consumed = 0;
+		}
+
+		chunk = min(len, cur->avail);
+		p = cur->miter.addr + cur->miter.consumed;
+		if (to_sg)
+			memcpy(p, buf, chunk);
+		else
+			memcpy(buf, p, chunk);
+
+		cur->miter.consumed += chunk;
+		cur->avail -= chunk;
+		buf += chunk;
+		len -= chunk;
+		moved += chunk;
+	}
+
+	cur->moved += moved;
+	return moved;
+}
+
+static void mmc_sim_cursor_start(struct mmc_sim_cursor *cur,
+				 struct mmc_data *data)
+{
+	unsigned int flags = data->flags & MMC_DATA_READ ?
+		SG_MITER_TO_SG : SG_MITER_FROM_SG;
+
+	memset(cur, 0, sizeof(*cur));
+	sg_miter_start(&cur->miter, data->sg, data->sg_len, flags);
+}
+
+static void mmc_sim_cursor_stop(struct mmc_sim_cursor *cur)
+{
+	sg_miter_stop(&cur->miter);
+}
+
+/*
+ * Move @nr sectors starting at @sector between the backing store and the
+ * scatterlist.  Pages are allocated on first write; never written pages
+ * read back as the erased value (zero).
+ */
+static int mmc_sim_store_io(struct mmc_sim_host *host,
+			    struct mmc_sim_cursor *cur, u32 sector, u32 nr,
+			    bool write)
+{
+	u64 pos = (u64)sector * MMC_SIM_SECTOR_SIZE;
+	u64 end = pos + (u64)nr * MMC_SIM_SECTOR_SIZE;
+
+	if ((u64)sector + nr > host->sectors)
+		return -ERANGE;
+
+	while (pos < end) {
+		unsigned long idx = pos >> PAGE_SHIFT;
+		unsigned int off = pos & ~PAGE_MASK;
+		size_t len = min_t(u64, PAGE_SIZE - off, end - pos);
+		struct page *page = host->pages[idx];
+		void *vaddr;
+
+		if (write && !page) {
+			page = alloc_page(GFP_NOIO | __GFP_ZERO | __GFP_HIGHMEM);
+			if (!page)
+				return -ENOMEM;
+			host->pages[idx] = page;
+		}
+
+		if (page) {
+			vaddr = kmap(page);
+			len = mmc_sim_sg_copy(cur, vaddr + off, len, !write);
+			kunmap(page);
+		} else {
+			len = mmc_sim_sg_copy(cur,
+				page_address(ZERO_PAGE(0)) + off, len, true);
+		}
+		if (!len)
+			return -EINVAL;
+		pos += len;
+	}
+
+	return 0;
+}
+
+static void mmc_sim_store_erase(struct mmc_sim_host *host, u32 from, u32 to)
+{
+	u64 pos = (u64)from * MMC_SIM_SECTOR_SIZE;
+	u64 end = ((u64)to + 1) * MMC_SIM_SECTOR_SIZE;
+
+	while (pos < end) {
+		unsigned long idx = pos >> PAGE_SHIFT;
+		unsigned int off = pos & ~PAGE_MASK;
+		size_t len = min_t(u64, PAGE_SIZE - off, end - pos);
+		struct page *page = host->pages[idx];
+
+		if (page) {
+			if (len == PAGE_SIZE) {
+				__free_page(page);
+				host->pages[idx] = NULL;
+			} else {
+				void *vaddr = kmap(page);
+
+				memset(vaddr + off, 0, len);
+				kunmap(page);
+			}
+		}
+		pos += len;
+	}
+}
+
+static void mmc_sim_store_free(struct mmc_sim_host *host)
+{
+	unsigned long i;
+
+	if (!host->pages)
+		return;
+
+	for (i = 0; i < host->nr_pages; i++)
+		if (host->pages[i])
+			__free_page(host->pages[i]);
+	vfree(host->pages);
+	host->pages = NULL;
+}
+
+/*
+ * Account a write of @bytes and return its modelled cost.
+ */
+static u64 mmc_sim_write_cost(struct mmc_sim_host *host, u64 bytes,
+			      bool rel_wr)
+{
+	u64 cache = (u64)cache_kb * 1024;
+	u64 ns;
+
+	if (rel_wr || !host->ext_csd[EXT_CSD_CACHE_CTRL] || !cache)
+		return mmc_sim_xfer_ns(bytes, write_kbps);
+
+	ns = mmc_sim_xfer_ns(bytes, read_kbps);
+	host->cache_dirty += bytes;
+	if (host->cache_dirty > cache) {
+		u64 over = host->cache_dirty - cache;
+
+		ns += mmc_sim_xfer_ns(over, write_kbps);
+		host->stats.cache_overflow_bytes += over;
+		host->cache_dirty = cache;
+	}
+	return ns;
+}
+
+static u64 mmc_sim_flush(struct mmc_sim_host *host)
+{
+	u64 ns = mmc_sim_us(flush_lat_us) +
+		mmc_sim_xfer_ns(host->cache_dirty, write_kbps);
+
+	host->stats.flushes++;
+	host->stats.flushed_bytes += host->cache_dirty;
+	host->cache_dirty = 0;
+	return ns;
+}
+
+static void mmc_sim_packed_error(struct mmc_sim_host *host, int index)
+{
+	host->ext_csd[EXT_CSD_EXP_EVENTS_STATUS] |= EXT_CSD_PACKED_FAILURE;
+	host->ext_csd[EXT_CSD_PACKED_CMD_STATUS] = EXT_CSD_PACKED_GENERIC_ERROR;
+	if (index > 0) {
+		host->ext_csd[EXT_CSD_PACKED_CMD_STATUS] |=
+			EXT_CSD_PACKED_INDEXED_ERROR;
+		host->ext_csd[EXT_CSD_PACKED_FAILURE_INDEX] = index;
+	}
+	host->stats.packed_errors++;
+}
+
+/*
+ * Parse the header block of a packed command.  Returns the number of
+ * entries or a negative error.
+ */
+static int mmc_sim_parse_packed_hdr(struct mmc_sim_host *host,
+				    struct mmc_sim_packed_entry *ent, u8 *rw)
+{
+	u32 *hdr = host->packed_hdr;
+	unsigned int num = (le32_to_cpu(hdr[0]) >> 16) & 0xff;
+	unsigned int i;
+
+	*rw = (le32_to_cpu(hdr[0]) >> 8) & 0xff;
+	if ((le32_to_cpu(hdr[0]) & 0xff) != MMC_SIM_PACKED_VER ||
+	    !num || num > MMC_SIM_MAX_PACKED)
+		return -EINVAL;
+	if (*rw == MMC_SIM_PACKED_WR && num > max_packed_wr)
+		return -EINVAL;
+	if (*rw == MMC_SIM_PACKED_RD && num > max_packed_rd)
+		return -EINVAL;
+	if (*rw != MMC_SIM_PACKED_WR && *rw != MMC_SIM_PACKED_RD)
+		return -EINVAL;
+
+	for (i = 0; i < num; i++) {
+		u32 arg = le32_to_cpu(hdr[(i + 1) * 2]);
+
+		ent[i].blocks = arg & 0xffff;
+		ent[i].rel_wr = !!(arg & MMC_CMD23_ARG_REL_WR);
+		ent[i].addr = le32_to_cpu(hdr[(i + 1) * 2 + 1]);
+		if (!ent[i].blocks ||
+		    (u64)ent[i].addr + ent[i].blocks > host->sectors)
+			return -EINVAL;
+	}
+
+	return num;
+}
+
+static u64 mmc_sim_packed_write(struct mmc_sim_host *host,
+				struct mmc_command *cmd,
+				struct mmc_sim_cursor *cur)
+{
+	struct mmc_data *data = cmd->data;
+	struct mmc_sim_packed_entry ent[MMC_SIM_MAX_PACKED];
+	u32 fail_idx = host->fail_packed_idx;
+	u64 ns = mmc_sim_us(write_lat_us);
+	int num, i, err;
+	u32 total = 0;
+	u8 rw;
+
+	if (mmc_sim_sg_copy(cur, host->packed_hdr, sizeof(host->packed_hdr),
+			    false) != sizeof(host->packed_hdr))
+		goto hdr_err;
+
+	num = mmc_sim_parse_packed_hdr(host, ent, &rw);
+	if (num < 0)
+		goto hdr_err;
+
+	if (rw == MMC_SIM_PACKED_RD) {
+		/* The header is the whole payload of a packed read request */
+		if (data->blocks != 1)
+			goto hdr_err;
+		memcpy(host->packed_rd, ent, num * sizeof(*ent));
+		host->packed_rd_num = num;
+		host->stats.packed_rd++;
+		host->stats.packed_rd_entries += num;
+		return ns;
+	}
+
+	for (i = 0; i < num; i++)
+		total += ent[i].blocks;
+	if (total + 1 != data->blocks)
+		goto hdr_err;
+
+	host->fail_packed_idx = 0;
+	host->stats.packed_wr++;
+	host->stats.packed_wr_entries += num;
+
+	for (i = 0; i < num; i++) {
+		u64 bytes = (u64)ent[i].blocks * MMC_SIM_SECTOR_SIZE;
+
+		if (fail_idx && i + 1 == fail_idx) {
+			mmc_sim_packed_error(host, fail_idx);
+			break;
+		}
+
+		err = mmc_sim_store_io(host, cur, ent[i].addr, ent[i].blocks,
+				       true);
+		if (err) {
+			mmc_sim_packed_error(host, i + 1);
+			data->error = err;
+			break;
+		}
+		if (ent[i].rel_wr)
+			host->stats.rel_writes++;
+		ns += mmc_sim_write_cost(host, bytes, ent[i].rel_wr);
+		host->stats.write_bytes += bytes;
+	}
+
+	host->stats.write_cmds++;
+	return ns;
+
+hdr_err:
+	mmc_sim_packed_error(host, 0);
+	host->status |= R1_ERROR;
+	data->error = -EIO;
+	return ns;
+}
+
+static u64 mmc_sim_packed_read(struct mmc_sim_host *host,
+			       struct mmc_command *cmd,
+			       struct mmc_sim_cursor *cur)
+{
+	struct mmc_data *data = cmd->data;
+	u64 ns = mmc_sim_us(read_lat_us);
+	u32 total = 0;
+	unsigned int i;
+	int err;
+
+	for (i = 0; i < host->packed_rd_num; i++)
+		total += host->packed_rd[i].blocks;
+
+	if (!host->packed_rd_num || total != data->blocks ||
+	    cmd->arg != host->packed_rd[0].addr) {
+		mmc_sim_packed_error(host, 0);
+		host->status |= R1_ERROR;
+		host->packed_rd_num = 0;
+		data->error = -EIO;
+		return ns;
+	}
+
+	for (i = 0; i < host->packed_rd_num; i++) {
+		err = mmc_sim_store_io(host, cur, host->packed_rd[i].addr,
+				       host->packed_rd[i].blocks, false);
+		if (err) {
+			mmc_sim_packed_error(host, i + 1);
+			data->error = err;
+			break;
+		}
+	}
+
+	host->packed_rd_num = 0;
+	host->stats.read_cmds++;
+	host->stats.read_bytes += cur->moved;
+	return ns + mmc_sim_xfer_ns(cur->moved, read_kbps);
+}
+
+static u64 mmc_sim_rw(struct mmc_sim_host *host, struct mmc_command *cmd)
+{
+	struct mmc_data *data = cmd->data;
+	bool write = data->flags & MMC_DATA_WRITE;
+	bool packed = host->packed && mmc_op_multi(cmd->opcode);
+	struct mmc_sim_cursor cur;
+	u64 bytes, ns = 0;
+	u32 blocks;
+	int err;
+
+	if (data->blksz != MMC_SIM_SECTOR_SIZE) {
+		data->error = -EINVAL;
+		return 0;
+	}
+
+	blocks = data->blocks;
+	if (mmc_op_multi(cmd->opcode) && host->blocks && !packed)
+		blocks = min(blocks, host->blocks);
+
+	mmc_sim_cursor_start(&cur, data);
+
+	if (packed && write) {
+		ns = mmc_sim_packed_write(host, cmd, &cur);
+		goto out;
+	}
+	if (packed) {
+		ns = mmc_sim_packed_read(host, cmd, &cur);
+		goto out;
+	}
+
+	bytes = (u64)blocks * MMC_SIM_SECTOR_SIZE;
+	err = mmc_sim_store_io(host, &cur, cmd->arg, blocks, write);
+	if (err == -ERANGE) {
+		cmd->resp[0] |= R1_OUT_OF_RANGE;
+		data->error = -EIO;
+		goto out;
+	} else if (err) {
+		data->error = err;
+		goto out;
+	}
+
+	if (write) {
+		ns = (host->rel_wr || !host->ext_csd[EXT_CSD_CACHE_CTRL] ||
+		      !cache_kb) ? mmc_sim_us(write_lat_us) : 0;
+		ns += mmc_sim_write_cost(host, bytes, host->rel_wr);
+		host->stats.write_cmds++;
+		host->stats.write_bytes += bytes;
+		if (host->rel_wr)
+			host->stats.rel_writes++;
+	} else {
+		ns = mmc_sim_us(read_lat_us) + mmc_sim_xfer_ns(bytes, read_kbps);
+		host->stats.read_cmds++;
+		host->stats.read_bytes += bytes;
+	}
+
+out:
+	data->bytes_xfered = data->error ? 0 : cur.moved;
+	mmc_sim_cursor_stop(&cur);
+	host->blocks = 0;
+	host->rel_wr = false;
+	host->packed = false;
+	return ns;
+}
+
+static u64 mmc_sim_send_ext_csd(struct mmc_sim_host *host,
+				struct mmc_command *cmd)
+{
+	struct mmc_data *data = cmd->data;
+	struct mmc_sim_cursor cur;
+
+	mmc_sim_cursor_start(&cur, data);
+	mmc_sim_sg_copy(&cur, host->ext_csd, sizeof(host->ext_csd), true);
+	data->bytes_xfered = cur.moved;
+	mmc_sim_cursor_stop(&cur);
+
+	/* Packed failure status is cleared once it has been reported */
+	host->ext_csd[EXT_CSD_EXP_EVENTS_STATUS] &= ~EXT_CSD_PACKED_FAILURE;
+
+	return mmc_sim_xfer_ns(sizeof(host->ext_csd), read_kbps);
+}
+
+static bool mmc_sim_ext_csd_writable(u8 index)
+{
+	switch (index) {
+	case EXT_CSD_FLUSH_CACHE:
+	case EXT_CSD_CACHE_CTRL:
+	case EXT_CSD_POWER_OFF_NOTIFICATION:
+	case EXT_CSD_EXP_EVENTS_CTRL:
+	case EXT_CSD_EXP_EVENTS_CTRL + 1:
+	case EXT_CSD_HPI_MGMT:
+	case EXT_CSD_BKOPS_EN:
+	case EXT_CSD_BKOPS_START:
+	case EXT_CSD_SANITIZE_START:
+	case EXT_CSD_ERASE_GROUP_DEF:
+	case EXT_CSD_PART_CONFIG:
+	case EXT_CSD_BUS_WIDTH:
+	case EXT_CSD_HS_TIMING:
+	case EXT_CSD_POWER_CLASS:
+		return true;
+	}
+	return false;
+}
+
+static u64 mmc_sim_switch(struct mmc_sim_host *host, struct mmc_command *cmd)
+{
+	u8 mode = (cmd->arg >> 24) & 0x3;
+	u8 index = (cmd->arg >> 16) & 0xff;
+	u8 value = (cmd->arg >> 8) & 0xff;
+	u8 *reg = &host->ext_csd[index];
+	u64 ns = 0;
+
+	if (mode == MMC_SWITCH_MODE_CMD_SET)
+		return 0;
+
+	if (!mmc_sim_ext_csd_writable(index)) {
+		host->status |= R1_SWITCH_ERROR;
+		host->stats.switch_errors++;
+		return 0;
+	}
+
+	switch (mode) {
+	case MMC_SWITCH_MODE_SET_BITS:
+		value = *reg | value;
+		break;
+	case MMC_SWITCH_MODE_CLEAR_BITS:
+		value = *reg & ~value;
+		break;
+	}
+
+	switch (index) {
+	case EXT_CSD_FLUSH_CACHE:
+		if (value & 1)
+			ns = mmc_sim_flush(host);
+		return ns;
+	case EXT_CSD_CACHE_CTRL:
+		if (!cache_kb) {
+			host->status |= R1_SWITCH_ERROR;
+			return 0;
+		}
+		if (!(value & 1) && host->cache_dirty)
+			ns = mmc_sim_flush(host);
+		break;
+	case EXT_CSD_SANITIZE_START:
+		if (value & 1) {
+			ns = mmc_sim_us(erase_lat_us) +
+				mmc_sim_xfer_ns(host->discarded, write_kbps);
+			host->discarded = 0;
+			host->stats.sanitizes++;
+		}
+		return ns;
+	case EXT_CSD_BKOPS_START:
+		return 0;
+	}
+
+	*reg = value;
+	return ns;
+}
+
+static u64 mmc_sim_erase(struct mmc_sim_host *host, struct mmc_command *cmd)
+{
+	u32 from = host->erase_start, to = host->erase_end;
+
+	if (from > to || to >= host->sectors) {
+		host->status |= R1_ERASE_PARAM;
+		return 0;
+	}
+
+	if (cmd->arg == MMC_DISCARD_ARG) {
+		host->discarded += ((u64)to - from + 1) * MMC_SIM_SECTOR_SIZE;
+		host->stats.discards++;
+	} else if (cmd->arg & MMC_TRIM_ARGS) {
+		host->stats.trims++;
+	} else {
+		host->stats.erases++;
+	}
+
+	mmc_sim_store_erase(host, from, to);
+	return mmc_sim_us(erase_lat_us);
+}
+
+static u32 mmc_sim_r1(struct mmc_sim_host *host)
+{
+	u32 r1 = host->status | (host->state << 9);
+
+	if (host->state == R1_STATE_TRAN)
+		r1 |= R1_READY_FOR_DATA;
+	if (host->ext_csd[EXT_CSD_EXP_EVENTS_STATUS] &
+	    host->ext_csd[EXT_CSD_EXP_EVENTS_CTRL])
+		r1 |= R1_EXCEPTION_EVENT;
+
+	host->status = 0;
+	return r1;
+}
+
+/*
+ * Execute one command against the card and return its modelled cost in
+ * nanoseconds.  Commands an eMMC device does not answer (SD and SDIO
+ * probing) time out like they do on a real bus.
+ */
+static u64 mmc_sim_do_cmd(struct mmc_sim_host *host, struct mmc_command *cmd)
+{
+	u64 ns = mmc_sim_us(cmd_lat_us);
+	bool addressed = (cmd->arg >> 16) == host->rca;
+
+	host->stats.cmds[cmd->opcode & 63]++;
+	cmd->error = 0;
+	memset(cmd->resp, 0, sizeof(cmd->resp));
+
+	switch (cmd->opcode) {
+	case MMC_GO_IDLE_STATE:
+		host->state = R1_STATE_IDLE;
+		host->rca = MMC_SIM_RCA_NONE;
+		return ns;
+
+	case MMC_SEND_OP_COND:
+		if (host->state != R1_STATE_IDLE &&
+		    host->state != R1_STATE_READY)
+			goto timeout;
+		cmd->resp[0] = MMC_SIM_OCR | MMC_CARD_BUSY;
+		if (cmd->arg & MMC_SIM_OCR & ~MMC_CARD_SECTOR_ADDR)
+			host->state = R1_STATE_READY;
+		return ns;
+
+	case MMC_ALL_SEND_CID:
+		if (host->state != R1_STATE_READY)
+			goto timeout;
+		memcpy(cmd->resp, host->cid, sizeof(host->cid));
+		host->state = R1_STATE_IDENT;
+		return ns;
+
+	case MMC_SET_RELATIVE_ADDR:
+		host->rca = cmd->arg >> 16;
+		host->state = R1_STATE_STBY;
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns;
+
+	case MMC_SEND_CSD:
+	case MMC_SEND_CID:
+		if (!addressed)
+			goto timeout;
+		if (cmd->opcode == MMC_SEND_CSD)
+			memcpy(cmd->resp, host->csd, sizeof(host->csd));
+		else
+			memcpy(cmd->resp, host->cid, sizeof(host->cid));
+		return ns;
+
+	case MMC_SELECT_CARD:
+		if (addressed && host->rca != MMC_SIM_RCA_NONE) {
+			cmd->resp[0] = mmc_sim_r1(host);
+			host->state = R1_STATE_TRAN;
+		} else if (host->state == R1_STATE_TRAN) {
+			host->state = R1_STATE_STBY;
+		}
+		return ns;
+
+	case MMC_SEND_STATUS:
+		if (!addressed)
+			goto timeout;
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns;
+
+	case MMC_SEND_EXT_CSD:
+		/* Without data this is SD_SEND_IF_COND, which we ignore */
+		if (!cmd->data || host->state != R1_STATE_TRAN)
+			goto timeout;
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns + mmc_sim_send_ext_csd(host, cmd);
+
+	case MMC_SWITCH:
+		if (host->state != R1_STATE_TRAN)
+			goto timeout;
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns + mmc_sim_switch(host, cmd);
+
+	case MMC_STOP_TRANSMISSION:
+		host->blocks = 0;
+		host->packed = false;
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns;
+
+	case MMC_SET_BLOCKLEN:
+		if (cmd->arg != MMC_SIM_SECTOR_SIZE)
+			host->status |= R1_BLOCK_LEN_ERROR;
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns;
+
+	case MMC_SET_BLOCK_COUNT:
+		host->blocks = cmd->arg & 0xffff;
+		host->rel_wr = !!(cmd->arg & MMC_CMD23_ARG_REL_WR);
+		host->packed = !!(cmd->arg & MMC_CMD23_ARG_PACKED);
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns;
+
+	case MMC_READ_SINGLE_BLOCK:
+	case MMC_READ_MULTIPLE_BLOCK:
+	case MMC_WRITE_BLOCK:
+	case MMC_WRITE_MULTIPLE_BLOCK:
+		if (host->state != R1_STATE_TRAN || !cmd->data)
+			goto timeout;
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns + mmc_sim_rw(host, cmd);
+
+	case MMC_ERASE_GROUP_START:
+		host->erase_start = cmd->arg;
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns;
+
+	case MMC_ERASE_GROUP_END:
+		host->erase_end = cmd->arg;
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns;
+
+	case MMC_ERASE:
+		cmd->resp[0] = mmc_sim_r1(host);
+		return ns + mmc_sim_erase(host, cmd);
+	}
+
+timeout:
+	cmd->error = -ETIMEDOUT;
+	return ns;
+}
+
+static enum hrtimer_restart mmc_sim_timer(struct hrtimer *timer)
+{
+	struct mmc_sim_host *host = container_of(timer, struct mmc_sim_host,
+						 timer);
+	struct mmc_request *mrq;
+	unsigned long flags;
+
+	spin_lock_irqsave(&host->lock, flags);
+	mrq = host->mrq;
+	host->mrq = NULL;
+	spin_unlock_irqrestore(&host->lock, flags);
+
+	if (mrq)
+		mmc_request_done(host->mmc, mrq);
+
+	return HRTIMER_NORESTART;
+}
+
+static void mmc_sim_work(struct work_struct *work)
+{
+	struct mmc_sim_host *host = container_of(work, struct mmc_sim_host,
+						 work);
+	struct mmc_request *mrq = host->mrq;
+	s64 elapsed;
+	u64 ns = 0;
+
+	if (mrq->sbc) {
+		ns += mmc_sim_do_cmd(host, mrq->sbc);
+		if (mrq->sbc->error)
+			goto done;
+	}
+
+	ns += mmc_sim_do_cmd(host, mrq->cmd);
+
+	/* With a predefined block count, CMD12 is only needed on errors */
+	if (mrq->data && mrq->stop &&
+	    (!mrq->sbc || mrq->cmd->error || mrq->data->error))
+		ns += mmc_sim_do_cmd(host, mrq->stop);
+
+	if (mrq->data && mrq->cmd->error)
+		mrq->data->error = mrq->cmd->error;
+
+done:
+	host->stats.busy_ns += ns;
+	elapsed = ktime_to_ns(ktime_sub(ktime_get(), host->mrq_start));
+	if (elapsed < (s64)ns) {
+		hrtimer_start(&host->timer, ns_to_ktime(ns - elapsed),
+			      HRTIMER_MODE_REL);
+		return;
+	}
+
+	mmc_sim_timer(&host->timer);
+}
+
+static void mmc_sim_request(struct mmc_host *mmc, struct mmc_request *mrq)
+{
+	struct mmc_sim_host *host = mmc_priv(mmc);
+	unsigned long flags;
+
+	spin_lock_irqsave(&host->lock, flags);
+	WARN_ON(host->mrq);
+	host->mrq = mrq;
+	host->mrq_start = ktime_get();
+	spin_unlock_irqrestore(&host->lock, flags);
+
+	/* Data is copied by the CPU */
+	if (mrq->data)
+		mmc_host_count_xfer(mmc, false);
+
+	queue_work(mmc_sim_wq, &host->work);
+}
+
+static void mmc_sim_set_ios(struct mmc_host *mmc, struct mmc_ios *ios)
+{
+	struct mmc_sim_host *host = mmc_priv(mmc);
+
+	if (ios->power_mode == MMC_POWER_OFF) {
+		/* Volatile state is lost, data in the cache included */
+		host->state = R1_STATE_IDLE;
+		host->rca = MMC_SIM_RCA_NONE;
+		host->cache_dirty = 0;
+		host->ext_csd[EXT_CSD_CACHE_CTRL] = 0;
+		host->ext_csd[EXT_CSD_HS_TIMING] = 0;
+		host->ext_csd[EXT_CSD_BUS_WIDTH] = 0;
+		host->ext_csd[EXT_CSD_EXP_EVENTS_CTRL] = 0;
+		host->ext_csd[EXT_CSD_ERASE_GROUP_DEF] = 0;
+		host->ext_csd[EXT_CSD_HPI_MGMT] = 0;
+	}
+}
+
+static int mmc_sim_get_ro(struct mmc_host *mmc)
+{
+	return 0;
+}
+
+static int mmc_sim_get_cd(struct mmc_host *mmc)
+{
+	return 1;
+}
+
+static const struct mmc_host_ops mmc_sim_ops = {
+	.request	= mmc_sim_request,
+	.set_ios	= mmc_sim_set_ios,
+	.get_ro		= mmc_sim_get_ro,
+	.get_cd		= mmc_sim_get_cd,
+};
+
+static void mmc_sim_init_card(struct mmc_sim_host *host, int id)
+{
+	u8 *ext_csd = host->ext_csd;
+	u32 *csd = host->csd;
+	u32 *cid = host->cid;
+	u32 cache = cache_kb;
+
+	host->state = R1_STATE_IDLE;
+
+	/* CID: manfid 0, "SIMMC" product name, serial = id */
+	mmc_sim_stuff_bits(cid, 120, 8, 0x00);
+	mmc_sim_stuff_bits(cid, 104, 16, 0x0100);
+	mmc_sim_stuff_bits(cid, 96, 8, 'S');
+	mmc_sim_stuff_bits(cid, 88, 8, 'I');
+	mmc_sim_stuff_bits(cid, 80, 8, 'M');
+	mmc_sim_stuff_bits(cid, 72, 8, 'M');
+	mmc_sim_stuff_bits(cid, 64, 8, 'C');
+	mmc_sim_stuff_bits(cid, 56, 8, '0' + id % 10);
+	mmc_sim_stuff_bits(cid, 48, 8, 0x10);
+	mmc_sim_stuff_bits(cid, 16, 32, id);
+	mmc_sim_stuff_bits(cid, 8, 8, 0x1c);
+
+	/*
+	 * CSD v1.2 with capacity in EXT_CSD: 52MHz, 512 byte blocks,
+	 * 4096 * 512 "magic" legacy capacity.
+	 */
+	mmc_sim_stuff_bits(csd, 126, 2, CSD_STRUCT_EXT_CSD);
+	mmc_sim_stuff_bits(csd, 122, 4, CSD_SPEC_VER_4);
+	mmc_sim_stuff_bits(csd, 112, 7, 0x27);		/* TAAC 1.5 ms */
+	mmc_sim_stuff_bits(csd, 104, 8, 1);		/* NSAC */
+	mmc_sim_stuff_bits(csd, 96, 7, 0x32);		/* TRAN_SPEED 26MHz */
+	mmc_sim_stuff_bits(csd, 84, 12, CCC_BASIC | CCC_BLOCK_READ |
+			   CCC_BLOCK_WRITE | CCC_ERASE | CCC_SWITCH);
+	mmc_sim_stuff_bits(csd, 80, 4, 9);		/* READ_BL_LEN */
+	mmc_sim_stuff_bits(csd, 62, 12, 0xfff);		/* C_SIZE */
+	mmc_sim_stuff_bits(csd, 47, 3, 7);		/* C_SIZE_MULT */
+	mmc_sim_stuff_bits(csd, 42, 5, 31);		/* ERASE_GRP_SIZE */
+	mmc_sim_stuff_bits(csd, 37, 5, 31);		/* ERASE_GRP_MULT */
+	mmc_sim_stuff_bits(csd, 26, 3, 2);		/* R2W_FACTOR */
+	mmc_sim_stuff_bits(csd, 22, 4, 9);		/* WRITE_BL_LEN */
+
+	memset(ext_csd, 0, sizeof(host->ext_csd));
+	ext_csd[EXT_CSD_REV] = 6;			/* eMMC 4.5 */
+	ext_csd[EXT_CSD_STRUCTURE] = 2;
+	ext_csd[EXT_CSD_CARD_TYPE] = EXT_CSD_CARD_TYPE_26 |
+		EXT_CSD_CARD_TYPE_52 | EXT_CSD_CARD_TYPE_DDR_1_8V;
+	ext_csd[EXT_CSD_SEC_CNT + 0] = host->sectors >> 0;
+	ext_csd[EXT_CSD_SEC_CNT + 1] = host->sectors >> 8;
+	ext_csd[EXT_CSD_SEC_CNT + 2] = host->sectors >> 16;
+	ext_csd[EXT_CSD_SEC_CNT + 3] = host->sectors >> 24;
+	ext_csd[EXT_CSD_S_A_TIMEOUT] = 0x10;
+	ext_csd[EXT_CSD_HC_WP_GRP_SIZE] = 1;
+	ext_csd[EXT_CSD_REL_WR_SEC_C] = 1;
+	ext_csd[EXT_CSD_ERASE_TIMEOUT_MULT] = 1;
+	ext_csd[EXT_CSD_HC_ERASE_GRP_SIZE] = 1;		/* 512KiB */
+	ext_csd[EXT_CSD_SEC_TRIM_MULT] = 1;
+	ext_csd[EXT_CSD_SEC_ERASE_MULT] = 1;
+	ext_csd[EXT_CSD_SEC_FEATURE_SUPPORT] = EXT_CSD_SEC_ER_EN |
+		EXT_CSD_SEC_GB_CL_EN | EXT_CSD_SEC_SANITIZE;
+	ext_csd[EXT_CSD_TRIM_MULT] = 1;
+	ext_csd[EXT_CSD_WR_REL_PARAM] = EXT_CSD_WR_REL_PARAM_EN;
+	ext_csd[EXT_CSD_PART_SWITCH_TIME] = 1;
+	ext_csd[EXT_CSD_OUT_OF_INTERRUPT_TIME] = 1;
+	ext_csd[EXT_CSD_GENERIC_CMD6_TIME] = 1;
+	ext_csd[EXT_CSD_POWER_OFF_LONG_TIME] = 10;
+	ext_csd[EXT_CSD_CACHE_SIZE + 0] = cache >> 0;
+	ext_csd[EXT_CSD_CACHE_SIZE + 1] = cache >> 8;
+	ext_csd[EXT_CSD_CACHE_SIZE + 2] = cache >> 16;
+	ext_csd[EXT_CSD_CACHE_SIZE + 3] = cache >> 24;
+	ext_csd[EXT_CSD_MAX_PACKED_WRITES] = min(max_packed_wr,
+						 (unsigned)MMC_SIM_MAX_PACKED);
+	ext_csd[EXT_CSD_MAX_PACKED_READS] = min(max_packed_rd,
+						(unsigned)MMC_SIM_MAX_PACKED);
+}
+
+static int mmc_sim_stats_show(struct seq_file *s, void *data)
+{
+	struct mmc_sim_host *host = s->private;
+	struct mmc_sim_stats *st = &host->stats;
+	int i;
+
+	seq_printf(s, "read_cmds: %llu\nread_bytes: %llu\n",
+		   st->read_cmds, st->read_bytes);
+	seq_printf(s, "write_cmds: %llu\nwrite_bytes: %llu\n",
+		   st->write_cmds, st->write_bytes);
+	seq_printf(s, "rel_writes: %llu\n", st->rel_writes);
+	seq_printf(s, "packed_wr: %llu\npacked_wr_entries: %llu\n",
+		   st->packed_wr, st->packed_wr_entries);
+	seq_printf(s, "packed_rd: %llu\npacked_rd_entries: %llu\n",
+		   st->packed_rd, st->packed_rd_entries);
+	seq_printf(s, "packed_errors: %llu\n", st->packed_errors);
+	seq_printf(s, "flushes: %llu\nflushed_bytes: %llu\n",
+		   st->flushes, st->flushed_bytes);
+	seq_printf(s, "cache_dirty_bytes: %llu\n", host->cache_dirty);
+	seq_printf(s, "cache_overflow_bytes: %llu\n", st->cache_overflow_bytes);
+	seq_printf(s, "erases: %llu\ntrims: %llu\ndiscards: %llu\n",
+		   st->erases, st->trims, st->discards);
+	seq_printf(s, "sanitizes: %llu\n", st->sanitizes);
+	seq_printf(s, "switch_errors: %llu\n", st->switch_errors);
+	seq_printf(s, "busy_ns: %llu\n", st->busy_ns);
+	for (i = 0; i < ARRAY_SIZE(st->cmds); i++)
+		if (st->cmds[i])
+			seq_printf(s, "cmd%d: %llu\n", i, st->cmds[i]);
+
+	return 0;
+}
+
+static int mmc_sim_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, mmc_sim_stats_show, inode->i_private);
+}
+
+static ssize_t mmc_sim_stats_write(struct file *file, const char __user *buf,
+				   size_t count, loff_t *ppos)
+{
+	struct seq_file *s = file->private_data;
+	struct mmc_sim_host *host = s->private;
+
+	/* Any write resets the counters */
+	memset(&host->stats, 0, sizeof(host->stats));
+
+	return count;
+}
+
+static const struct file_operations mmc_sim_stats_fops = {
+	.open		= mmc_sim_stats_open,
+	.read		= seq_read,
+	.write		= mmc_sim_stats_write,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static void mmc_sim_debugfs_init(struct mmc_sim_host *host)
+{
+	struct dentry *root = host->mmc->debugfs_root;
+
+	if (!root)
+		return;
+
+	host->debugfs_stats = debugfs_create_file("sim_stats",
+			S_IRUSR | S_IWUSR, root, host, &mmc_sim_stats_fops);
+	host->debugfs_fail = debugfs_create_u32("sim_fail_packed_idx",
+			S_IRUSR | S_IWUSR, root, &host->fail_packed_idx);
+}
+
+static void mmc_sim_debugfs_exit(struct mmc_sim_host *host)
+{
+	debugfs_remove(host->debugfs_fail);
+	debugfs_remove(host->debugfs_stats);
+}
+
+static int __devinit mmc_sim_probe(struct platform_device *pdev)
+{
+	struct mmc_host *mmc;
+	struct mmc_sim_host *host;
+	u64 bytes = (u64)capacity_mb << 20;
+	int ret;
+
+	if (!capacity_mb || bytes >> 9 > UINT_MAX)
+		return -EINVAL;
+
+	mmc = mmc_alloc_host(sizeof(struct mmc_sim_host), &pdev->dev);
+	if (!mmc)
+		return -ENOMEM;
+
+	host = mmc_priv(mmc);
+	host->mmc = mmc;
+	spin_lock_init(&host->lock);
+	INIT_WORK(&host->work, mmc_sim_work);
+	hrtimer_init(&host->timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	host->timer.function = mmc_sim_timer;
+
+	host->sectors = bytes >> 9;
+	host->nr_pages = DIV_ROUND_UP(bytes, PAGE_SIZE);
+	host->pages = vzalloc(host->nr_pages * sizeof(*host->pages));
+	if (!host->pages) {
+		ret = -ENOMEM;
+		goto free_host;
+	}
+	mmc_sim_init_card(host, pdev->id);
+
+	mmc->ops = &mmc_sim_ops;
+	mmc->f_min = 400000;
+	mmc->f_max = 52000000;
+	mmc->ocr_avail = MMC_SIM_OCR & ~MMC_CARD_SECTOR_ADDR;
+	mmc->caps = MMC_CAP_4_BIT_DATA | MMC_CAP_8_BIT_DATA |
+		MMC_CAP_MMC_HIGHSPEED | MMC_CAP_NONREMOVABLE |
+		MMC_CAP_WAIT_WHILE_BUSY | MMC_CAP_ERASE | MMC_CAP_CMD23;
+	mmc->caps2 = MMC_CAP2_CACHE_CTRL | MMC_CAP2_PACKED_CMD |
+		MMC_CAP2_PACKED_WR_CONTROL | MMC_CAP2_SANITIZE |
+		MMC_CAP2_HC_ERASE_SZ;
+
+	mmc->max_segs = 128;
+	mmc->max_blk_size = MMC_SIM_SECTOR_SIZE;
+	mmc->max_blk_count = 0xffff;
+	mmc->max_req_size = 4 * 1024 * 1024;
+	mmc->max_seg_size = mmc->max_req_size;
+	mmc->max_discard_to = 0;
+
+	platform_set_drvdata(pdev, mmc);
+
+	ret = mmc_add_host(mmc);
+	if (ret)
+		goto free_store;
+
+	mmc_sim_debugfs_init(host);
+
+	pr_info("%s: emulated eMMC 4.5, %u MiB, cache %u KiB, packed %u/%u\n",
+		mmc_hostname(mmc), capacity_mb, cache_kb,
+		host->ext_csd[EXT_CSD_MAX_PACKED_WRITES],
+		host->ext_csd[EXT_CSD_MAX_PACKED_READS]);
+	return 0;
+
+free_store:
+	platform_set_drvdata(pdev, NULL);
+	mmc_sim_store_free(host);
+free_host:
+	mmc_free_host(mmc);
+	return ret;
+}
+
+static int __devexit mmc_sim_remove(struct platform_device *pdev)
+{
+	struct mmc_host *mmc = platform_get_drvdata(pdev);
+	struct mmc_sim_host *host = mmc_priv(mmc);
+
+	mmc_sim_debugfs_exit(host);
+	mmc_remove_host(mmc);
+	flush_workqueue(mmc_sim_wq);
+	hrtimer_cancel(&host->timer);
+	mmc_sim_store_free(host);
+	platform_set_drvdata(pdev, NULL);
+	mmc_free_host(mmc);
+
+	return 0;
+}
+
+static struct platform_driver mmc_sim_driver = {
+	.probe		= mmc_sim_probe,
+	.remove		= __devexit_p(mmc_sim_remove),
+	.driver		= {
+		.name	= DRIVER_NAME,
+		.owner	= THIS_MODULE,
+	},
+};
+
+static void mmc_sim_unregister_devices(void)
+{
+	int i;
+
+	for (i = 0; i < nr_hosts; i++)
+		if (!IS_ERR_OR_NULL(mmc_sim_pdevs[i]))
+			platform_device_unregister(mmc_sim_pdevs[i]);
+	kfree(mmc_sim_pdevs);
+}
+
+static int __init mmc_sim_init(void)
+{
+	int i, ret;
+
+	if (!nr_hosts)
+		return -EINVAL;
+
+	mmc_sim_wq = alloc_workqueue(DRIVER_NAME, WQ_MEM_RECLAIM, 0);
+	if (!mmc_sim_wq)
+		return -ENOMEM;
+
+	ret = platform_driver_register(&mmc_sim_driver);
+	if (ret)
+		goto destroy_wq;
+
+	mmc_sim_pdevs = kcalloc(nr_hosts, sizeof(*mmc_sim_pdevs), GFP_KERNEL);
+	if (!mmc_sim_pdevs) {
+		ret = -ENOMEM;
+		goto unregister_driver;
+	}
+
+	for (i = 0; i < nr_hosts; i++) {
+		mmc_sim_pdevs[i] = platform_device_register_simple(DRIVER_NAME,
+								   i, NULL, 0);
+		if (IS_ERR(mmc_sim_pdevs[i])) {
+			ret = PTR_ERR(mmc_sim_pdevs[i]);
+			goto unregister_devices;
+		}
+	}
+
+	return 0;
+
+unregister_devices:
+	mmc_sim_unregister_devices();
+unregister_driver:
+	platform_driver_unregister(&mmc_sim_driver);
+destroy_wq:
+	destroy_workqueue(mmc_sim_wq);
+	return ret;
+}
+
+static void __exit mmc_sim_exit(void)
+{
+	mmc_sim_unregister_devices();
+	platform_driver_unregister(&mmc_sim_driver);
+	destroy_workqueue(mmc_sim_wq);
+}
+
+module_init(mmc_sim_init);
+module_exit(mmc_sim_exit);
+
+MODULE_DESCRIPTION("Software-emulated eMMC 4.5 host controller");
+MODULE_LICENSE("GPL v2");
@@ -1250,6 +1250,8 @@ msmsdcc_start_data(struct msmsdcc_host *host, struct mmc_data *data,
 		msmsdcc_sg_start(host);
 	}
 
+	mmc_host_count_xfer(host->mmc, datactrl & MCI_DPSM_DMAENABLE);
+
 	if (data->flags & MMC_DATA_READ)
 		datactrl |= (MCI_DPSM_DIRECTION | MCI_RX_DATA_PEND);
 	else if (host->curr.use_wr_data_pend)
@@ -29,6 +29,7 @@
 #include <linux/skbuff.h>
 #include <linux/wakelock.h>
 #include <linux/platform_device.h>
+#include <linux/timer.h>
 #include <linux/if_arp.h>
 #include <linux/msm_rmnet.h>
 
@@ -104,6 +105,11 @@ int rmnet_get_max_mtu(void)
 
 #define HEADROOM_FOR_QOS    8
 
+/* NAPI poll weight */
+#define RMNET_NAPI_WEIGHT	64
+/* poll again this long after an skb allocation failure */
+#define RMNET_RX_RETRY_MS	10
+
 static struct completion *port_complete[RMNET_DEVICE_COUNT];
 
 struct rmnet_private
@@ -121,7 +127,8 @@ struct rmnet_private
 	struct sk_buff *skb;
 	spinlock_t lock;
 	struct tasklet_struct tsklt;
-	struct tasklet_struct rx_tasklet;
+	struct napi_struct napi;
+	struct timer_list rx_retry;
 	u32 operation_mode;    /* IOCTL specified mode (protocol, QoS header) */
 	struct platform_driver pdrv;
 	struct completion complete;
@@ -284,79 +291,105 @@ static __be16 rmnet_ip_type_trans(struct sk_buff *skb, struct net_device *dev)
 	return protocol;
 }
 
-static void smd_net_data_handler(unsigned long arg);
+static inline int rmnet_rx_pending(struct rmnet_private *p)
+{
+	int sz = smd_cur_packet_size(p->ch);
 
-/* Called in soft-irq context */
-static void smd_net_data_handler(unsigned long arg)
+	return sz && smd_read_avail(p->ch) >= sz;
+}
+
+/*
+ * Data already in the FIFO raises no further SMD event, so after running
+ * out of memory the poll is restarted from here.
+ */
+static void rmnet_rx_retry(unsigned long data)
 {
-	struct net_device *dev = (struct net_device *) arg;
-	struct rmnet_private *p = netdev_priv(dev);
+	struct rmnet_private *p = (struct rmnet_private *)data;
+
+	napi_schedule(&p->napi);
+}
+
+/* NAPI poll, called in soft-irq context */
+static int rmnet_poll(struct napi_struct *napi, int budget)
+{
+	struct rmnet_private *p = container_of(napi, struct rmnet_private,
+					       napi);
+	struct net_device *dev = napi->dev;
 	struct sk_buff *skb;
 	void *ptr = 0;
 	int sz;
 	u32 opmode = p->operation_mode;
 	unsigned long flags;
+	int work_done = 0;
 
-	for (;;) {
+	while (work_done < budget) {
 		sz = smd_cur_packet_size(p->ch);
-		if (sz == 0) break;
-		if (smd_read_avail(p->ch) < sz) break;
+		if (sz == 0)
+			break;
+		if (smd_read_avail(p->ch) < sz)
+			break;
 
 		skb = dev_alloc_skb(sz + NET_IP_ALIGN);
 		if (skb == NULL) {
-			pr_err("[%s] rmnet_recv() cannot allocate skb\n",
-			       dev->name);
-			/* out of memory, reschedule a later attempt */
-			p->rx_tasklet.data = (unsigned long)dev;
-			tasklet_schedule(&p->rx_tasklet);
-			break;
+			pr_err_ratelimited(
+				"[%s] rmnet_recv() cannot allocate skb\n",
+				dev->name);
+			/* out of memory, give the allocator a moment */
+			napi_complete(napi);
+			mod_timer(&p->rx_retry, jiffies +
+				  msecs_to_jiffies(RMNET_RX_RETRY_MS));
+			return work_done;
+		}
+
+		skb->dev = dev;
+		skb_reserve(skb, NET_IP_ALIGN);
+		ptr = skb_put(skb, sz);
+		wake_lock_timeout(&p->wake_lock, HZ / 2);
+		if (smd_read(p->ch, ptr, sz) != sz) {
+			pr_err("[%s] rmnet_recv() smd lied about avail?!",
+				dev->name);
+			ptr = 0;
+			dev_kfree_skb_irq(skb);
+			continue;
+		}
+
+		/* Handle Rx frame format */
+		spin_lock_irqsave(&p->lock, flags);
+		opmode = p->operation_mode;
+		spin_unlock_irqrestore(&p->lock, flags);
+
+		if (RMNET_IS_MODE_IP(opmode)) {
+			/* Driver in IP mode */
+			skb->protocol = rmnet_ip_type_trans(skb, dev);
+			skb_reset_mac_header(skb);
 		} else {
-			skb->dev = dev;
-			skb_reserve(skb, NET_IP_ALIGN);
-			ptr = skb_put(skb, sz);
-			wake_lock_timeout(&p->wake_lock, HZ / 2);
-			if (smd_read(p->ch, ptr, sz) != sz) {
-				pr_err("[%s] rmnet_recv() smd lied about avail?!",
-					dev->name);
-				ptr = 0;
-				dev_kfree_skb_irq(skb);
-			} else {
-				/* Handle Rx frame format */
-				spin_lock_irqsave(&p->lock, flags);
-				opmode = p->operation_mode;
-				spin_unlock_irqrestore(&p->lock, flags);
-
-				if (RMNET_IS_MODE_IP(opmode)) {
-					/* Driver in IP mode */
-					skb->protocol =
-					  rmnet_ip_type_trans(skb, dev);
-				} else {
-					/* Driver in Ethernet mode */
-					skb->protocol =
-					  eth_type_trans(skb, dev);
-				}
-				if (RMNET_IS_MODE_IP(opmode) ||
-				    count_this_packet(ptr, skb->len)) {
+			/* Driver in Ethernet mode */
+			skb->protocol = eth_type_trans(skb, dev);
+		}
+		if (RMNET_IS_MODE_IP(opmode) ||
+		    count_this_packet(ptr, skb->len)) {
 #ifdef CONFIG_MSM_RMNET_DEBUG
-					p->wakeups_rcv +=
-					rmnet_cause_wakeup(p);
+			p->wakeups_rcv += rmnet_cause_wakeup(p);
 #endif
-					p->stats.rx_packets++;
-					p->stats.rx_bytes += skb->len;
-				}
-				DBG1("[%s] Rx packet #%lu len=%d\n",
-					dev->name, p->stats.rx_packets,
-					skb->len);
-
-				/* Deliver to network stack */
-				netif_rx(skb);
-			}
-			continue;
+			p->stats.rx_packets++;
+			p->stats.rx_bytes += skb->len;
 		}
-		if (smd_read(p->ch, ptr, sz) != sz)
-			pr_err("[%s] rmnet_recv() smd lied about avail?!",
-				dev->name);
+		DBG1("[%s] Rx packet #%lu len=%d\n",
+			dev->name, p->stats.rx_packets, skb->len);
+
+		/* Deliver to network stack through GRO */
+		napi_gro_receive(napi, skb);
+		work_done++;
+	}
+
+	if (work_done < budget) {
+		napi_complete(napi);
+		/* Catch data that arrived while the poll was completing */
+		if (rmnet_rx_pending(p))
+			napi_schedule(napi);
 	}
+
+	return work_done;
 }
 
 static int _rmnet_xmit(struct sk_buff *skb, struct net_device *dev)
@@ -475,10 +508,8 @@ static void smd_net_notify(void *_dev, unsigned event)
 		spin_unlock(&p->lock);
 
 		if (smd_read_avail(p->ch) &&
-			(smd_read_avail(p->ch) >= smd_cur_packet_size(p->ch))) {
-			p->rx_tasklet.data = (unsigned long) _dev;
-			tasklet_schedule(&p->rx_tasklet);
-		}
+			(smd_read_avail(p->ch) >= smd_cur_packet_size(p->ch)))
+			napi_schedule(&p->napi);
 		break;
 
 	case SMD_EVENT_OPEN:
@@ -815,8 +846,13 @@ static int __init rmnet_init(void)
 		spin_lock_init(&p->lock);
 		tasklet_init(&p->tsklt, _rmnet_resume_flow,
 				(unsigned long)dev);
-		tasklet_init(&p->rx_tasklet, smd_net_data_handler,
-				(unsigned long)dev);
+		/*
+		 * The poll stays enabled while the interface is down so that
+		 * the SMD channel keeps being drained, as it was before.
+		 */
+		netif_napi_add(dev, &p->napi, rmnet_poll, RMNET_NAPI_WEIGHT);
+		setup_timer(&p->rx_retry, rmnet_rx_retry, (unsigned long)p);
+		napi_enable(&p->napi);
 		wake_lock_init(&p->wake_lock, WAKE_LOCK_SUSPEND, ch_name[n]);
 #ifdef CONFIG_MSM_RMNET_DEBUG
 		p->timeout_us = timeout_us;
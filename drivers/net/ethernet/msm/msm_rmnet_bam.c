@@ -70,6 +70,10 @@ module_param_named(debug_enable, msm_rmnet_bam_debug_mask,
 #define HEADROOM_FOR_QOS    8
 #define TAILROOM            8 /* for padding by mux layer */
 
+/* NAPI poll weight and bound on packets waiting for the poll */
+#define RMNET_NAPI_WEIGHT	64
+#define RMNET_RX_QUEUE_MAX	1000
+
 struct rmnet_private {
 	struct net_device_stats stats;
 	uint32_t ch_id;
@@ -83,6 +87,8 @@ struct rmnet_private {
 	spinlock_t lock;
 	spinlock_t tx_queue_lock;
 	struct tasklet_struct tsklt;
+	struct napi_struct napi;
+	struct sk_buff_head rx_queue;
 	u32 operation_mode; /* IOCTL specified mode (protocol, QoS header) */
 	uint8_t device_up;
 	uint8_t in_reset;
@@ -279,13 +285,47 @@ static void bam_recv_notify(void *dev, struct sk_buff *skb)
 			((struct net_device *)dev)->name,
 			p->stats.rx_packets, skb->len);
 
-		/* Deliver to network stack */
-		netif_rx(skb);
+		/* Hand over to the NAPI poll, which feeds GRO */
+		if (skb_queue_len(&p->rx_queue) >= RMNET_RX_QUEUE_MAX) {
+			p->stats.rx_dropped++;
+			dev_kfree_skb_any(skb);
+			return;
+		}
+		skb_queue_tail(&p->rx_queue, skb);
+		napi_schedule(&p->napi);
 	} else
 		pr_err("[%s] %s: No skb received",
 			((struct net_device *)dev)->name, __func__);
 }
 
+/* NAPI poll, called in soft-irq context */
+static int rmnet_poll(struct napi_struct *napi, int budget)
+{
+	struct rmnet_private *p = container_of(napi, struct rmnet_private,
+					       napi);
+	struct sk_buff *skb;
+	int work_done = 0;
+
+	while (work_done < budget) {
+		skb = skb_dequeue(&p->rx_queue);
+		if (!skb)
+			break;
+		if (!skb_mac_header_was_set(skb))
+			skb_reset_mac_header(skb);
+		napi_gro_receive(napi, skb);
+		work_done++;
+	}
+
+	if (work_done < budget) {
+		napi_complete(napi);
+		/* Catch packets queued while the poll was completing */
+		if (!skb_queue_empty(&p->rx_queue))
+			napi_schedule(napi);
+	}
+
+	return work_done;
+}
+
 static int _rmnet_xmit(struct sk_buff *skb, struct net_device *dev)
 {
 	struct rmnet_private *p = netdev_priv(dev);
@@ -774,6 +814,13 @@ static int __init rmnet_init(void)
 		p->in_reset = 0;
 		spin_lock_init(&p->lock);
 		spin_lock_init(&p->tx_queue_lock);
+		skb_queue_head_init(&p->rx_queue);
+		/*
+		 * The poll stays enabled while the interface is down, as
+		 * the bam_dmux channel keeps delivering packets then too.
+		 */
+		netif_napi_add(dev, &p->napi, rmnet_poll, RMNET_NAPI_WEIGHT);
+		napi_enable(&p->napi);
 #ifdef CONFIG_MSM_RMNET_DEBUG
 		p->timeout_us = timeout_us;
 		p->wakeups_xmit = p->wakeups_rcv = 0;
@@ -29,11 +29,32 @@
 
 #define ADB_BULK_BUFFER_SIZE           4096
 
-/* number of tx requests to allocate */
-#define TX_REQ_MAX 4
+/* number of tx and rx requests to allocate */
+#define TX_REQ_DEFAULT 8
+#define RX_REQ_DEFAULT 4
+#define TX_REQ_MAX 32
+#define RX_REQ_MAX 16
 
 static const char adb_shortname[] = "android_adb";
 
+/*
+ * Size and number of bulk requests, picked up when the function is bound.
+ * An OUT request only completes when it is full or ends in a short packet,
+ * so adb_rx_req_len must not exceed the largest payload adbd negotiates
+ * unless the host terminates every transfer.
+ */
+static unsigned int adb_tx_req_len = 16384;
+module_param(adb_tx_req_len, uint, S_IRUGO | S_IWUSR);
+
+static unsigned int adb_rx_req_len = ADB_BULK_BUFFER_SIZE;
+module_param(adb_rx_req_len, uint, S_IRUGO | S_IWUSR);
+
+static unsigned int adb_tx_reqs = TX_REQ_DEFAULT;
+module_param(adb_tx_reqs, uint, S_IRUGO | S_IWUSR);
+
+static unsigned int adb_rx_reqs = RX_REQ_DEFAULT;
+module_param(adb_rx_reqs, uint, S_IRUGO | S_IWUSR);
+
 struct adb_dev {
 	struct usb_function function;
 	struct usb_composite_dev *cdev;
@@ -51,11 +72,18 @@ struct adb_dev {
 	struct delayed_work adb_release_w;
 
 	struct list_head tx_idle;
+	/* OUT requests not queued, and completed ones oldest first */
+	struct list_head rx_idle;
+	struct list_head rx_done;
+	/* bytes of the head of rx_done already returned to userspace */
+	unsigned rx_offset;
+
+	/* request geometry, fixed at bind time */
+	unsigned tx_req_len;
+	unsigned rx_req_len;
 
 	wait_queue_head_t read_wq;
 	wait_queue_head_t write_wq;
-	struct usb_request *rx_req;
-	int rx_done;
 };
 
 static struct usb_interface_descriptor adb_interface_desc = {
@@ -208,13 +236,50 @@ static void adb_complete_out(struct usb_ep *ep, struct usb_request *req)
 {
 	struct adb_dev *dev = _adb_dev;
 
-	dev->rx_done = 1;
 	if (req->status != 0 && req->status != -ECONNRESET)
 		atomic_set(&dev->error, 1);
 
+	/* zero-length packets are thrown back by the next refill */
+	if (req->status == 0 && req->actual)
+		adb_req_put(dev, &dev->rx_done, req);
+	else
+		adb_req_put(dev, &dev->rx_idle, req);
+
 	wake_up(&dev->read_wq);
 }
 
+/* keep every idle OUT request queued so the host is not held up by read() */
+static int adb_rx_refill(struct adb_dev *dev)
+{
+	struct usb_request *req;
+	int ret;
+
+	while ((req = adb_req_get(dev, &dev->rx_idle))) {
+		req->length = dev->rx_req_len;
+		ret = usb_ep_queue(dev->ep_out, req, GFP_ATOMIC);
+		if (ret < 0) {
+			pr_debug("adb_read: failed to queue req %p (%d)\n",
+				req, ret);
+			adb_req_put(dev, &dev->rx_idle, req);
+			return ret;
+		}
+		pr_debug("rx %p queue\n", req);
+	}
+
+	return 0;
+}
+
+/* drop data left over from a previous connection */
+static void adb_rx_flush(struct adb_dev *dev)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev->lock, flags);
+	list_splice_tail_init(&dev->rx_done, &dev->rx_idle);
+	dev->rx_offset = 0;
+	spin_unlock_irqrestore(&dev->lock, flags);
+}
+
 static int adb_create_bulk_endpoints(struct adb_dev *dev,
 				struct usb_endpoint_descriptor *in_desc,
 				struct usb_endpoint_descriptor *out_desc)
@@ -244,17 +309,39 @@ static int adb_create_bulk_endpoints(struct adb_dev *dev,
 	ep->driver_data = dev;		/* claim the endpoint */
 	dev->ep_out = ep;
 
+	dev->tx_req_len = max_t(unsigned, adb_tx_req_len,
+				ADB_BULK_BUFFER_SIZE);
+	dev->rx_req_len = max_t(unsigned, adb_rx_req_len,
+				ADB_BULK_BUFFER_SIZE);
+	dev->rx_offset = 0;
+
 	/* now allocate requests for our endpoints */
-	req = adb_request_new(dev->ep_out, ADB_BULK_BUFFER_SIZE);
-	if (!req)
-		goto fail;
-	req->complete = adb_complete_out;
-	dev->rx_req = req;
-
-	for (i = 0; i < TX_REQ_MAX; i++) {
-		req = adb_request_new(dev->ep_in, ADB_BULK_BUFFER_SIZE);
-		if (!req)
-			goto fail;
+retry_rx_alloc:
+	for (i = 0; i < clamp_t(int, adb_rx_reqs, 1, RX_REQ_MAX); i++) {
+		req = adb_request_new(dev->ep_out, dev->rx_req_len);
+		if (!req) {
+			if (dev->rx_req_len == ADB_BULK_BUFFER_SIZE)
+				goto fail;
+			while ((req = adb_req_get(dev, &dev->rx_idle)))
+				adb_request_free(req, dev->ep_out);
+			dev->rx_req_len = ADB_BULK_BUFFER_SIZE;
+			goto retry_rx_alloc;
+		}
+		req->complete = adb_complete_out;
+		adb_req_put(dev, &dev->rx_idle, req);
+	}
+
+retry_tx_alloc:
+	for (i = 0; i < clamp_t(int, adb_tx_reqs, 1, TX_REQ_MAX); i++) {
+		req = adb_request_new(dev->ep_in, dev->tx_req_len);
+		if (!req) {
+			if (dev->tx_req_len == ADB_BULK_BUFFER_SIZE)
+				goto fail;
+			while ((req = adb_req_get(dev, &dev->tx_idle)))
+				adb_request_free(req, dev->ep_in);
+			dev->tx_req_len = ADB_BULK_BUFFER_SIZE;
+			goto retry_tx_alloc;
+		}
 		req->complete = adb_complete_in;
 		adb_req_put(dev, &dev->tx_idle, req);
 	}
@@ -278,9 +365,6 @@ static ssize_t adb_read(struct file *fp, char __user *buf,
 	if (!_adb_dev)
 		return -ENODEV;
 
-	if (count > ADB_BULK_BUFFER_SIZE)
-		return -EINVAL;
-
 	if (adb_lock(&dev->read_excl))
 		return -EBUSY;
 
@@ -300,43 +384,56 @@ static ssize_t adb_read(struct file *fp, char __user *buf,
 		goto done;
 	}
 
-requeue_req:
-	/* queue a request */
-	req = dev->rx_req;
-	req->length = ADB_BULK_BUFFER_SIZE;
-	dev->rx_done = 0;
-	ret = usb_ep_queue(dev->ep_out, req, GFP_ATOMIC);
-	if (ret < 0) {
-		pr_debug("adb_read: failed to queue req %p (%d)\n", req, ret);
-		r = -EIO;
-		atomic_set(&dev->error, 1);
-		goto done;
-	} else {
-		pr_debug("rx %p queue\n", req);
-	}
-
 	/* wait for a request to complete */
-	ret = wait_event_interruptible(dev->read_wq, dev->rx_done ||
+	for (;;) {
+		if (adb_rx_refill(dev) < 0) {
+			r = -EIO;
+			atomic_set(&dev->error, 1);
+			goto done;
+		}
+
+		ret = wait_event_interruptible(dev->read_wq,
+				!list_empty(&dev->rx_done) ||
+				!list_empty(&dev->rx_idle) ||
 				atomic_read(&dev->error));
-	if (ret < 0) {
-		if (ret != -ERESTARTSYS)
-		atomic_set(&dev->error, 1);
-		r = ret;
-		usb_ep_dequeue(dev->ep_out, req);
-		goto done;
+		if (ret < 0) {
+			/* requests stay queued, data is kept for next read */
+			r = ret;
+			goto done;
+		}
+		if (atomic_read(&dev->error)) {
+			r = -EIO;
+			goto done;
+		}
+		if (!list_empty(&dev->rx_done))
+			break;
 	}
-	if (!atomic_read(&dev->error)) {
-		/* If we got a 0-len packet, throw it back and try again. */
-		if (req->actual == 0)
-			goto requeue_req;
 
-		pr_debug("rx %p %d\n", req, req->actual);
-		xfer = (req->actual < count) ? req->actual : count;
-		if (copy_to_user(buf, req->buf, xfer))
-			r = -EFAULT;
+	/*
+	 * Completed requests form a byte stream; a read smaller than the
+	 * head request leaves the rest there for the next one.
+	 */
+	spin_lock_irq(&dev->lock);
+	req = list_first_entry(&dev->rx_done, struct usb_request, list);
+	spin_unlock_irq(&dev->lock);
+
+	pr_debug("rx %p %d\n", req, req->actual);
+	xfer = min_t(unsigned, count, req->actual - dev->rx_offset);
+	if (copy_to_user(buf, req->buf + dev->rx_offset, xfer)) {
+		r = -EFAULT;
+		goto done;
+	}
+	r = xfer;
 
-	} else
-		r = -EIO;
+	dev->rx_offset += xfer;
+	if (dev->rx_offset == req->actual) {
+		spin_lock_irq(&dev->lock);
+		list_del(&req->list);
+		dev->rx_offset = 0;
+		spin_unlock_irq(&dev->lock);
+		adb_req_put(dev, &dev->rx_idle, req);
+		adb_rx_refill(dev);
+	}
 
 done:
 	if (atomic_read(&dev->error))
@@ -381,8 +478,8 @@ static ssize_t adb_write(struct file *fp, const char __user *buf,
 		}
 
 		if (req != 0) {
-			if (count > ADB_BULK_BUFFER_SIZE)
-				xfer = ADB_BULK_BUFFER_SIZE;
+			if (count > dev->tx_req_len)
+				xfer = dev->tx_req_len;
 			else
 				xfer = count;
 			if (copy_from_user(req->buf, buf, xfer)) {
@@ -535,7 +632,9 @@ adb_function_unbind(struct usb_configuration *c, struct usb_function *f)
 
 	wake_up(&dev->read_wq);
 
-	adb_request_free(dev->rx_req, dev->ep_out);
+	adb_rx_flush(dev);
+	while ((req = adb_req_get(dev, &dev->rx_idle)))
+		adb_request_free(req, dev->ep_out);
 	while ((req = adb_req_get(dev, &dev->tx_idle)))
 		adb_request_free(req, dev->ep_in);
 }
@@ -595,6 +694,7 @@ static void adb_function_disable(struct usb_function *f)
 	atomic_set(&dev->error, 1);
 	usb_ep_disable(dev->ep_in);
 	usb_ep_disable(dev->ep_out);
+	adb_rx_flush(dev);
 
 	/* readers may be blocked waiting for us to go online */
 	wake_up(&dev->read_wq);
@@ -640,6 +740,8 @@ static int adb_setup(void)
 
 	INIT_DELAYED_WORK(&dev->adb_release_w, adb_release_work);
 	INIT_LIST_HEAD(&dev->tx_idle);
+	INIT_LIST_HEAD(&dev->rx_idle);
+	INIT_LIST_HEAD(&dev->rx_done);
 
 	_adb_dev = dev;
 
@@ -30,6 +30,8 @@
 #include <linux/file.h>
 #include <linux/device.h>
 #include <linux/miscdevice.h>
+#include <linux/pagemap.h>
+#include <linux/scatterlist.h>
 
 #include <linux/usb.h>
 #include <linux/usb_usual.h>
@@ -50,8 +52,10 @@
 #define STATE_ERROR                 4   /* error from completion routine */
 
 /* number of tx and rx requests to allocate */
-#define TX_REQ_MAX 4
-#define RX_REQ_MAX 2
+#define TX_REQ_DEFAULT 8
+#define RX_REQ_DEFAULT 4
+#define TX_REQ_MAX 32
+#define RX_REQ_MAX 8
 #define INTR_REQ_MAX 5
 
 /* ID for Microsoft MTP OS String */
@@ -69,6 +73,23 @@
 
 static const char mtp_shortname[] = "mtp_usb";
 
+/*
+ * Size and number of bulk requests, picked up when the function is bound.
+ * Sizes below MTP_BULK_BUFFER_SIZE are rounded up; larger sizes must be
+ * accepted by the UDC and fall back to the default if allocation fails.
+ */
+static unsigned int mtp_tx_req_len = MTP_BULK_BUFFER_SIZE;
+module_param(mtp_tx_req_len, uint, S_IRUGO | S_IWUSR);
+
+static unsigned int mtp_rx_req_len = MTP_BULK_BUFFER_SIZE;
+module_param(mtp_rx_req_len, uint, S_IRUGO | S_IWUSR);
+
+static unsigned int mtp_tx_reqs = TX_REQ_DEFAULT;
+module_param(mtp_tx_reqs, uint, S_IRUGO | S_IWUSR);
+
+static unsigned int mtp_rx_reqs = RX_REQ_DEFAULT;
+module_param(mtp_rx_reqs, uint, S_IRUGO | S_IWUSR);
+
 struct mtp_dev {
 	struct usb_function function;
 	struct usb_composite_dev *cdev;
@@ -94,6 +115,14 @@ struct mtp_dev {
 	struct usb_request *rx_req[RX_REQ_MAX];
 	int rx_done;
 
+	/* request geometry, fixed at bind time */
+	unsigned tx_req_len;
+	unsigned rx_req_len;
+	int tx_reqs;
+	int rx_reqs;
+	/* send files straight from the page cache (UDC supports sg) */
+	bool tx_sg;
+
 	/* for processing MTP_SEND_FILE, MTP_RECEIVE_FILE and
 	 * MTP_SEND_FILE_WITH_HEADER ioctls on a work queue
 	 */
@@ -264,6 +293,14 @@ struct {
 	},
 };
 
+/* page cache pages referenced by a tx request while it is queued */
+struct mtp_sg_ctx {
+	int nr_pages;
+	int max_pages;
+	struct page **pages;
+	struct scatterlist *sg;
+};
+
 struct mtp_device_status {
 	__le16	wLength;
 	__le16	wCode;
@@ -296,11 +333,40 @@ static struct usb_request *mtp_request_new(struct usb_ep *ep, int buffer_size)
 static void mtp_request_free(struct usb_request *req, struct usb_ep *ep)
 {
 	if (req) {
+		kfree(req->context);
 		kfree(req->buf);
 		usb_ep_free_request(ep, req);
 	}
 }
 
+static struct mtp_sg_ctx *mtp_sg_ctx_new(unsigned req_len)
+{
+	struct mtp_sg_ctx *ctx;
+	int max_pages = DIV_ROUND_UP(req_len, PAGE_CACHE_SIZE) + 1;
+
+	/* one extra sg entry for the data header in req->buf */
+	ctx = kzalloc(sizeof(*ctx) + max_pages * sizeof(struct page *) +
+			(max_pages + 1) * sizeof(struct scatterlist),
+			GFP_KERNEL);
+	if (!ctx)
+		return NULL;
+
+	ctx->max_pages = max_pages;
+	ctx->pages = (struct page **)(ctx + 1);
+	ctx->sg = (struct scatterlist *)(ctx->pages + max_pages);
+	return ctx;
+}
+
+static void mtp_put_sg_pages(struct usb_request *req)
+{
+	struct mtp_sg_ctx *ctx = req->context;
+
+	while (ctx->nr_pages)
+		page_cache_release(ctx->pages[--ctx->nr_pages]);
+	req->sg = NULL;
+	req->num_sgs = 0;
+}
+
 static inline int mtp_lock(atomic_t *excl)
 {
 	if (atomic_inc_return(excl) == 1) {
@@ -352,6 +418,8 @@ static void mtp_complete_in(struct usb_ep *ep, struct usb_request *req)
 	if (req->status != 0)
 		dev->state = STATE_ERROR;
 
+	if (req->num_sgs)
+		mtp_put_sg_pages(req);
 	mtp_req_put(dev, &dev->tx_idle, req);
 
 	wake_up(&dev->write_wq);
@@ -361,7 +429,8 @@ static void mtp_complete_out(struct usb_ep *ep, struct usb_request *req)
 {
 	struct mtp_dev *dev = _mtp_dev;
 
-	dev->rx_done = 1;
+	/* counts completions; OUT requests complete in queue order */
+	dev->rx_done++;
 	if (req->status != 0)
 		dev->state = STATE_ERROR;
 
@@ -419,18 +488,47 @@ static int mtp_create_bulk_endpoints(struct mtp_dev *dev,
 	ep->driver_data = dev;		/* claim the endpoint */
 	dev->ep_intr = ep;
 
+	dev->tx_req_len = max_t(unsigned, mtp_tx_req_len,
+				MTP_BULK_BUFFER_SIZE);
+	dev->rx_req_len = max_t(unsigned, mtp_rx_req_len,
+				MTP_BULK_BUFFER_SIZE);
+	dev->tx_reqs = clamp_t(int, mtp_tx_reqs, 1, TX_REQ_MAX);
+	dev->rx_reqs = clamp_t(int, mtp_rx_reqs, 1, RX_REQ_MAX);
+	dev->tx_sg = cdev->gadget->sg_supported;
+
 	/* now allocate requests for our endpoints */
-	for (i = 0; i < TX_REQ_MAX; i++) {
-		req = mtp_request_new(dev->ep_in, MTP_BULK_BUFFER_SIZE);
-		if (!req)
-			goto fail;
+retry_tx_alloc:
+	for (i = 0; i < dev->tx_reqs; i++) {
+		req = mtp_request_new(dev->ep_in, dev->tx_req_len);
+		if (!req) {
+			if (dev->tx_req_len == MTP_BULK_BUFFER_SIZE)
+				goto fail;
+			while ((req = mtp_req_get(dev, &dev->tx_idle)))
+				mtp_request_free(req, dev->ep_in);
+			dev->tx_req_len = MTP_BULK_BUFFER_SIZE;
+			goto retry_tx_alloc;
+		}
 		req->complete = mtp_complete_in;
 		mtp_req_put(dev, &dev->tx_idle, req);
+		if (dev->tx_sg) {
+			req->context = mtp_sg_ctx_new(dev->tx_req_len);
+			if (!req->context)
+				goto fail;
+		}
 	}
-	for (i = 0; i < RX_REQ_MAX; i++) {
-		req = mtp_request_new(dev->ep_out, MTP_BULK_BUFFER_SIZE);
-		if (!req)
-			goto fail;
+retry_rx_alloc:
+	for (i = 0; i < dev->rx_reqs; i++) {
+		req = mtp_request_new(dev->ep_out, dev->rx_req_len);
+		if (!req) {
+			if (dev->rx_req_len == MTP_BULK_BUFFER_SIZE)
+				goto fail;
+			while (i--) {
+				mtp_request_free(dev->rx_req[i], dev->ep_out);
+				dev->rx_req[i] = NULL;
+			}
+			dev->rx_req_len = MTP_BULK_BUFFER_SIZE;
+			goto retry_rx_alloc;
+		}
 		req->complete = mtp_complete_out;
 		dev->rx_req[i] = req;
 	}
@@ -460,7 +558,7 @@ static ssize_t mtp_read(struct file *fp, char __user *buf,
 
 	DBG(cdev, "mtp_read(%d)\n", count);
 
-	if (count > MTP_BULK_BUFFER_SIZE)
+	if (count > dev->rx_req_len)
 		return -EINVAL;
 
 	/* we will block until we're online */
@@ -589,8 +687,8 @@ static ssize_t mtp_write(struct file *fp, const char __user *buf,
 			break;
 		}
 
-		if (count > MTP_BULK_BUFFER_SIZE)
-			xfer = MTP_BULK_BUFFER_SIZE;
+		if (count > dev->tx_req_len)
+			xfer = dev->tx_req_len;
 		else
 			xfer = count;
 		if (xfer && copy_from_user(req->buf, buf, xfer)) {
@@ -627,6 +725,70 @@ static ssize_t mtp_write(struct file *fp, const char __user *buf,
 	return r;
 }
 
+/*
+ * Reference up to @len bytes of @filp at *@offset in the page cache and
+ * describe them in the sg list of @req, behind @hdr_size bytes of data
+ * header already in req->buf.  Returns the number of file bytes mapped.
+ */
+static int mtp_map_file_pages(struct file *filp, struct usb_request *req,
+		loff_t *offset, int hdr_size, int len)
+{
+	struct mtp_sg_ctx *ctx = req->context;
+	struct address_space *mapping = filp->f_mapping;
+	struct scatterlist *sg = ctx->sg;
+	loff_t isize = i_size_read(mapping->host);
+	struct page *page;
+	pgoff_t index, last;
+	unsigned off, n;
+	int mapped = 0;
+
+	if (*offset >= isize)
+		len = 0;
+	else if (len > isize - *offset)
+		len = isize - *offset;
+
+	sg_init_table(ctx->sg, ctx->max_pages + 1);
+	if (hdr_size)
+		sg_set_buf(sg++, req->buf, hdr_size);
+
+	index = *offset >> PAGE_CACHE_SHIFT;
+	last = (*offset + len) >> PAGE_CACHE_SHIFT;
+	while (mapped < len) {
+		page = find_get_page(mapping, index);
+		if (!page) {
+			page_cache_sync_readahead(mapping, &filp->f_ra, filp,
+					index, last - index + 1);
+		} else {
+			if (PageReadahead(page))
+				page_cache_async_readahead(mapping,
+					&filp->f_ra, filp, page, index,
+					last - index + 1);
+			page_cache_release(page);
+		}
+
+		page = read_mapping_page(mapping, index, filp);
+		if (IS_ERR(page)) {
+			mtp_put_sg_pages(req);
+			return PTR_ERR(page);
+		}
+
+		off = (*offset + mapped) & ~PAGE_CACHE_MASK;
+		n = min_t(unsigned, PAGE_CACHE_SIZE - off, len - mapped);
+		ctx->pages[ctx->nr_pages++] = page;
+		sg_set_page(sg++, page, n, off);
+		mapped += n;
+		index++;
+	}
+
+	if (sg != ctx->sg) {
+		sg_mark_end(sg - 1);
+		req->sg = ctx->sg;
+		req->num_sgs = sg - ctx->sg;
+	}
+	*offset += mapped;
+	return mapped;
+}
+
 /* read from a local file and write to USB */
 static void send_file_work(struct work_struct *data)
 {
@@ -641,6 +803,7 @@ static void send_file_work(struct work_struct *data)
 	int xfer, ret, hdr_size;
 	int r = 0;
 	int sendZLP = 0;
+	bool use_sg;
 
 	/* read our parameters */
 	smp_rmb();
@@ -650,6 +813,14 @@ static void send_file_work(struct work_struct *data)
 
 	DBG(cdev, "send_file_work(%lld %lld)\n", offset, count);
 
+	/*
+	 * Regular files with a readpage method are sent straight out of the
+	 * page cache when the UDC can do scatter-gather; anything else is
+	 * copied through the request buffer.
+	 */
+	use_sg = dev->tx_sg && S_ISREG(filp->f_path.dentry->d_inode->i_mode) &&
+		filp->f_mapping->a_ops->readpage;
+
 	if (dev->xfer_send_header) {
 		hdr_size = sizeof(struct mtp_data_header);
 		count += hdr_size;
@@ -682,8 +853,8 @@ static void send_file_work(struct work_struct *data)
 			break;
 		}
 
-		if (count > MTP_BULK_BUFFER_SIZE)
-			xfer = MTP_BULK_BUFFER_SIZE;
+		if (count > dev->tx_req_len)
+			xfer = dev->tx_req_len;
 		else
 			xfer = count;
 
@@ -697,8 +868,12 @@ static void send_file_work(struct work_struct *data)
 					__cpu_to_le32(dev->xfer_transaction_id);
 		}
 
-		ret = vfs_read(filp, req->buf + hdr_size, xfer - hdr_size,
-								&offset);
+		if (use_sg)
+			ret = mtp_map_file_pages(filp, req, &offset, hdr_size,
+							xfer - hdr_size);
+		else
+			ret = vfs_read(filp, req->buf + hdr_size,
+						xfer - hdr_size, &offset);
 		if (ret < 0) {
 			r = ret;
 			break;
@@ -722,8 +897,11 @@ static void send_file_work(struct work_struct *data)
 		req = 0;
 	}
 
-	if (req)
+	if (req) {
+		if (req->num_sgs)
+			mtp_put_sg_pages(req);
 		mtp_req_put(dev, &dev->tx_idle, req);
+	}
 
 	DBG(cdev, "send_file_work returning %d\n", r);
 	/* write the result */
@@ -737,11 +915,12 @@ static void receive_file_work(struct work_struct *data)
 	struct mtp_dev *dev = container_of(data, struct mtp_dev,
 						receive_file_work);
 	struct usb_composite_dev *cdev = dev->cdev;
-	struct usb_request *read_req = NULL, *write_req = NULL;
+	struct usb_request *req;
 	struct file *filp;
 	loff_t offset;
 	int64_t count;
-	int ret, cur_buf = 0;
+	int ret, head = 0, tail = 0, queued = 0, max_queued;
+	int completed = 0;
 	int r = 0;
 
 	/* read our parameters */
@@ -752,68 +931,81 @@ static void receive_file_work(struct work_struct *data)
 
 	DBG(cdev, "receive_file_work(%lld)\n", count);
 
-	while (count > 0 || write_req) {
-		if (count > 0) {
-			/* queue a request */
-			read_req = dev->rx_req[cur_buf];
-			cur_buf = (cur_buf + 1) % RX_REQ_MAX;
+	/*
+	 * Keep up to rx_reqs reads queued while completed ones are written
+	 * out.  When xfer_file_length is 0xFFFFFFFF the end of the data is
+	 * only seen as a short packet, so queue one read at a time to avoid
+	 * swallowing the next command from the host.
+	 */
+	max_queued = (count == 0xFFFFFFFF) ? 1 : dev->rx_reqs;
+	dev->rx_done = 0;
 
-			read_req->length = (count > MTP_BULK_BUFFER_SIZE
-					? MTP_BULK_BUFFER_SIZE : count);
-			dev->rx_done = 0;
-			ret = usb_ep_queue(dev->ep_out, read_req, GFP_KERNEL);
+	while (count > 0 || queued) {
+		while (count > 0 && queued < max_queued) {
+			req = dev->rx_req[tail];
+			req->length = (count > dev->rx_req_len
+					? dev->rx_req_len : count);
+			ret = usb_ep_queue(dev->ep_out, req, GFP_KERNEL);
 			if (ret < 0) {
 				r = -EIO;
 				if (dev->state != STATE_OFFLINE)
 					dev->state = STATE_ERROR;
-				break;
+				goto out;
 			}
+			/* if xfer_file_length is 0xFFFFFFFF, then we read
+			 * until we get a zero length packet
+			 */
+			if (count != 0xFFFFFFFF)
+				count -= req->length;
+			tail = (tail + 1) % dev->rx_reqs;
+			queued++;
 		}
 
-		if (write_req) {
-			DBG(cdev, "rx %p %d\n", write_req, write_req->actual);
-			ret = vfs_write(filp, write_req->buf, write_req->actual,
-				&offset);
-			DBG(cdev, "vfs_write %d\n", ret);
-			if (ret != write_req->actual) {
-				r = -EIO;
-				if (dev->state != STATE_OFFLINE)
-					dev->state = STATE_ERROR;
-				break;
-			}
-			write_req = NULL;
+		/* wait for the oldest read to complete */
+		req = dev->rx_req[head];
+		ret = wait_event_interruptible(dev->read_wq,
+			dev->rx_done != completed || dev->state != STATE_BUSY);
+		if (dev->state == STATE_CANCELED
+				|| dev->state == STATE_OFFLINE) {
+			r = -ECANCELED;
+			goto out;
 		}
+		if (ret < 0 || req->status) {
+			r = ret < 0 ? ret : -EIO;
+			goto out;
+		}
+		completed++;
+		head = (head + 1) % dev->rx_reqs;
+		queued--;
 
-		if (read_req) {
-			/* wait for our last read to complete */
-			ret = wait_event_interruptible(dev->read_wq,
-				dev->rx_done || dev->state != STATE_BUSY);
-			if (dev->state == STATE_CANCELED
-					|| dev->state == STATE_OFFLINE) {
-				r = -ECANCELED;
-				if (!dev->rx_done)
-					usb_ep_dequeue(dev->ep_out, read_req);
-				break;
-			}
-			/* if xfer_file_length is 0xFFFFFFFF, then we read until
-			 * we get a zero length packet
-			 */
-			if (count != 0xFFFFFFFF)
-				count -= read_req->actual;
-			if (read_req->actual < read_req->length) {
-				/*
-				 * short packet is used to signal EOF for
-				 * sizes > 4 gig
-				 */
-				DBG(cdev, "got short packet\n");
-				count = 0;
-			}
+		DBG(cdev, "rx %p %d\n", req, req->actual);
+		ret = vfs_write(filp, req->buf, req->actual, &offset);
+		DBG(cdev, "vfs_write %d\n", ret);
+		if (ret != req->actual) {
+			r = -EIO;
+			if (dev->state != STATE_OFFLINE)
+				dev->state = STATE_ERROR;
+			goto out;
+		}
 
-			write_req = read_req;
-			read_req = NULL;
+		if (req->actual < req->length) {
+			/*
+			 * short packet is used to signal EOF for
+			 * sizes > 4 gig
+			 */
+			DBG(cdev, "got short packet\n");
+			count = 0;
+			goto out;
 		}
 	}
 
+out:
+	/* cancel reads still outstanding */
+	while (queued--) {
+		usb_ep_dequeue(dev->ep_out, dev->rx_req[head]);
+		head = (head + 1) % dev->rx_reqs;
+	}
+
 	DBG(cdev, "receive_file_work returning %d\n", r);
 	/* write the result */
 	dev->xfer_result = r;
@@ -1129,8 +1321,10 @@ mtp_function_unbind(struct usb_configuration *c, struct usb_function *f)
 
 	while ((req = mtp_req_get(dev, &dev->tx_idle)))
 		mtp_request_free(req, dev->ep_in);
-	for (i = 0; i < RX_REQ_MAX; i++)
+	for (i = 0; i < RX_REQ_MAX; i++) {
 		mtp_request_free(dev->rx_req[i], dev->ep_out);
+		dev->rx_req[i] = NULL;
+	}
 	while ((req = mtp_req_get(dev, &dev->intr_idle)))
 		mtp_request_free(req, dev->ep_intr);
 	dev->state = STATE_OFFLINE;
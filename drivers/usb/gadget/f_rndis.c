@@ -83,6 +83,25 @@ struct f_rndis {
 	atomic_t			notify_count;
 };
 
+/* Multi packet RNDIS: how many packets may share one bulk transfer.
+ * The device->host limit also obeys the host's MaxTransferSize; the
+ * host->device limit is advertised in the INITIALIZE completion.
+ */
+static unsigned int rndis_dl_max_pkt_per_xfer = TX_SKB_HOLD_THRESHOLD;
+module_param(rndis_dl_max_pkt_per_xfer, uint, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(rndis_dl_max_pkt_per_xfer,
+	"Maximum packets per device->host transfer");
+
+static unsigned int rndis_dl_max_xfer_size;
+module_param(rndis_dl_max_xfer_size, uint, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(rndis_dl_max_xfer_size,
+	"Maximum bytes per device->host transfer (0: host limit)");
+
+static unsigned int rndis_ul_max_pkt_per_xfer = TX_SKB_HOLD_THRESHOLD;
+module_param(rndis_ul_max_pkt_per_xfer, uint, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(rndis_ul_max_pkt_per_xfer,
+	"Maximum packets per host->device transfer");
+
 static inline struct f_rndis *func_to_rndis(struct usb_function *f)
 {
 	return container_of(f, struct f_rndis, port.func);
@@ -473,13 +492,19 @@ static void rndis_command_complete(struct usb_ep *ep, struct usb_request *req)
 
 	buf = (rndis_init_msg_type *)req->buf;
 
-	if (buf->MessageType == REMOTE_NDIS_INITIALIZE_MSG) {
-		if (buf->MaxTransferSize > 2048)
+	if (le32_to_cpu(buf->MessageType) == REMOTE_NDIS_INITIALIZE_MSG) {
+		u32 max_xfer = le32_to_cpu(buf->MaxTransferSize);
+
+		if (max_xfer > 2048 && rndis_dl_max_pkt_per_xfer > 1)
 			rndis->port.multi_pkt_xfer = 1;
 		else
 			rndis->port.multi_pkt_xfer = 0;
+		rndis->port.dl_max_pkts_per_xfer = rndis_dl_max_pkt_per_xfer;
+		if (rndis_dl_max_xfer_size)
+			max_xfer = min(max_xfer, rndis_dl_max_xfer_size);
+		rndis->port.dl_max_xfer_size = max_xfer;
 		DBG(cdev, "%s: MaxTransferSize: %d : Multi_pkt_txr: %s\n",
-				__func__, buf->MaxTransferSize,
+				__func__, max_xfer,
 				rndis->port.multi_pkt_xfer ? "enabled" :
 							    "disabled");
 	}
@@ -796,6 +821,7 @@ rndis_bind(struct usb_configuration *c, struct usb_function *f)
 
 	rndis_set_param_medium(rndis->config, NDIS_MEDIUM_802_3, 0);
 	rndis_set_host_mac(rndis->config, rndis->ethaddr);
+	rndis_set_max_pkt_xfer(rndis->config, rndis->port.ul_max_pkts_per_xfer);
 
 	if (rndis->manufacturer && rndis->vendorID &&
 			rndis_set_param_vendor(rndis->config, rndis->vendorID,
@@ -959,8 +985,11 @@ rndis_bind_config_vendor(struct usb_configuration *c, u8 ethaddr[ETH_ALEN],
 	/* RNDIS activates when the host changes this filter */
 	rndis->port.cdc_filter = 0;
 
-	/* RNDIS has special (and complex) framing */
-	rndis->port.header_len = sizeof(struct rndis_packet_msg_type);
+	/* RNDIS has special (and complex) framing; header_len sizes the
+	 * transfer buffers, so it covers padding as MaxTransferSize does
+	 */
+	rndis->port.header_len = RNDIS_PKT_OVERHEAD;
+	rndis->port.ul_max_pkts_per_xfer = rndis_ul_max_pkt_per_xfer ? : 1;
 	rndis->port.wrap = rndis_add_header;
 	rndis->port.unwrap = rndis_rm_hdr;
 
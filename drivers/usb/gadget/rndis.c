@@ -585,12 +585,11 @@ static int rndis_init_response(int configNr, rndis_init_msg_type *buf)
 	resp->MinorVersion = cpu_to_le32(RNDIS_MINOR_VERSION);
 	resp->DeviceFlags = cpu_to_le32(RNDIS_DF_CONNECTIONLESS);
 	resp->Medium = cpu_to_le32(RNDIS_MEDIUM_802_3);
-	resp->MaxPacketsPerTransfer = cpu_to_le32(1);
-	resp->MaxTransferSize = cpu_to_le32(
-		  params->dev->mtu
+	resp->MaxPacketsPerTransfer = cpu_to_le32(params->max_pkt_per_xfer);
+	resp->MaxTransferSize = cpu_to_le32(params->max_pkt_per_xfer *
+		(params->dev->mtu
 		+ sizeof(struct ethhdr)
-		+ sizeof(struct rndis_packet_msg_type)
-		+ 22);
+		+ RNDIS_PKT_OVERHEAD));
 	resp->PacketAlignmentFactor = cpu_to_le32(0);
 	resp->AFListOffset = cpu_to_le32(0);
 	resp->AFListSize = cpu_to_le32(0);
@@ -790,6 +789,17 @@ void rndis_set_host_mac(int configNr, const u8 *addr)
 	rndis_per_dev_params[configNr].host_mac = addr;
 }
 
+/* how many packets the host may bundle into one OUT transfer */
+void rndis_set_max_pkt_xfer(u8 configNr, u32 max_pkt_per_xfer)
+{
+	pr_debug("%s: %u\n", __func__, max_pkt_per_xfer);
+	if (configNr >= RNDIS_MAX_CONFIGS)
+		return;
+
+	rndis_per_dev_params[configNr].max_pkt_per_xfer =
+		max_t(u32, max_pkt_per_xfer, 1);
+}
+
 /*
  * Message Parser
  */
@@ -900,6 +910,7 @@ int rndis_register(void (*resp_avail)(void *v), void *v)
 	for (i = 0; i < RNDIS_MAX_CONFIGS; i++) {
 		if (!rndis_per_dev_params[i].used) {
 			rndis_per_dev_params[i].used = 1;
+			rndis_per_dev_params[i].max_pkt_per_xfer = 1;
 			rndis_per_dev_params[i].resp_avail = resp_avail;
 			rndis_per_dev_params[i].v = v;
 			pr_debug("%s: configNr = %d\n", __func__, i);
@@ -1023,29 +1034,66 @@ static rndis_resp_t *rndis_add_response(int configNr, u32 length)
 	return r;
 }
 
+/*
+ * Hosts honouring MaxPacketsPerTransfer may send several packet messages
+ * back to back in one transfer.  Every packet but the last is queued as
+ * a clone sharing the transfer's buffer; the last one reuses @skb.
+ */
 int rndis_rm_hdr(struct gether *port,
 			struct sk_buff *skb,
 			struct sk_buff_head *list)
 {
-	/* tmp points to a struct rndis_packet_msg_type */
-	__le32 *tmp = (void *)skb->data;
-
-	/* MessageType, MessageLength */
-	if (cpu_to_le32(REMOTE_NDIS_PACKET_MSG)
-			!= get_unaligned(tmp++)) {
+	if (skb->len < sizeof(struct rndis_packet_msg_type)) {
 		dev_kfree_skb_any(skb);
 		return -EINVAL;
 	}
-	tmp++;
 
-	/* DataOffset, DataLength */
-	if (!skb_pull(skb, get_unaligned_le32(tmp++) + 8)) {
-		dev_kfree_skb_any(skb);
-		return -EOVERFLOW;
+	while (skb->len >= sizeof(struct rndis_packet_msg_type)) {
+		/* tmp points to a struct rndis_packet_msg_type */
+		__le32 *tmp = (void *)skb->data;
+		struct sk_buff *skb2;
+		u32 msg_len, data_offset, data_len;
+
+		/* MessageType, MessageLength */
+		if (cpu_to_le32(REMOTE_NDIS_PACKET_MSG)
+				!= get_unaligned(tmp++)) {
+			dev_kfree_skb_any(skb);
+			return -EINVAL;
+		}
+		msg_len = get_unaligned_le32(tmp++);
+
+		/* DataOffset, DataLength */
+		data_offset = get_unaligned_le32(tmp++) + 8;
+		data_len = get_unaligned_le32(tmp++);
+
+		if (data_offset > skb->len ||
+				data_len > skb->len - data_offset) {
+			dev_kfree_skb_any(skb);
+			return -EOVERFLOW;
+		}
+
+		/* last (or only) packet in this transfer */
+		if (msg_len < data_offset + data_len || msg_len >= skb->len) {
+			skb_pull(skb, data_offset);
+			skb_trim(skb, data_len);
+			skb_queue_tail(list, skb);
+			return 0;
+		}
+
+		skb2 = skb_clone(skb, GFP_ATOMIC);
+		if (!skb2) {
+			dev_kfree_skb_any(skb);
+			return -ENOMEM;
+		}
+		skb_pull(skb2, data_offset);
+		skb_trim(skb2, data_len);
+		skb_queue_tail(list, skb2);
+
+		skb_pull(skb, msg_len);
 	}
-	skb_trim(skb, get_unaligned_le32(tmp++));
 
-	skb_queue_tail(list, skb);
+	/* trailing pad after the last packet message */
+	dev_kfree_skb_any(skb);
 	return 0;
 }
 
@@ -1063,7 +1111,8 @@ static int rndis_proc_show(struct seq_file *m, void *v)
 			 "speed     : %d\n"
 			 "cable     : %s\n"
 			 "vendor ID : 0x%08X\n"
-			 "vendor    : %s\n",
+			 "vendor    : %s\n"
+			 "pkts/xfer : %u\n",
 			 param->confignr, (param->used) ? "y" : "n",
 			 ({ char *s = "?";
 			 switch (param->state) {
@@ -1077,7 +1126,8 @@ static int rndis_proc_show(struct seq_file *m, void *v)
 			 param->medium,
 			 (param->media_state) ? 0 : param->speed*100,
 			 (param->media_state) ? "disconnected" : "connected",
-			 param->vendorID, param->vendorDescr);
+			 param->vendorID, param->vendorDescr,
+			 param->max_pkt_per_xfer);
 	return 0;
 }
 
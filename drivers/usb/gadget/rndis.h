@@ -195,6 +195,14 @@ struct rndis_packet_msg_type
 	__le32	Reserved;
 } __attribute__ ((packed));
 
+/*
+ * Per-packet framing in a data transfer: the packet message header plus
+ * up to 22 bytes of padding after the frame.  MaxTransferSize and the
+ * gadget's OUT and IN buffers are all sized from it, so that a host
+ * filling a transfer to MaxTransferSize always fits.
+ */
+#define RNDIS_PKT_OVERHEAD	(sizeof(struct rndis_packet_msg_type) + 22)
+
 struct rndis_config_parameter
 {
 	__le32	ParameterNameOffset;
@@ -235,6 +243,7 @@ typedef struct rndis_params
 	struct net_device	*dev;
 
 	u32			vendorID;
+	u32			max_pkt_per_xfer;
 	const char		*vendorDescr;
 	void			(*resp_avail)(void *v);
 	void			*v;
@@ -261,6 +270,7 @@ int  rndis_signal_connect (int configNr);
 int  rndis_signal_disconnect (int configNr);
 int  rndis_state (int configNr);
 extern void rndis_set_host_mac (int configNr, const u8 *addr);
+void rndis_set_max_pkt_xfer(u8 configNr, u32 max_pkt_per_xfer);
 
 int rndis_init(void);
 void rndis_exit (void);
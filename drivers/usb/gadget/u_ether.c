@@ -66,6 +66,13 @@ struct eth_dev {
 	int			no_tx_req_used;
 	int			tx_skb_hold_count;
 	u32			tx_req_bufsize;
+	u32			tx_max_pkts;
+
+	/* transfers vs. packets carried, reported through ethtool -S */
+	unsigned long		tx_xfers;
+	unsigned long		tx_xfer_pkts;
+	unsigned long		rx_xfers;
+	unsigned long		rx_xfer_pkts;
 
 	struct sk_buff_head	rx_frames;
 
@@ -184,6 +191,43 @@ static void eth_get_drvinfo(struct net_device *net, struct ethtool_drvinfo *p)
 	strlcpy(p->bus_info, dev_name(&dev->gadget->dev), sizeof p->bus_info);
 }
 
+static const char eth_gstrings_stats[][ETH_GSTRING_LEN] = {
+	"tx_xfers",
+	"tx_xfer_pkts",
+	"rx_xfers",
+	"rx_xfer_pkts",
+};
+
+static int eth_get_sset_count(struct net_device *net, int sset)
+{
+	switch (sset) {
+	case ETH_SS_STATS:
+		return ARRAY_SIZE(eth_gstrings_stats);
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
+static void eth_get_strings(struct net_device *net, u32 sset, u8 *data)
+{
+	if (sset == ETH_SS_STATS)
+		memcpy(data, eth_gstrings_stats, sizeof(eth_gstrings_stats));
+}
+
+/* packets per transfer is {tx,rx}_xfer_pkts / {tx,rx}_xfers; with
+ * multi packet RNDIS that's how well the link is aggregating.
+ */
+static void eth_get_ethtool_stats(struct net_device *net,
+		struct ethtool_stats *stats, u64 *data)
+{
+	struct eth_dev	*dev = netdev_priv(net);
+
+	data[0] = dev->tx_xfers;
+	data[1] = dev->tx_xfer_pkts;
+	data[2] = dev->rx_xfers;
+	data[3] = dev->rx_xfer_pkts;
+}
+
 /* REVISIT can also support:
  *   - WOL (by tracking suspends and issuing remote wakeup)
  *   - msglevel (implies updated messaging)
@@ -193,6 +237,9 @@ static void eth_get_drvinfo(struct net_device *net, struct ethtool_drvinfo *p)
 static const struct ethtool_ops ops = {
 	.get_drvinfo = eth_get_drvinfo,
 	.get_link = ethtool_op_get_link,
+	.get_sset_count = eth_get_sset_count,
+	.get_strings = eth_get_strings,
+	.get_ethtool_stats = eth_get_ethtool_stats,
 };
 
 static void defer_kevent(struct eth_dev *dev, int flag)
@@ -215,11 +262,14 @@ rx_submit(struct eth_dev *dev, struct usb_request *req, gfp_t gfp_flags)
 	size_t		size = 0;
 	struct usb_ep	*out;
 	unsigned long	flags;
+	u32		max_pkts = 1;
 
 	spin_lock_irqsave(&dev->lock, flags);
-	if (dev->port_usb)
+	if (dev->port_usb) {
 		out = dev->port_usb->out_ep;
-	else
+		if (dev->port_usb->ul_max_pkts_per_xfer)
+			max_pkts = dev->port_usb->ul_max_pkts_per_xfer;
+	} else
 		out = NULL;
 	spin_unlock_irqrestore(&dev->lock, flags);
 
@@ -238,9 +288,17 @@ rx_submit(struct eth_dev *dev, struct usb_request *req, gfp_t gfp_flags)
 	 * pad to end-of-packet.  That's potentially nice for speed, but
 	 * means receivers can't recover lost synch on their own (because
 	 * new packets don't only start after a short RX).
+	 *
+	 * Hosts doing multi packet transfers may fill one request with
+	 * up to max_pkts framed packets.  header_len must cover all the
+	 * per-packet framing the function advertises (for RNDIS that is
+	 * what MaxTransferSize is computed from), as RX_EXTRA does not
+	 * grow with max_pkts.
 	 */
-	size += sizeof(struct ethhdr) + dev->net->mtu + RX_EXTRA;
+	size += sizeof(struct ethhdr) + dev->net->mtu;
 	size += dev->port_usb->header_len;
+	size *= max_pkts;
+	size += RX_EXTRA;
 	size += out->maxpacket - 1;
 	size -= size % out->maxpacket;
 
@@ -288,21 +346,32 @@ static void rx_complete(struct usb_ep *ep, struct usb_request *req)
 	/* normal completion */
 	case 0:
 		skb_put(skb, req->actual);
+		dev->rx_xfers++;
 
 		if (dev->unwrap) {
-			unsigned long	flags;
+			struct sk_buff_head	frames;
+			unsigned long		flags;
+
+			/* one transfer may carry several packets */
+			skb_queue_head_init(&frames);
 
 			spin_lock_irqsave(&dev->lock, flags);
 			if (dev->port_usb) {
 				status = dev->unwrap(dev->port_usb,
 							skb,
-							&dev->rx_frames);
+							&frames);
 			} else {
 				dev_kfree_skb_any(skb);
 				status = -ENOTCONN;
 			}
 			spin_unlock_irqrestore(&dev->lock, flags);
+
+			dev->rx_xfer_pkts += skb_queue_len(&frames);
+			spin_lock_irqsave(&dev->rx_frames.lock, flags);
+			skb_queue_splice_tail(&frames, &dev->rx_frames);
+			spin_unlock_irqrestore(&dev->rx_frames.lock, flags);
 		} else {
+			dev->rx_xfer_pkts++;
 			skb_queue_tail(&dev->rx_frames, skb);
 		}
 
@@ -502,7 +571,6 @@ static void tx_complete(struct usb_ep *ep, struct usb_request *req)
 		else
 			dev->net->stats.tx_bytes += req->length;
 	}
-	dev->net->stats.tx_packets++;
 
 	spin_lock(&dev->req_lock);
 	list_add_tail(&req->list, &dev->tx_reqs);
@@ -516,6 +584,11 @@ static void tx_complete(struct usb_ep *ep, struct usb_request *req)
 			new_req = container_of(dev->tx_reqs.next,
 					struct usb_request, list);
 			list_del(&new_req->list);
+			/* a partly filled request goes out now; the
+			 * next packet starts a new aggregate
+			 */
+			if (new_req->length > 0)
+				dev->tx_skb_hold_count = 0;
 			spin_unlock(&dev->req_lock);
 			if (new_req->length > 0) {
 				length = new_req->length;
@@ -549,6 +622,7 @@ static void tx_complete(struct usb_ep *ep, struct usb_request *req)
 				case 0:
 					spin_lock(&dev->req_lock);
 					dev->no_tx_req_used++;
+					dev->tx_xfers++;
 					spin_unlock(&dev->req_lock);
 					net->trans_start = jiffies;
 				}
@@ -562,6 +636,7 @@ static void tx_complete(struct usb_ep *ep, struct usb_request *req)
 		}
 	} else {
 		spin_unlock(&dev->req_lock);
+		dev->net->stats.tx_packets++;
 		dev_kfree_skb_any(skb);
 	}
 
@@ -574,24 +649,46 @@ static inline int is_promisc(u16 cdc_filter)
 	return cdc_filter & USB_CDC_PACKET_TYPE_PROMISCUOUS;
 }
 
-static void alloc_tx_buffer(struct eth_dev *dev)
+static int alloc_tx_buffer(struct eth_dev *dev, struct gether *link)
 {
 	struct list_head	*act;
 	struct usb_request	*req;
+	unsigned long		flags;
+	u32			pkt_size;
+	u32			max_pkts;
+
+	pkt_size = dev->net->mtu + sizeof(struct ethhdr) + link->header_len;
+
+	/* hold no more packets than the host can take in one transfer */
+	max_pkts = link->dl_max_pkts_per_xfer ? : TX_SKB_HOLD_THRESHOLD;
+	if (link->dl_max_xfer_size)
+		max_pkts = min(max_pkts, link->dl_max_xfer_size / pkt_size);
+	dev->tx_max_pkts = max_t(u32, max_pkts, 1);
+
+	spin_lock_irqsave(&dev->req_lock, flags);
+	list_for_each(act, &dev->tx_reqs) {
+		req = container_of(act, struct usb_request, list);
+		if (!req->buf) {
+			req->buf = kmalloc(dev->tx_max_pkts * pkt_size,
+					   GFP_ATOMIC);
+			if (!req->buf)
+				goto free_buf;
+		}
+	}
+	spin_unlock_irqrestore(&dev->req_lock, flags);
 
-	dev->tx_req_bufsize = (TX_SKB_HOLD_THRESHOLD *
-				(dev->net->mtu
-				+ sizeof(struct ethhdr)
-				/* size of rndis_packet_msg_type */
-				+ 44
-				+ 22));
+	dev->tx_req_bufsize = dev->tx_max_pkts * pkt_size;
+	return 0;
 
+free_buf:
+	/* tx_req_bufsize stays 0, so the next transmit tries again */
 	list_for_each(act, &dev->tx_reqs) {
 		req = container_of(act, struct usb_request, list);
-		if (!req->buf)
-			req->buf = kmalloc(dev->tx_req_bufsize,
-						GFP_ATOMIC);
+		kfree(req->buf);
+		req->buf = NULL;
 	}
+	spin_unlock_irqrestore(&dev->req_lock, flags);
+	return -ENOMEM;
 }
 
 static netdev_tx_t eth_start_xmit(struct sk_buff *skb,
@@ -605,12 +702,14 @@ static netdev_tx_t eth_start_xmit(struct sk_buff *skb,
 	struct usb_ep		*in;
 	u16			cdc_filter;
 	bool			multi_pkt_xfer = false;
+	struct gether		*link;
 
 	spin_lock_irqsave(&dev->lock, flags);
-	if (dev->port_usb) {
-		in = dev->port_usb->in_ep;
-		cdc_filter = dev->port_usb->cdc_filter;
-		multi_pkt_xfer = dev->port_usb->multi_pkt_xfer;
+	link = dev->port_usb;
+	if (link) {
+		in = link->in_ep;
+		cdc_filter = link->cdc_filter;
+		multi_pkt_xfer = link->multi_pkt_xfer;
 	} else {
 		in = NULL;
 		cdc_filter = 0;
@@ -623,8 +722,12 @@ static netdev_tx_t eth_start_xmit(struct sk_buff *skb,
 	}
 
 	/* Allocate memory for tx_reqs to support multi packet transfer */
-	if (multi_pkt_xfer && !dev->tx_req_bufsize)
-		alloc_tx_buffer(dev);
+	if (multi_pkt_xfer && !dev->tx_req_bufsize &&
+	    alloc_tx_buffer(dev, link)) {
+		dev->net->stats.tx_dropped++;
+		dev_kfree_skb_any(skb);
+		return NETDEV_TX_OK;
+	}
 
 	/* apply outgoing CDC or RNDIS filters */
 	if (!is_promisc(cdc_filter)) {
@@ -684,6 +787,7 @@ static netdev_tx_t eth_start_xmit(struct sk_buff *skb,
 
 	spin_lock_irqsave(&dev->req_lock, flags);
 	dev->tx_skb_hold_count++;
+	dev->tx_xfer_pkts++;
 	spin_unlock_irqrestore(&dev->req_lock, flags);
 
 	if (multi_pkt_xfer) {
@@ -691,9 +795,14 @@ static netdev_tx_t eth_start_xmit(struct sk_buff *skb,
 		req->length = req->length + skb->len;
 		length = req->length;
 		dev_kfree_skb_any(skb);
+		dev->net->stats.tx_packets++;
 
+		/* keep filling this request while enough others are in
+		 * flight; their completions send it out if no more
+		 * packets arrive.
+		 */
 		spin_lock_irqsave(&dev->req_lock, flags);
-		if (dev->tx_skb_hold_count < TX_SKB_HOLD_THRESHOLD) {
+		if (dev->tx_skb_hold_count < dev->tx_max_pkts) {
 			if (dev->no_tx_req_used > TX_REQ_THRESHOLD) {
 				list_add(&req->list, &dev->tx_reqs);
 				spin_unlock_irqrestore(&dev->req_lock, flags);
@@ -755,6 +864,7 @@ static netdev_tx_t eth_start_xmit(struct sk_buff *skb,
 		break;
 	case 0:
 		net->trans_start = jiffies;
+		dev->tx_xfers++;
 	}
 
 	if (retval) {
@@ -56,6 +56,12 @@ struct gether {
 /* Max number of SKB packets to be used to create Multi Packet RNDIS */
 #define TX_SKB_HOLD_THRESHOLD		3
 	bool				multi_pkt_xfer;
+	/* multi packet limits: packets per IN/OUT transfer, and the
+	 * largest IN transfer the host accepts (0 means no limit)
+	 */
+	u32				dl_max_pkts_per_xfer;
+	u32				dl_max_xfer_size;
+	u32				ul_max_pkts_per_xfer;
 	struct sk_buff			*(*wrap)(struct gether *port,
 						struct sk_buff *skb);
 	int				(*unwrap)(struct gether *port,
@@ -20,6 +20,7 @@
 #define DEINIT_TYPE			16
 #define USER_SPACE_LOG_TYPE		32
 #define DCI_DATA_TYPE			64
+#define USER_SPACE_RING_TYPE		128
 #define USB_MODE			1
 #define MEMORY_DEVICE_MODE		2
 #define NO_LOGGING_MODE			3
@@ -41,6 +42,33 @@
 #define DIAG_IOCTL_DCI_SUPPORT		22
 #define DIAG_IOCTL_DCI_REG		23
 
+/*
+ * Memory device ring.  The logging process mmap()s /dev/diag: the first
+ * page holds struct diag_ring_hdr, the rest is the data area.  The driver
+ * appends records at head, the reader consumes them in place and stores
+ * the new tail.  Each record is a struct diag_ring_rec followed by len
+ * bytes of payload, padded to DIAG_RING_ALIGN.  A record with proc
+ * DIAG_RING_PAD, or less than a record header left before the end of the
+ * data area, means the next record starts at offset 0.  A read() that
+ * returns USER_SPACE_RING_TYPE is the doorbell for new records.  The data
+ * area must hold two of the largest peripheral packets (16 KB each);
+ * smaller mappings are refused.
+ */
+struct diag_ring_hdr {
+	uint32_t size;		/* bytes in the data area */
+	uint32_t head;		/* next write offset, driver owned */
+	uint32_t tail;		/* next read offset, reader owned */
+	uint32_t dropped;	/* records lost to a full ring */
+};
+
+struct diag_ring_rec {
+	uint32_t len;
+	uint32_t proc;		/* MODEM_DATA, QDSP_DATA, ... */
+};
+
+#define DIAG_RING_PAD			0xFFFFFFFF
+#define DIAG_RING_ALIGN			4
+
 /* PC Tools IDs */
 #define APQ8060_TOOLS_ID	4062
 #define AO8960_TOOLS_ID		4064
@@ -217,9 +217,15 @@ enum mmc_packed_stop_reasons {
 	EMPTY_QUEUE,
 	REL_WRITE,
 	THRESHOLD,
+	LATENCY_BOUND,
 	MAX_REASONS,
 };
 
+struct mmc_flush_stats {
+	u32 issued;		/* cache flushes sent to the card */
+	u32 coalesced;		/* flush requests served by an earlier flush */
+};
+
 struct mmc_wr_pack_stats {
 	u32 *packing_events;
 	u32 pack_stop_reason[MAX_REASONS];
@@ -308,6 +314,9 @@ struct mmc_card {
 	unsigned int    nr_parts;
 
 	struct mmc_wr_pack_stats wr_pack_stats; /* packed commands stats*/
+
+	bool			cache_clean;	/* no writes since last flush */
+	struct mmc_flush_stats	flush_stats;	/* cache flush stats */
 };
 
 /*
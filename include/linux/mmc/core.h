@@ -10,6 +10,7 @@
 
 #include <linux/interrupt.h>
 #include <linux/completion.h>
+#include <linux/ktime.h>
 
 struct request;
 struct mmc_data;
@@ -131,6 +132,9 @@ struct mmc_request {
 
 	struct completion	completion;
 	void			(*done)(struct mmc_request *);/* completion function */
+#ifdef CONFIG_MMC_LATENCY_HIST
+	ktime_t			io_start;	/* issued to the host driver */
+#endif
 };
 
 struct mmc_host;
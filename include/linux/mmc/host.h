@@ -341,6 +341,10 @@ struct mmc_host {
 	} embedded_sdio_data;
 #endif
 
+#ifdef CONFIG_MMC_LATENCY_HIST
+	struct mmc_lat_hist	*lat_hist;	/* request latency histograms */
+#endif
+
 #ifdef CONFIG_MMC_PERF_PROFILING
 	struct {
 
@@ -357,6 +361,39 @@ struct mmc_host {
 	unsigned long		private[0] ____cacheline_aligned;
 };
 
+#ifdef CONFIG_MMC_LATENCY_HIST
+#define MMC_LAT_HIST_OPCODES	64
+#define MMC_LAT_HIST_SIZES	4	/* no data, <= 4K, <= 64K, > 64K */
+#define MMC_LAT_HIST_BUCKETS	20	/* bucket i counts latencies < 2^i us */
+
+/*
+ * Issue to completion latency of requests, indexed by the opcode of the
+ * main command and the size of the data transfer.
+ */
+struct mmc_lat_hist {
+	u32	count[MMC_LAT_HIST_OPCODES][MMC_LAT_HIST_SIZES]
+		     [MMC_LAT_HIST_BUCKETS];
+	u32	dma;		/* data transfers done with DMA */
+	u32	pio;		/* data transfers done with PIO */
+};
+#endif
+
+/*
+ * Host drivers call this once per data transfer to report whether it is
+ * done by DMA or PIO.
+ */
+static inline void mmc_host_count_xfer(struct mmc_host *host, bool dma)
+{
+#ifdef CONFIG_MMC_LATENCY_HIST
+	if (!host->lat_hist)
+		return;
+	if (dma)
+		host->lat_hist->dma++;
+	else
+		host->lat_hist->pio++;
+#endif
+}
+
 extern struct mmc_host *mmc_alloc_host(int extra, struct device *);
 extern int mmc_add_host(struct mmc_host *);
 extern void mmc_remove_host(struct mmc_host *);
@@ -1,7 +1,7 @@
 /*
  *  lzodefs.h -- architecture, OS and compiler specific defines
  *
- *  Copyright (C) 1996-2005 Markus F.X.J. Oberhumer <markus@oberhumer.com>
+ *  Copyright (C) 1996-2012 Markus F.X.J. Oberhumer <markus@oberhumer.com>
  *
  *  The full LZO package can be found at:
  *  http://www.oberhumer.com/opensource/lzo/
@@ -11,9 +11,55 @@
  *  Richard Purdie <rpurdie@openedhand.com>
  */
 
-#define LZO_VERSION		0x2020
-#define LZO_VERSION_STRING	"2.02"
-#define LZO_VERSION_DATE	"Oct 17 2005"
+/*
+ * Literal runs and matches are moved a word at a time from and to
+ * arbitrary byte offsets.  ARMv6+ kernels run with alignment faults
+ * disabled, so a single ldr/str handles any address, but get_unaligned()
+ * on ARM always assembles the word from bytes; ldrd/ldm still require
+ * alignment, so the accesses are spelled out.  The pre-boot decompressor
+ * (STATIC) makes no assumption about the alignment setting.
+ */
+#if defined(CONFIG_ARM) && __LINUX_ARM_ARCH__ >= 6 && !defined(STATIC)
+static inline u32 lzo_load32(const void *p)
+{
+	u32 v;
+
+	asm("ldr	%0, %1" : "=r" (v) : "Qo" (*(const u32 *)p));
+	return v;
+}
+
+static inline void lzo_store32(void *p, u32 v)
+{
+	asm volatile("str	%1, %0" : "=Qo" (*(u32 *)p) : "r" (v));
+}
+#define LZO_UNALIGNED_OK	1
+#else
+#define lzo_load32(p)		get_unaligned((const u32 *)(p))
+#define lzo_store32(p, v)	put_unaligned((v), (u32 *)(p))
+#if defined(CONFIG_HAVE_EFFICIENT_UNALIGNED_ACCESS)
+#define LZO_UNALIGNED_OK	1
+#endif
+#endif
+
+#define COPY4(dst, src)	lzo_store32(dst, lzo_load32(src))
+#if defined(CONFIG_X86_64)
+#define COPY8(dst, src)	\
+		put_unaligned(get_unaligned((const u64 *)(src)), (u64 *)(dst))
+#else
+#define COPY8(dst, src)	\
+		do { COPY4(dst, src); COPY4((dst) + 4, (src) + 4); } while (0)
+#endif
+
+#if defined(__BIG_ENDIAN) && defined(__LITTLE_ENDIAN)
+#error "conflicting endian definitions"
+#elif defined(CONFIG_X86_64)
+#define LZO_USE_CTZ64	1
+#define LZO_USE_CTZ32	1
+#elif defined(CONFIG_X86) || defined(CONFIG_PPC)
+#define LZO_USE_CTZ32	1
+#elif defined(CONFIG_ARM) && (__LINUX_ARM_ARCH__ >= 5)
+#define LZO_USE_CTZ32	1
+#endif
 
 #define M1_MAX_OFFSET	0x0400
 #define M2_MAX_OFFSET	0x0800
@@ -34,10 +80,8 @@
 #define M3_MARKER	32
 #define M4_MARKER	16
 
-#define D_BITS		14
-#define D_MASK		((1u << D_BITS) - 1)
+#define lzo_dict_t	unsigned short
+#define D_BITS		13
+#define D_SIZE		(1u << D_BITS)
+#define D_MASK		(D_SIZE - 1)
 #define D_HIGH		((D_MASK >> 1) + 1)
-
-#define DX2(p, s1, s2)	(((((size_t)((p)[2]) << (s2)) ^ (p)[1]) \
-							<< (s1)) ^ (p)[0])
-#define DX3(p, s1, s2, s3)	((DX2((p)+1, s2, s3) << (s1)) ^ (p)[0])
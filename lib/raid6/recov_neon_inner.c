@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2012, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <arm_neon.h>
+
+/*
+ * Multiply 16 bytes by a constant: each 32 byte raid6_vgfmul row holds
+ * the products of the constant with every low nibble, then with every
+ * high nibble, so two table lookups and an XOR do the whole byte.
+ * ARMv7 has no 16-entry vtbl on Q registers; look up the two halves
+ * with vtbl2 instead.
+ */
+static inline uint8x16_t vqtbl1q_emul(uint8x8x2_t tbl, uint8x16_t idx)
+{
+	return vcombine_u8(vtbl2_u8(tbl, vget_low_u8(idx)),
+			   vtbl2_u8(tbl, vget_high_u8(idx)));
+}
+
+static inline uint8x16_t raid6_vgfmul16(uint8x8x2_t lo, uint8x8x2_t hi,
+					uint8x16_t v, uint8x16_t x0f)
+{
+	uint8x16_t l = vqtbl1q_emul(lo, vandq_u8(v, x0f));
+	uint8x16_t h = vqtbl1q_emul(hi, vshrq_n_u8(v, 4));
+
+	return veorq_u8(l, h);
+}
+
+static inline uint8x8x2_t raid6_vgfmul_load(const uint8_t *tbl)
+{
+	uint8x8x2_t t;
+
+	t.val[0] = vld1_u8(tbl);
+	t.val[1] = vld1_u8(tbl + 8);
+	return t;
+}
+
+void __raid6_2data_recov_neon(int bytes, uint8_t *p, uint8_t *q, uint8_t *dp,
+			      uint8_t *dq, const uint8_t *pbmul,
+			      const uint8_t *qmul)
+{
+	uint8x8x2_t qm0 = raid6_vgfmul_load(qmul);
+	uint8x8x2_t qm1 = raid6_vgfmul_load(qmul + 16);
+	uint8x8x2_t pm0 = raid6_vgfmul_load(pbmul);
+	uint8x8x2_t pm1 = raid6_vgfmul_load(pbmul + 16);
+	uint8x16_t x0f = vdupq_n_u8(0x0f);
+
+	/*
+	 * while ( bytes-- ) {
+	 *	uint8_t px, qx, db;
+	 *
+	 *	px    = *p ^ *dp;
+	 *	qx    = qmul[*q ^ *dq];
+	 *	*dq++ = db = pbmul[px] ^ qx;
+	 *	*dp++ = db ^ px;
+	 *	p++; q++;
+	 * }
+	 */
+
+	while (bytes) {
+		uint8x16_t px, qx, db;
+
+		px = veorq_u8(vld1q_u8(p), vld1q_u8(dp));
+		qx = veorq_u8(vld1q_u8(q), vld1q_u8(dq));
+
+		qx = raid6_vgfmul16(qm0, qm1, qx, x0f);
+		db = veorq_u8(raid6_vgfmul16(pm0, pm1, px, x0f), qx);
+
+		vst1q_u8(dq, db);
+		vst1q_u8(dp, veorq_u8(db, px));
+
+		bytes -= 16;
+		p += 16;
+		q += 16;
+		dp += 16;
+		dq += 16;
+	}
+}
+
+void __raid6_datap_recov_neon(int bytes, uint8_t *p, uint8_t *q, uint8_t *dq,
+			      const uint8_t *qmul)
+{
+	uint8x8x2_t qm0 = raid6_vgfmul_load(qmul);
+	uint8x8x2_t qm1 = raid6_vgfmul_load(qmul + 16);
+	uint8x16_t x0f = vdupq_n_u8(0x0f);
+
+	/*
+	 * while (bytes--) {
+	 *	*p++ ^= *dq = qmul[*q ^ *dq];
+	 *	q++; dq++;
+	 * }
+	 */
+
+	while (bytes) {
+		uint8x16_t vx;
+
+		vx = veorq_u8(vld1q_u8(q), vld1q_u8(dq));
+		vx = raid6_vgfmul16(qm0, qm1, vx, x0f);
+
+		vst1q_u8(dq, vx);
+		vst1q_u8(p, veorq_u8(vx, vld1q_u8(p)));
+
+		bytes -= 16;
+		p += 16;
+		q += 16;
+		dq += 16;
+	}
+}
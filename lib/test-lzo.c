@@ -0,0 +1,283 @@
+/*
+ * Self-test and benchmark for the LZO1X-1 compressor and the safe
+ * decompressor.
+ *
+ * Every sample is compressed and decompressed and compared against the
+ * original, at sizes around the compressor's internal block boundaries.
+ * The decompressor is then fed corrupted and truncated streams: input
+ * and output buffers sit at the very end of their vmalloc areas, so a
+ * read past the input or a write past the output hits the guard page.
+ * Finally compression and decompression of 4 KiB pages, the unit zram
+ * works in, are timed.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/lzo.h>
+#include <linux/random.h>
+#include <linux/vmalloc.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/sched.h>
+
+static unsigned int fuzz_iterations = 10000;
+module_param(fuzz_iterations, uint, 0);
+MODULE_PARM_DESC(fuzz_iterations, "Corrupted streams to decompress");
+
+static unsigned int bench_iterations = 2000;
+module_param(bench_iterations, uint, 0);
+MODULE_PARM_DESC(bench_iterations, "Pages to compress and decompress "
+				   "per benchmark run");
+
+#define TEST_LZO_MAX_LEN	(128 * 1024 + 77)
+#define TEST_LZO_BENCH_PAGES	16
+#define TEST_LZO_CMP_PAGE	lzo1x_worst_compress(PAGE_SIZE)
+
+enum test_lzo_kind {
+	TEST_LZO_ZERO,
+	TEST_LZO_RANDOM,
+	TEST_LZO_TEXT,
+	TEST_LZO_MIXED,
+	TEST_LZO_LOW_ENTROPY,
+	TEST_LZO_KINDS,
+};
+
+static const char * const test_lzo_kind_name[] = {
+	"zero", "random", "text", "mixed", "low-entropy",
+};
+
+static const size_t test_lzo_sizes[] = {
+	0, 1, 2, 3, 4, 5, 16, 19, 20, 21, 22, 40, 255, 256, 1000, 4095,
+	4096, 12345, 49151, 49152, 49153, 65536, TEST_LZO_MAX_LEN,
+};
+
+static unsigned char *src, *cmp, *dst, *wrkmem;
+
+static void __init test_lzo_fill(unsigned char *buf, size_t len,
+				 enum test_lzo_kind kind)
+{
+	static const char text[] =
+		"the quick brown fox jumps over the lazy dog ";
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		switch (kind) {
+		case TEST_LZO_ZERO:
+			buf[i] = 0;
+			break;
+		case TEST_LZO_RANDOM:
+			buf[i] = prandom_u32();
+			break;
+		case TEST_LZO_TEXT:
+			buf[i] = text[(i * 7 / 5 + !prandom_u32_max(50)) %
+				      (sizeof(text) - 1)];
+			break;
+		case TEST_LZO_MIXED:
+			buf[i] = (i / 300) & 1 ? prandom_u32() : i % 13;
+			break;
+		default:
+			buf[i] = prandom_u32_max(4);
+			break;
+		}
+	}
+}
+
+static int __init test_lzo_roundtrip(size_t len, enum test_lzo_kind kind)
+{
+	size_t cmp_len = lzo1x_worst_compress(len);
+	size_t dst_len = len;
+	int ret;
+
+	test_lzo_fill(src, len, kind);
+
+	ret = lzo1x_1_compress(src, len, cmp, &cmp_len, wrkmem);
+	if (ret != LZO_E_OK || cmp_len > lzo1x_worst_compress(len)) {
+		pr_err("test_lzo: compress %s %zu: %d, %zu bytes\n",
+		       test_lzo_kind_name[kind], len, ret, cmp_len);
+		return -EINVAL;
+	}
+
+	ret = lzo1x_decompress_safe(cmp, cmp_len, dst, &dst_len);
+	if (ret != LZO_E_OK || dst_len != len || memcmp(src, dst, len)) {
+		pr_err("test_lzo: decompress %s %zu: %d, %zu bytes\n",
+		       test_lzo_kind_name[kind], len, ret, dst_len);
+		return -EINVAL;
+	}
+
+	/* one byte short of room must be reported, not overrun */
+	if (len) {
+		dst_len = len - 1;
+		ret = lzo1x_decompress_safe(cmp, cmp_len, dst, &dst_len);
+		if (ret != LZO_E_OUTPUT_OVERRUN) {
+			pr_err("test_lzo: short output %s %zu: %d\n",
+			       test_lzo_kind_name[kind], len, ret);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Decompress a corrupted copy of a valid stream.  Any return code is
+ * acceptable, as long as the output length stays within bounds and
+ * nothing outside the two buffers is touched.
+ */
+static int __init test_lzo_fuzz_one(unsigned char *in_area, size_t in_area_len,
+				    unsigned char *out_area,
+				    size_t out_area_len)
+{
+	size_t len = 1 + prandom_u32_max(out_area_len);
+	size_t cmp_len = lzo1x_worst_compress(len);
+	size_t in_len, out_len = len;
+	unsigned char *in, *out;
+	int flips, ret;
+
+	test_lzo_fill(src, len, prandom_u32_max(TEST_LZO_KINDS));
+	ret = lzo1x_1_compress(src, len, cmp, &cmp_len, wrkmem);
+	if (ret != LZO_E_OK)
+		return -EINVAL;
+
+	for (flips = 1 + prandom_u32_max(4); flips; flips--)
+		cmp[prandom_u32_max(cmp_len)] ^= 1 << prandom_u32_max(8);
+
+	in_len = cmp_len;
+	if (!prandom_u32_max(3))
+		in_len -= prandom_u32_max(cmp_len);
+	in_len = min(in_len, in_area_len);
+
+	in = in_area + in_area_len - in_len;
+	out = out_area + out_area_len - out_len;
+	memcpy(in, cmp, in_len);
+
+	lzo1x_decompress_safe(in, in_len, out, &out_len);
+	if (out_len > len) {
+		pr_err("test_lzo: fuzz output length %zu > %zu\n",
+		       out_len, len);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int __init test_lzo_fuzz(void)
+{
+	size_t area_len = PAGE_ALIGN(lzo1x_worst_compress(8192));
+	unsigned char *in_area, *out_area;
+	unsigned int i;
+	int ret = 0;
+
+	in_area = vmalloc(area_len);
+	out_area = vmalloc(8192);
+	if (!in_area || !out_area) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (i = 0; i < fuzz_iterations && !ret; i++) {
+		ret = test_lzo_fuzz_one(in_area, area_len, out_area, 8192);
+		cond_resched();
+	}
+
+out:
+	vfree(in_area);
+	vfree(out_area);
+	return ret;
+}
+
+static void __init test_lzo_bench(enum test_lzo_kind kind)
+{
+	size_t cmp_len[TEST_LZO_BENCH_PAGES];
+	size_t total = 0, dst_len;
+	s64 comp_ns, decomp_ns;
+	ktime_t start;
+	unsigned int i, p;
+
+	test_lzo_fill(src, TEST_LZO_BENCH_PAGES * PAGE_SIZE, kind);
+
+	start = ktime_get();
+	for (i = 0; i < bench_iterations; i++) {
+		p = i % TEST_LZO_BENCH_PAGES;
+		cmp_len[p] = TEST_LZO_CMP_PAGE;
+		lzo1x_1_compress(src + p * PAGE_SIZE, PAGE_SIZE,
+				 cmp + p * TEST_LZO_CMP_PAGE, &cmp_len[p],
+				 wrkmem);
+	}
+	comp_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	start = ktime_get();
+	for (i = 0; i < bench_iterations; i++) {
+		p = i % TEST_LZO_BENCH_PAGES;
+		dst_len = PAGE_SIZE;
+		lzo1x_decompress_safe(cmp + p * TEST_LZO_CMP_PAGE, cmp_len[p],
+				      dst, &dst_len);
+	}
+	decomp_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	for (p = 0; p < TEST_LZO_BENCH_PAGES && p < bench_iterations; p++)
+		total += cmp_len[p];
+
+	comp_ns = max_t(s64, comp_ns, 1);
+	decomp_ns = max_t(s64, decomp_ns, 1);
+	pr_info("test_lzo: %-11s 4K pages: ratio %llu%%, compress %llu KB/s, "
+		"decompress %llu KB/s\n", test_lzo_kind_name[kind],
+		div_u64((u64)total * 100,
+			min_t(unsigned int, bench_iterations,
+			      TEST_LZO_BENCH_PAGES) * PAGE_SIZE),
+		div64_u64((u64)bench_iterations * PAGE_SIZE * 1000000ULL,
+			  comp_ns),
+		div64_u64((u64)bench_iterations * PAGE_SIZE * 1000000ULL,
+			  decomp_ns));
+}
+
+static int __init test_lzo_init(void)
+{
+	enum test_lzo_kind kind;
+	unsigned int i;
+	int ret = -ENOMEM;
+
+	src = vmalloc(TEST_LZO_MAX_LEN);
+	cmp = vmalloc(lzo1x_worst_compress(TEST_LZO_MAX_LEN));
+	dst = vmalloc(TEST_LZO_MAX_LEN);
+	wrkmem = vmalloc(LZO1X_1_MEM_COMPRESS);
+	if (!src || !cmp || !dst || !wrkmem)
+		goto out;
+
+	ret = 0;
+	for (kind = 0; kind < TEST_LZO_KINDS && !ret; kind++)
+		for (i = 0; i < ARRAY_SIZE(test_lzo_sizes) && !ret; i++)
+			ret = test_lzo_roundtrip(test_lzo_sizes[i], kind);
+	if (ret)
+		goto out;
+
+	ret = test_lzo_fuzz();
+	if (ret)
+		goto out;
+
+	if (bench_iterations)
+		for (kind = 0; kind < TEST_LZO_KINDS; kind++)
+			test_lzo_bench(kind);
+
+	pr_info("test_lzo: all tests passed\n");
+
+out:
+	vfree(src);
+	vfree(cmp);
+	vfree(dst);
+	vfree(wrkmem);
+	return ret;
+}
+
+static void __exit test_lzo_exit(void)
+{
+}
+
+module_init(test_lzo_init);
+module_exit(test_lzo_exit);
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("LZO1X self-test and benchmark");